@@ -247,6 +247,25 @@ class TestGateFunctions(test.TestCase):
         self.assertEqual(f.getParameter(1), "psi")
         self.assertEqual(f.toString("qreg"), newQasm4)
 
+    def test_GateFunctionBatchEvaluation(self):
+        import numpy as np
+        f = xacc.gate.createFunction("foo", [])
+
+        rz = xacc.gate.create("Rz", [1])
+        ry = xacc.gate.create("Ry", [2])
+        rz.setParameter(0, "theta")
+        ry.setParameter(0, "0.5 * psi")
+        f.addInstruction(xacc.gate.create("H", [1]))
+        f.addInstruction(rz)
+        f.addInstruction(ry)
+
+        sweep = np.array([[3.14, 1.4], [1.0, 2.0]])
+        evals = f.evalBatch(sweep)
+        self.assertEqual(len(evals), 2)
+        self.assertEqual(evals[0].toString("qreg"), "H qreg1\nRz(3.14) qreg1\nRy(0.7) qreg2\n")
+        for e, row in zip(evals, sweep):
+            self.assertEqual(e.toString("qreg"), f.eval(list(row)).toString("qreg"))
+
 
     def test_CoefficientParameters(self):
         # Testing GateInstructions with duplicate parameters and coefficients
@@ -159,6 +159,24 @@ PYBIND11_MODULE(_pyxacc, m) {
       .def("addParameter", &xacc::Function::addParameter, "")
       .def("nParameters", &xacc::Function::nParameters, "")
       .def("eval", &xacc::Function::operator(), "")
+      .def("evalBatch",
+           [](xacc::Function &f,
+              py::array_t<double, py::array::c_style | py::array::forcecast>
+                  paramSets) {
+             if (paramSets.ndim() != 2) {
+               xacc::error("Function.evalBatch requires a 2-D array of "
+                           "parameter sets, one set per row.");
+             }
+             auto rows = paramSets.unchecked<2>();
+             std::vector<std::vector<double>> sets(rows.shape(0));
+             for (py::ssize_t i = 0; i < rows.shape(0); i++) {
+               sets[i].assign(rows.data(i, 0),
+                              rows.data(i, 0) + rows.shape(1));
+             }
+             return f.evaluateBatch(sets);
+           },
+           "Evaluate this Function at each row of the given 2-D array of "
+           "parameter sets.")
       .def("name", &xacc::Function::name, "")
       .def("description", &xacc::Function::description, "")
       .def("nParameters", &xacc::Function::nParameters, "")
@@ -170,6 +188,7 @@ PYBIND11_MODULE(_pyxacc, m) {
                xacc::Function::toString,
            "")
       .def("enabledView", &xacc::Function::enabledView, "")
+      .def("removeDisabled", &xacc::Function::removeDisabled, "")
       .def("enable", &xacc::Function::enable, "")
       .def("getParameter", &xacc::Function::getParameter, "")
       .def("getParameters", &xacc::Function::getParameters, "")
@@ -268,6 +287,13 @@ PYBIND11_MODULE(_pyxacc, m) {
       .def("getExpectationValueZ",
            &xacc::AcceleratorBuffer::getExpectationValueZ,
            "Return the expectation value with respect to the Z operator.")
+      .def("setExpectationValueZ",
+           &xacc::AcceleratorBuffer::setExpectationValueZ,
+           "Set the exact expectation value with respect to the Z operator.")
+      .def("hasExactExpectationValueZ",
+           &xacc::AcceleratorBuffer::hasExactExpectationValueZ,
+           "Return true if the expectation value with respect to the Z "
+           "operator is exact.")
       .def("resetBuffer", &xacc::AcceleratorBuffer::resetBuffer,
            "Reset this buffer for use in another computation.")
       .def("size", &xacc::AcceleratorBuffer::size, "")
@@ -275,6 +301,9 @@ PYBIND11_MODULE(_pyxacc, m) {
            (void (xacc::AcceleratorBuffer::*)(const std::string &)) &
                xacc::AcceleratorBuffer::appendMeasurement,
            "Append the measurement string")
+      .def("appendMeasurements",
+           &xacc::AcceleratorBuffer::appendMeasurements,
+           "Add the given bit string counts to the measurements")
       .def("getMeasurements",
            &xacc::AcceleratorBuffer::getMeasurements,
            "Return observed measurement bit strings")
@@ -15,8 +15,7 @@ namespace quantum {
 
 std::shared_ptr<Graph> DWFunction::toGraph() {
   int maxBit = 0;
-  for (int i = 0; i < nInstructions(); ++i) {
-    auto inst = getInstruction(i);
+  for (auto &inst : instructions) {
     auto bits = inst->bits();
     if (bits[0] > maxBit) {
       maxBit = bits[0];
@@ -32,8 +31,7 @@ std::shared_ptr<Graph> DWFunction::toGraph() {
     graph->addVertex(props); //
   }
 
-  for (int i = 0; i < nInstructions(); ++i) {
-    auto inst = getInstruction(i);
+  for (auto &inst : instructions) {
     auto bits = inst->bits();
     if (bits[0] == bits[1]) {
       auto p = inst->getParameter(0);
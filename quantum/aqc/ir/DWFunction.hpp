@@ -17,6 +17,7 @@
 #include "DWQMI.hpp"
 #include "XACC.hpp"
 #include "exprtk.hpp"
+#include <algorithm>
 
 static constexpr double pi = 3.141592653589793238;
 
@@ -31,7 +32,11 @@ class DWFunction : public Function,
                    public std::enable_shared_from_this<DWFunction> {
 
 protected:
-  std::list<InstPtr> instructions;
+  /**
+   * The Instructions of this function, stored contiguously
+   * for constant time index-based access.
+   */
+  std::vector<InstPtr> instructions;
 
   std::vector<InstructionParameter> parameters;
 
@@ -51,10 +56,15 @@ public:
   DWFunction(std::string kernelName, std::vector<InstructionParameter> p)
       : _name(kernelName), parameters(p) {}
 
+  virtual ~DWFunction() {
+    for (auto &inst : instructions) {
+      inst->detach(this);
+    }
+  }
+
   std::shared_ptr<Function> enabledView() override {
     auto newF = std::make_shared<DWFunction>(_name, parameters);
-    for (int i = 0; i < nInstructions(); i++) {
-      auto inst = getInstruction(i);
+    for (auto &inst : instructions) {
       if (inst->isEnabled()) {
         newF->addInstruction(inst);
       }
@@ -66,8 +76,8 @@ public:
 
   InstPtr getInstruction(const int idx) override {
     InstPtr i;
-    if (instructions.size() > idx) {
-      i = *std::next(instructions.begin(), idx);
+    if (idx >= 0 && instructions.size() > idx) {
+      i = instructions[idx];
     } else {
       xacc::error("DWFunction getInstruction invalid instruction index - " +
                   std::to_string(idx) + ".");
@@ -78,10 +88,26 @@ public:
   void setBitMap(const std::vector<int> bMap) override {}
   const std::vector<int> getBitMap() override {return std::vector<int>{};}
 
-  std::list<InstPtr> getInstructions() override { return instructions; }
+  std::vector<InstPtr> getInstructions() override { return instructions; }
+  const InstPtr *instructionData() override { return instructions.data(); }
 
   void removeInstruction(const int idx) override {
-    instructions.remove(getInstruction(idx));
+    modified();
+    instructions[idx]->detach(this);
+    instructions.erase(instructions.begin() + idx);
+  }
+
+  void removeDisabled() override {
+    modified();
+    instructions.erase(std::remove_if(instructions.begin(), instructions.end(),
+                                      [this](const InstPtr &inst) {
+                                        if (inst->isEnabled()) {
+                                          return false;
+                                        }
+                                        inst->detach(this);
+                                        return true;
+                                      }),
+                       instructions.end());
   }
 
   void mapBits(std::vector<int> bitMap) override {
@@ -100,6 +126,8 @@ public:
    * @param instruction
    */
   void addInstruction(InstPtr instruction) override {
+    auto hashCurrent = hashValid;
+    modified();
     xacc::InstructionParameter param = instruction->getParameter(0);
     bool dupParam = false;
     for (auto p : parameters) {
@@ -110,7 +138,11 @@ public:
     if (!dupParam) {
       parameters.push_back(param);
     }
+    instruction->attach(this);
     instructions.push_back(instruction);
+    if (hashCurrent) {
+      appendToHash(instruction);
+    }
   }
 
   const int depth() override {
@@ -127,13 +159,16 @@ public:
   std::shared_ptr<Graph> toGraph() override;
 
   void replaceInstruction(const int idx, InstPtr replacingInst) override {
-    std::replace(instructions.begin(), instructions.end(), getInstruction(idx),
-                 replacingInst);
+    modified();
+    replacingInst->attach(this);
+    instructions[idx]->detach(this);
+    instructions[idx] = replacingInst;
   }
 
   void insertInstruction(const int idx, InstPtr newInst) override {
-    auto iter = std::next(instructions.begin(), idx);
-    instructions.insert(iter, newInst);
+    modified();
+    newInst->attach(this);
+    instructions.insert(instructions.begin() + idx, newInst);
   }
 
   /**
@@ -205,6 +240,7 @@ public:
     }
 
     parameters[idx] = p;
+    modified();
   }
 
   std::vector<InstructionParameter> getParameters() override {
@@ -212,6 +248,7 @@ public:
   }
 
   void addParameter(InstructionParameter instParam) override {
+    modified();
     parameters.push_back(instParam);
   }
 
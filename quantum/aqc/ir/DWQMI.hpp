@@ -157,6 +157,7 @@ public:
    */
   void setParameter(const int idx, InstructionParameter &inst) override {
     parameter = inst;
+    notifyParents();
   }
 
   /**
@@ -192,12 +193,18 @@ public:
    * Disable this Instruction
    */
 
-  void disable() override { enabled = false; }
+  void disable() override {
+    enabled = false;
+    notifyParents();
+  }
 
   /**
    * Enable this Instruction.
    */
-  void enable() override { enabled = true; }
+  void enable() override {
+    enabled = true;
+    notifyParents();
+  }
 
   /**
    * Return true if this Instruction has
@@ -360,6 +367,7 @@ public:
    */
   void setParameter(const int idx, InstructionParameter &inst) override {
     times.at(idx) = inst;
+    notifyParents();
   }
 
   /**
@@ -394,12 +402,18 @@ public:
    * Disable this Instruction
    */
 
-  void disable() override { enabled = false; }
+  void disable() override {
+    enabled = false;
+    notifyParents();
+  }
 
   /**
    * Enable this Instruction.
    */
-  void enable() override { enabled = true; }
+  void enable() override {
+    enabled = true;
+    notifyParents();
+  }
 
  /**
    * Return true if this Instruction has
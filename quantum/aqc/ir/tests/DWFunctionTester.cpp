@@ -86,6 +86,27 @@ TEST(DWFunctionTester, checkVariableParameterEval) {
 
   std::cout << evaled->toString("") << std::endl;
 }
+TEST(DWFunctionTester, checkHash) {
+  DWFunction kernel("foo"), other("bar");
+  kernel.addInstruction(std::make_shared<DWQMI>(0, 1, 2.2));
+  other.addInstruction(std::make_shared<DWQMI>(0, 1, 2.2));
+  EXPECT_EQ(kernel.hash(), other.hash());
+
+  auto qmi = std::make_shared<DWQMI>(1, 3.3);
+  kernel.addInstruction(qmi);
+  EXPECT_NE(kernel.hash(), other.hash());
+  other.addInstruction(std::make_shared<DWQMI>(1, 3.3));
+  EXPECT_EQ(kernel.hash(), other.hash());
+
+  xacc::InstructionParameter bias(1.1);
+  qmi->setParameter(0, bias);
+  EXPECT_NE(kernel.hash(), other.hash());
+  qmi->disable();
+  other.getInstruction(1)->disable();
+  other.getInstruction(1)->setParameter(0, bias);
+  EXPECT_EQ(kernel.hash(), other.hash());
+}
+
 int main(int argc, char **argv) {
     xacc::Initialize(argc,argv);
   ::testing::InitGoogleTest(&argc, argv);
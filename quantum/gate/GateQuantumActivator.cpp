@@ -20,10 +20,18 @@
 #include "DigitalGates.hpp"
 
 #include "CircuitOptimizer.hpp"
+#include "SingleQubitFusion.hpp"
+#include "QubitRouter.hpp"
+#include "CachingCompiler.hpp"
+#include "CircuitDAG.hpp"
 
 #include "ROErrorDecorator.hpp"
 #include "ImprovedSamplingDecorator.hpp"
 #include "RichExtrapDecorator.hpp"
+#include "StateVectorAccelerator.hpp"
+#include "StabilizerAccelerator.hpp"
+#include "TrajectoryAccelerator.hpp"
+#include "MPSAccelerator.hpp"
 
 #include <memory>
 #include <set>
@@ -48,17 +56,36 @@ public:
     auto giservice = std::make_shared<xacc::quantum::GateIRProvider>();
 
     auto opt = std::make_shared<xacc::quantum::CircuitOptimizer>();
+    auto fusion = std::make_shared<xacc::quantum::SingleQubitFusion>();
+    auto router = std::make_shared<xacc::quantum::QubitRouter>();
 
     auto roed = std::make_shared<xacc::quantum::ROErrorDecorator>();
     auto impsamplingd = std::make_shared<xacc::quantum::ImprovedSamplingDecorator>();
     auto richextrap = std::make_shared<xacc::quantum::RichExtrapDecorator>();
+    auto statevector =
+        std::make_shared<xacc::quantum::StateVectorAccelerator>();
+    auto stabilizer =
+        std::make_shared<xacc::quantum::StabilizerAccelerator>();
+    auto trajectory =
+        std::make_shared<xacc::quantum::TrajectoryAccelerator>();
+    auto mps = std::make_shared<xacc::quantum::MPSAccelerator>();
 
     context.RegisterService<xacc::IRProvider>(giservice);
     context.RegisterService<xacc::IRGenerator>(iqft);
     context.RegisterService<xacc::IRGenerator>(qft);
 
+    auto dag = std::make_shared<xacc::quantum::CircuitDAG>();
+    context.RegisterService<xacc::Graph>(dag);
+
     context.RegisterService<xacc::IRTransformation>(opt);
     context.RegisterService<xacc::OptionsProvider>(opt);
+    context.RegisterService<xacc::IRTransformation>(fusion);
+    context.RegisterService<xacc::IRTransformation>(router);
+    context.RegisterService<xacc::OptionsProvider>(router);
+
+    auto caching = std::make_shared<xacc::quantum::CachingCompiler>();
+    context.RegisterService<xacc::CompilerDecorator>(caching);
+    context.RegisterService<xacc::OptionsProvider>(caching);
 
     context.RegisterService<xacc::AcceleratorDecorator>(roed);
     context.RegisterService<xacc::Accelerator>(roed);
@@ -69,6 +96,18 @@ public:
     context.RegisterService<xacc::AcceleratorDecorator>(impsamplingd);
     context.RegisterService<xacc::Accelerator>(impsamplingd);
 
+    context.RegisterService<xacc::Accelerator>(statevector);
+    context.RegisterService<xacc::OptionsProvider>(statevector);
+
+    context.RegisterService<xacc::Accelerator>(stabilizer);
+    context.RegisterService<xacc::OptionsProvider>(stabilizer);
+
+    context.RegisterService<xacc::Accelerator>(trajectory);
+    context.RegisterService<xacc::OptionsProvider>(trajectory);
+
+    context.RegisterService<xacc::Accelerator>(mps);
+    context.RegisterService<xacc::OptionsProvider>(mps);
+
     auto h = std::make_shared<xacc::quantum::Hadamard>();
     auto cn = std::make_shared<xacc::quantum::CNOT>();
     auto cp = std::make_shared<xacc::quantum::CPhase>();
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_CIRCUITSCAN_HPP_
+#define QUANTUM_GATE_ACCELERATOR_CIRCUITSCAN_HPP_
+
+#include "ConditionalFunction.hpp"
+#include <functional>
+#include <set>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The CircuitScan collects what the local simulators need to know about
+ * a Function before running it: the qubits and classical bits it uses,
+ * and whether all of its measurements can be deferred to the end, in
+ * which case shots can be sampled from a single simulation.
+ */
+class CircuitScan {
+
+protected:
+  void scan(std::shared_ptr<Function> function) {
+    for (auto &inst : function->getInstructions()) {
+      if (inst->isComposite()) {
+        if (std::dynamic_pointer_cast<ConditionalFunction>(inst)) {
+          terminal = false;
+        }
+        scan(std::dynamic_pointer_cast<Function>(inst));
+        continue;
+      }
+
+      auto bits = inst->bits();
+      for (auto b : bits) {
+        maxQubit = std::max(maxQubit, b);
+      }
+      if (inst->name() == "Measure") {
+        measured.insert(bits[0]);
+        maxBit = std::max(maxBit, inst->getParameter(0).as<int>());
+      } else if (inst->isEnabled()) {
+        for (auto b : bits) {
+          if (measured.count(b)) {
+            terminal = false;
+          }
+        }
+      }
+    }
+  }
+
+public:
+  /**
+   * The largest qubit index used.
+   */
+  int maxQubit = 0;
+
+  /**
+   * The largest classical bit index measured into, -1 if none.
+   */
+  int maxBit = -1;
+
+  /**
+   * True if there are no ConditionalFunctions and no gate
+   * acts on a qubit after it has been measured.
+   */
+  bool terminal = true;
+
+  /**
+   * The measured qubits.
+   */
+  std::set<int> measured;
+
+  /**
+   * The constructor, scans the given Function.
+   *
+   * @param function The Function to scan
+   */
+  CircuitScan(std::shared_ptr<Function> function) { scan(function); }
+
+  /**
+   * Return the number of qubits to simulate.
+   */
+  const int nQubits() const { return maxQubit + 1; }
+
+  /**
+   * Return the bit string of the given classical bits, classical
+   * bit 0 rightmost, at least as wide as the given width.
+   *
+   * @param width The minimum width, usually the buffer size
+   * @param bit Return the value of the given classical bit
+   * @return bitString The bit string
+   */
+  std::string bitString(const int width,
+                        const std::function<int(const int)> &bit) const {
+    const int n = std::max(width, maxBit + 1);
+    std::string bits(n, '0');
+    for (int i = 0; i <= maxBit; i++) {
+      if (bit(i)) {
+        bits[n - 1 - i] = '1';
+      }
+    }
+    return bits;
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_FUSEDSTATEVECTORVISITOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_FUSEDSTATEVECTORVISITOR_HPP_
+
+#include "GateBlock.hpp"
+#include "StateVectorVisitor.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The FusedStateVectorVisitor applies gates to a StateVector like the
+ * StateVectorVisitor, but first fuses runs of consecutive gates into
+ * GateBlocks of at most k qubits, each applied in one pass over the
+ * amplitudes instead of one pass per gate.
+ *
+ * Fusion is greedy in Instruction order: a gate joins the current
+ * block if the block then still acts on at most k qubits, otherwise
+ * the block is applied and a new one started with the gate. Blocks are
+ * also applied before collapsing measurements and when the outermost
+ * Function has been visited. A block of a single gate is applied with
+ * the gate's own kernel.
+ */
+class FusedStateVectorVisitor : public StateVectorVisitor {
+
+protected:
+  GateBlock block;
+  BasicStateVectorVisitor<GateBlock> blockVisitor;
+  InstPtr firstGate;
+  int nGates = 0;
+  int depth = 0;
+
+  void flush() {
+    if (nGates == 1) {
+      firstGate->accept(this);
+      sweeps++;
+    } else if (nGates > 1) {
+      state.applyMatrix(block.qubits(), block.unitary());
+      sweeps++;
+    }
+    block.clear();
+    firstGate = nullptr;
+    nGates = 0;
+  }
+
+  void fuse(InstPtr inst) {
+    if (inst->name() == "Measure") {
+      if (collapse) {
+        flush();
+      }
+      inst->accept(this);
+      return;
+    }
+    if (!block.fits(inst->bits())) {
+      flush();
+    }
+    inst->accept(&blockVisitor);
+    if (nGates++ == 0) {
+      firstGate = inst;
+    }
+  }
+
+  void visitAll(Function &f, const bool enabledOnly) {
+    depth++;
+    for (auto &inst : f.getInstructions()) {
+      if (inst->isComposite()) {
+        inst->accept(this);
+      } else if (!enabledOnly || inst->isEnabled()) {
+        fuse(inst);
+      }
+    }
+    if (--depth == 0) {
+      flush();
+    }
+  }
+
+public:
+  /**
+   * The number of passes over the amplitudes made to apply gates,
+   * one per block.
+   */
+  int sweeps = 0;
+
+  /**
+   * The constructor.
+   *
+   * @param s The state to apply gates to
+   * @param r The source of uniform random numbers in [0,1)
+   * @param k The most qubits a block may act on
+   * @param collapseOnMeasure If false, Measures are only recorded
+   */
+  FusedStateVectorVisitor(StateVector &s, std::function<double()> r,
+                          const int k, const bool collapseOnMeasure = true)
+      : StateVectorVisitor(s, r, collapseOnMeasure), block(k),
+        blockVisitor(block, r) {}
+
+  using StateVectorVisitor::visit;
+
+  void visit(GateFunction &f) override { visitAll(f, true); }
+
+  void visit(ConditionalFunction &c) override {
+    // Classical bits only change at measurements, which
+    // have applied the pending block already
+    auto bit = classicalBits.find(c.getConditionalQubit());
+    if (bit == classicalBits.end() || bit->second != 1) {
+      return;
+    }
+    visitAll(c, false);
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "GateBlock.hpp"
+#include "XACC.hpp"
+#include <algorithm>
+
+namespace xacc {
+namespace quantum {
+
+GateBlock::GateBlock(const int k) : maxQubits(k) {
+  if (maxQubits < 1 || maxQubits > StateVector::maxMatrixQubits) {
+    xacc::error("Invalid GateBlock size " + std::to_string(maxQubits) +
+                ", it must be between 1 and " +
+                std::to_string(StateVector::maxMatrixQubits) + ".");
+  }
+  clear();
+}
+
+void GateBlock::clear() {
+  dim = 1;
+  blockQubits.clear();
+  matrix.assign(1, 1.0);
+}
+
+bool GateBlock::fits(const std::vector<int> &bits) const {
+  int n = blockQubits.size();
+  for (auto b : bits) {
+    if (std::find(blockQubits.begin(), blockQubits.end(), b) ==
+        blockQubits.end()) {
+      n++;
+    }
+  }
+  return n <= maxQubits;
+}
+
+int GateBlock::local(const int q) {
+  auto found = std::find(blockQubits.begin(), blockQubits.end(), q);
+  if (found != blockQubits.end()) {
+    return found - blockQubits.begin();
+  }
+  if (blockQubits.size() == maxQubits) {
+    xacc::error("Qubit " + std::to_string(q) + " does not fit in a block of " +
+                std::to_string(maxQubits) + " qubits.");
+  }
+
+  // The new qubit is the highest bit, the unitary becomes I x U
+  std::vector<Amplitude> expanded(4 * dim * dim);
+  for (int r = 0; r < dim; r++) {
+    for (int c = 0; c < dim; c++) {
+      expanded[r * 2 * dim + c] = matrix[r * dim + c];
+      expanded[(r + dim) * 2 * dim + c + dim] = matrix[r * dim + c];
+    }
+  }
+  matrix = std::move(expanded);
+  dim *= 2;
+  blockQubits.push_back(q);
+  return blockQubits.size() - 1;
+}
+
+void GateBlock::multiply(const int t, const Matrix &m, const int controls) {
+  const int stride = 1 << t;
+  for (int r0 = 0; r0 < dim; r0++) {
+    if ((r0 & stride) || (r0 & controls) != controls) {
+      continue;
+    }
+    auto row0 = matrix.data() + r0 * dim;
+    auto row1 = matrix.data() + (r0 | stride) * dim;
+    for (int c = 0; c < dim; c++) {
+      auto a = row0[c], b = row1[c];
+      row0[c] = m[0] * a + m[1] * b;
+      row1[c] = m[2] * a + m[3] * b;
+    }
+  }
+}
+
+void GateBlock::apply(const int q, const Matrix &m) {
+  multiply(local(q), m, 0);
+}
+
+void GateBlock::applyControlled(const int c, const int t, const Matrix &m) {
+  auto control = local(c);
+  multiply(local(t), m, 1 << control);
+}
+
+void GateBlock::applyDiagonal(const int q, const Amplitude d0,
+                              const Amplitude d1) {
+  multiply(local(q), {d0, 0.0, 0.0, d1}, 0);
+}
+
+void GateBlock::applyX(const int q) {
+  multiply(local(q), {0.0, 1.0, 1.0, 0.0}, 0);
+}
+
+void GateBlock::applyCNOT(const int c, const int t) {
+  applyControlled(c, t, {0.0, 1.0, 1.0, 0.0});
+}
+
+void GateBlock::applySwap(const int a, const int b) {
+  const int bitA = 1 << local(a), bitB = 1 << local(b);
+  for (int r = 0; r < dim; r++) {
+    if ((r & bitA) && !(r & bitB)) {
+      auto row = matrix.begin() + r * dim;
+      std::swap_ranges(row, row + dim,
+                       matrix.begin() + (r ^ bitA ^ bitB) * dim);
+    }
+  }
+}
+
+int GateBlock::measure(const int q, const double r) {
+  xacc::error("Cannot fuse the measurement of qubit " + std::to_string(q) +
+              " into a GateBlock.");
+  return 0;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_GATEBLOCK_HPP_
+#define QUANTUM_GATE_ACCELERATOR_GATEBLOCK_HPP_
+
+#include "StateVector.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The GateBlock multiplies a sequence of gates on a few qubits into the
+ * dense unitary they amount to, to be applied to a StateVector with a
+ * single applyMatrix(). It has the gate interface of the StateVector,
+ * so a BasicStateVectorVisitor can build it from gate Instructions.
+ *
+ * Qubits join the block in the order gates first touch them, the
+ * first being bit 0 of the unitary's row and column indices.
+ */
+class GateBlock {
+
+public:
+  using Amplitude = StateVector::Amplitude;
+  using Matrix = StateVector::Matrix;
+
+  /**
+   * The constructor, creates an empty block.
+   *
+   * @param maxQubits The most qubits the block may act on
+   */
+  GateBlock(const int maxQubits);
+
+  /**
+   * Empty the block.
+   */
+  void clear();
+
+  /**
+   * Return true if a gate on the given qubits keeps the block
+   * within its maximum number of qubits.
+   *
+   * @param bits The qubits of the gate
+   */
+  bool fits(const std::vector<int> &bits) const;
+
+  /**
+   * Return the qubits the block acts on.
+   */
+  const std::vector<int> &qubits() const { return blockQubits; }
+
+  /**
+   * Return the unitary of the block in row major order.
+   */
+  const std::vector<Amplitude> &unitary() const { return matrix; }
+
+  void apply(const int q, const Matrix &m);
+  void applyControlled(const int c, const int t, const Matrix &m);
+  void applyDiagonal(const int q, const Amplitude d0, const Amplitude d1);
+  void applyX(const int q);
+  void applyCNOT(const int c, const int t);
+  void applySwap(const int a, const int b);
+
+  /**
+   * Measurements cannot be fused, this is an error.
+   */
+  int measure(const int q, const double r);
+
+protected:
+  int maxQubits;
+  int dim;
+  std::vector<int> blockQubits;
+  std::vector<Amplitude> matrix;
+
+  /**
+   * Return the bit of the given qubit in the unitary's indices,
+   * adding the qubit to the block if it is new.
+   */
+  int local(const int q);
+
+  /**
+   * Multiply the given 2x2 matrix on the given bit into the rows
+   * of the unitary whose index has the given control bits set.
+   */
+  void multiply(const int t, const Matrix &m, const int controls);
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "MPSAccelerator.hpp"
+#include "MatrixProductState.hpp"
+#include "StateVectorVisitor.hpp"
+#include "CircuitScan.hpp"
+#include <random>
+
+namespace xacc {
+namespace quantum {
+
+using MPSVisitor = BasicStateVectorVisitor<MatrixProductState>;
+
+std::shared_ptr<AcceleratorBuffer>
+MPSAccelerator::createBuffer(const std::string &varId) {
+  return createBuffer(varId, 100);
+}
+
+std::shared_ptr<AcceleratorBuffer>
+MPSAccelerator::createBuffer(const std::string &varId, const int size) {
+  if (!isValidBufferSize(size)) {
+    xacc::error("Invalid buffer size.");
+  }
+
+  auto buffer = std::make_shared<AcceleratorBuffer>(varId, size);
+  storeBuffer(varId, buffer);
+  return buffer;
+}
+
+void MPSAccelerator::execute(std::shared_ptr<AcceleratorBuffer> buffer,
+                             const std::shared_ptr<Function> function) {
+  const int shots = xacc::optionExists("mps-shots")
+                        ? std::stoi(xacc::getOption("mps-shots"))
+                        : 1024;
+  const int maxBond = xacc::optionExists("mps-max-bond")
+                          ? std::stoi(xacc::getOption("mps-max-bond"))
+                          : 64;
+  const double cutoff = xacc::optionExists("mps-svd-cutoff")
+                            ? std::stod(xacc::getOption("mps-svd-cutoff"))
+                            : 1e-12;
+  std::mt19937_64 generator(xacc::optionExists("mps-seed")
+                                ? std::stoull(xacc::getOption("mps-seed"))
+                                : std::random_device()());
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  auto random = [&]() { return distribution(generator); };
+
+  CircuitScan s(function);
+  MatrixProductState state(s.nQubits(), maxBond, cutoff);
+  int bond = 1;
+  double truncationError = 0.0;
+
+  std::map<std::string, int> counts;
+  if (s.terminal) {
+    MPSVisitor visitor(state, random, false);
+    function->accept(&visitor);
+    if (visitor.measurements.empty()) {
+      return;
+    }
+
+    for (auto &sample : state.sample(shots, generator)) {
+      std::map<int, int> bits;
+      for (auto &m : visitor.measurements) {
+        bits[m.second] = (sample[m.first / 64] >> (m.first % 64)) & 1;
+      }
+      counts[s.bitString(buffer->size(),
+                         [&](const int i) { return bits[i]; })]++;
+    }
+    bond = state.bondDimension();
+    truncationError = state.truncationError();
+  } else {
+    for (int shot = 0; shot < shots; shot++) {
+      state.reset();
+      MPSVisitor visitor(state, random);
+      function->accept(&visitor);
+      counts[s.bitString(buffer->size(), [&](const int i) {
+        return visitor.classicalBits[i];
+      })]++;
+      bond = std::max(bond, state.bondDimension());
+      truncationError = std::max(truncationError, state.truncationError());
+    }
+  }
+
+  buffer->appendMeasurements(counts);
+  buffer->addExtraInfo("mps-bond-dimension", ExtraInfo(bond));
+  buffer->addExtraInfo("mps-truncation-error", ExtraInfo(truncationError));
+}
+
+std::vector<std::shared_ptr<AcceleratorBuffer>>
+MPSAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::vector<std::shared_ptr<Function>> functions) {
+  int counter = 0;
+  std::vector<std::shared_ptr<AcceleratorBuffer>> tmpBuffers;
+  for (auto f : functions) {
+    auto tmpBuffer = createBuffer(buffer->name() + std::to_string(counter),
+                                  buffer->size());
+    execute(tmpBuffer, f);
+    tmpBuffers.push_back(tmpBuffer);
+    counter++;
+  }
+
+  return tmpBuffers;
+}
+
+} // namespace quantum
+} // namespace xacc
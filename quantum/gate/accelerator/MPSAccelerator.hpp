@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_MPSACCELERATOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_MPSACCELERATOR_HPP_
+
+#include "Accelerator.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The MPSAccelerator simulates gate model Functions on a local
+ * MatrixProductState, and fills the AcceleratorBuffer with the
+ * measurement counts of the requested number of shots. It reaches far
+ * more qubits than the StateVectorAccelerator on shallow, roughly 1-D
+ * circuits, exactly as long as the bond dimension stays below
+ * mps-max-bond and approximately beyond it.
+ *
+ * Functions are simulated once and sampled, or once per shot, as by the
+ * StateVectorAccelerator. The largest bond dimension reached and the
+ * discarded singular value weight are stored in the buffer's ExtraInfo
+ * as mps-bond-dimension and mps-truncation-error.
+ */
+class MPSAccelerator : public Accelerator {
+public:
+  void initialize() override {}
+
+  AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
+
+  std::vector<std::shared_ptr<IRTransformation>>
+  getIRTransformations() override {
+    return {};
+  }
+
+  std::shared_ptr<AcceleratorBuffer>
+  createBuffer(const std::string &varId) override;
+
+  std::shared_ptr<AcceleratorBuffer> createBuffer(const std::string &varId,
+                                                  const int size) override;
+
+  bool isValidBufferSize(const int NBits) override { return NBits > 0; }
+
+  void execute(std::shared_ptr<AcceleratorBuffer> buffer,
+               const std::shared_ptr<Function> function) override;
+
+  std::vector<std::shared_ptr<AcceleratorBuffer>>
+  execute(std::shared_ptr<AcceleratorBuffer> buffer,
+          const std::vector<std::shared_ptr<Function>> functions) override;
+
+  OptionPairs getOptions() override {
+    return OptionPairs{
+        {"mps-max-bond", "The maximum bond dimension, 64 by default."},
+        {"mps-svd-cutoff",
+         "Drop singular values below this fraction of the largest, "
+         "1e-12 by default."},
+        {"mps-shots", "The number of shots to sample, 1024 by default."},
+        {"mps-seed", "The seed of the measurement outcomes."}};
+  }
+
+  const std::string name() const override { return "mps"; }
+
+  const std::string description() const override {
+    return "The MPS Accelerator simulates XACC quantum IR on a local "
+           "matrix product state of bounded bond dimension.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,288 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "MatrixProductState.hpp"
+#include "XACC.hpp"
+#include <Eigen/Dense>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+using Amplitude = MatrixProductState::Amplitude;
+using Matrix2 = MatrixProductState::Matrix2;
+using MatrixXc = Eigen::MatrixXcd;
+using Map = Eigen::Map<MatrixXc>;
+using Slice = Eigen::Map<const MatrixXc, 0, Eigen::OuterStride<>>;
+
+const Matrix2 swapGate{1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0,
+                       0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+
+// The given two qubit matrix with the roles of its qubits exchanged
+Matrix2 exchanged(const Matrix2 &m) {
+  auto flip = [](const int i) { return ((i & 1) << 1) | (i >> 1); };
+  Matrix2 result;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      result[flip(i) * 4 + flip(j)] = m[i * 4 + j];
+    }
+  }
+  return result;
+}
+
+// The (left bond x right bond) matrix of the given site at physical index s
+Slice slice(const MatrixProductState::Site &site, const int s) {
+  const auto l = site.dimension(0);
+  return Slice(site.data() + s * l, l, site.dimension(2),
+               Eigen::OuterStride<>(2 * l));
+}
+} // namespace
+
+MatrixProductState::MatrixProductState(const int n, const int bond,
+                                       const double c)
+    : nQubits(n), maxBond(bond), cutoff(c) {
+  if (nQubits < 1 || maxBond < 1) {
+    xacc::error("Invalid MatrixProductState of " + std::to_string(nQubits) +
+                " qubits and bond dimension " + std::to_string(maxBond) +
+                ".");
+  }
+  reset();
+}
+
+void MatrixProductState::reset() {
+  Site zero(1, 2, 1);
+  zero.setZero();
+  zero(0, 0, 0) = 1.0;
+  sites.assign(nQubits, zero);
+  center = 0;
+  discarded = 0.0;
+}
+
+void MatrixProductState::apply(const int q, const Matrix &m) {
+  auto &site = sites[q];
+  for (long r = 0; r < site.dimension(2); r++) {
+    for (long l = 0; l < site.dimension(0); l++) {
+      const auto a0 = site(l, 0, r), a1 = site(l, 1, r);
+      site(l, 0, r) = m[0] * a0 + m[1] * a1;
+      site(l, 1, r) = m[2] * a0 + m[3] * a1;
+    }
+  }
+}
+
+void MatrixProductState::applyDiagonal(const int q, const Amplitude d0,
+                                       const Amplitude d1) {
+  apply(q, {d0, 0.0, 0.0, d1});
+}
+
+void MatrixProductState::applyX(const int q) {
+  apply(q, {0.0, 1.0, 1.0, 0.0});
+}
+
+void MatrixProductState::applyControlled(const int c, const int t,
+                                         const Matrix &m) {
+  Matrix2 g{1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, m[0], m[1], 0.0, 0.0, m[2], m[3]};
+  apply(c, t, g);
+}
+
+void MatrixProductState::applyCNOT(const int c, const int t) {
+  applyControlled(c, t, {0.0, 1.0, 1.0, 0.0});
+}
+
+void MatrixProductState::applySwap(const int a, const int b) {
+  apply(a, b, swapGate);
+}
+
+void MatrixProductState::apply(const int a, const int b, const Matrix2 &m) {
+  if (a == b) {
+    xacc::error("Cannot apply a two qubit gate to qubit " +
+                std::to_string(a) + " twice.");
+  }
+  const int lo = std::min(a, b), hi = std::max(a, b);
+
+  // Swap qubit hi down next to qubit lo, apply the gate, and swap it
+  // back, leaving the center where the next swap or gate needs it
+  for (int s = hi - 1; s > lo; s--) {
+    applyNeighbors(s, swapGate, true);
+  }
+  applyNeighbors(lo, a < b ? m : exchanged(m), false);
+  for (int s = lo + 1; s < hi; s++) {
+    applyNeighbors(s, swapGate, false);
+  }
+}
+
+void MatrixProductState::applyNeighbors(const int i, const Matrix2 &m,
+                                        const bool centerLeft) {
+  moveCenter(i);
+  const auto l = sites[i].dimension(0), r = sites[i + 1].dimension(2);
+
+  Eigen::Tensor<Amplitude, 4> gate(2, 2, 2, 2);
+  for (int a = 0; a < 2; a++) {
+    for (int b = 0; b < 2; b++) {
+      for (int c = 0; c < 2; c++) {
+        for (int d = 0; d < 2; d++) {
+          gate(a, b, c, d) = m[(2 * a + b) * 4 + 2 * c + d];
+        }
+      }
+    }
+  }
+
+  // theta(l, p1, p2, r) = A(l, p1, k) B(k, p2, r), then the gate
+  // acts on both physical indices
+  const Eigen::array<Eigen::IndexPair<int>, 1> bond{
+      {Eigen::IndexPair<int>(2, 0)}};
+  const Eigen::array<Eigen::IndexPair<int>, 2> physical{
+      {Eigen::IndexPair<int>(2, 1), Eigen::IndexPair<int>(3, 2)}};
+  const Eigen::array<int, 4> order{{2, 0, 1, 3}};
+  Eigen::Tensor<Amplitude, 4> theta =
+      gate.contract(sites[i].contract(sites[i + 1], bond), physical)
+          .shuffle(order);
+
+  // Split theta as a (2l x 2r) matrix, keeping the largest singular values
+  Eigen::BDCSVD<MatrixXc> svd(Map(theta.data(), 2 * l, 2 * r),
+                              Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const Eigen::VectorXd &values = svd.singularValues();
+  const long kMax = std::min<long>(values.size(), maxBond);
+  long k = 1;
+  while (k < kMax && values(k) > cutoff * values(0)) {
+    k++;
+  }
+  const double total = values.squaredNorm(),
+               kept = values.head(k).squaredNorm();
+  discarded += 1.0 - kept / total;
+  Eigen::VectorXcd s = (values.head(k) / std::sqrt(kept)).cast<Amplitude>();
+
+  MatrixXc u = svd.matrixU().leftCols(k);
+  MatrixXc v = svd.matrixV().leftCols(k).adjoint();
+  if (centerLeft) {
+    u = u * s.asDiagonal();
+  } else {
+    v = s.asDiagonal() * v;
+  }
+  sites[i] = Site(l, 2, k);
+  Map(sites[i].data(), 2 * l, k) = u;
+  sites[i + 1] = Site(k, 2, r);
+  Map(sites[i + 1].data(), k, 2 * r) = v;
+  center = centerLeft ? i : i + 1;
+}
+
+void MatrixProductState::moveCenter(const int site) {
+  while (center < site) {
+    // A = QR, Q stays and R moves into the next site
+    auto &a = sites[center], &b = sites[center + 1];
+    const auto l = a.dimension(0), r = a.dimension(2), rb = b.dimension(2);
+    Eigen::HouseholderQR<MatrixXc> qr(Map(a.data(), 2 * l, r));
+    const auto k = std::min(2 * l, r);
+    MatrixXc q = qr.householderQ() * MatrixXc::Identity(2 * l, k);
+    MatrixXc R = qr.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+    MatrixXc next = R * Map(b.data(), r, 2 * rb);
+    a = Site(l, 2, k);
+    Map(a.data(), 2 * l, k) = q;
+    b = Site(k, 2, rb);
+    Map(b.data(), k, 2 * rb) = next;
+    center++;
+  }
+  while (center > site) {
+    // A = (QR)^dagger, Q^dagger stays and R^dagger moves into the
+    // previous site
+    auto &a = sites[center], &b = sites[center - 1];
+    const auto l = a.dimension(0), r = a.dimension(2), lb = b.dimension(0);
+    Eigen::HouseholderQR<MatrixXc> qr(Map(a.data(), l, 2 * r).adjoint());
+    const auto k = std::min(2 * r, l);
+    MatrixXc q = qr.householderQ() * MatrixXc::Identity(2 * r, k);
+    MatrixXc R = qr.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+    MatrixXc previous = Map(b.data(), 2 * lb, l) * R.adjoint();
+    a = Site(k, 2, r);
+    Map(a.data(), k, 2 * r) = q.adjoint();
+    b = Site(lb, 2, k);
+    Map(b.data(), 2 * lb, k) = previous;
+    center--;
+  }
+}
+
+int MatrixProductState::measure(const int q, const double r) {
+  // With the center on q, its site alone gives the probabilities
+  moveCenter(q);
+  auto &site = sites[q];
+  double p[2] = {0.0, 0.0};
+  for (long k = 0; k < site.dimension(2); k++) {
+    for (int s = 0; s < 2; s++) {
+      for (long l = 0; l < site.dimension(0); l++) {
+        p[s] += std::norm(site(l, s, k));
+      }
+    }
+  }
+
+  const int outcome = r * (p[0] + p[1]) < p[1];
+  const double scale = 1.0 / std::sqrt(p[outcome]);
+  for (long k = 0; k < site.dimension(2); k++) {
+    for (long l = 0; l < site.dimension(0); l++) {
+      site(l, outcome, k) *= scale;
+      site(l, 1 - outcome, k) = 0.0;
+    }
+  }
+  return outcome;
+}
+
+std::vector<std::vector<std::uint64_t>>
+MatrixProductState::sample(const int shots, std::mt19937_64 &generator) {
+  // With the center on the first site, every later site is right
+  // orthonormal, so the conditional probabilities of each qubit
+  // follow from the prefix alone
+  moveCenter(0);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  const int nWords = (nQubits + 63) / 64;
+  std::vector<std::vector<std::uint64_t>> samples(
+      shots, std::vector<std::uint64_t>(nWords));
+  for (auto &sample : samples) {
+    Eigen::RowVectorXcd prefix = Eigen::RowVectorXcd::Ones(1);
+    for (int q = 0; q < nQubits; q++) {
+      Eigen::RowVectorXcd w0 = prefix * slice(sites[q], 0),
+                          w1 = prefix * slice(sites[q], 1);
+      const double p0 = w0.squaredNorm(), p1 = w1.squaredNorm();
+      if (distribution(generator) * (p0 + p1) < p1) {
+        sample[q / 64] |= 1ULL << (q % 64);
+        prefix = w1 / std::sqrt(p1);
+      } else {
+        prefix = w0 / std::sqrt(p0);
+      }
+    }
+  }
+  return samples;
+}
+
+std::vector<MatrixProductState::Amplitude>
+MatrixProductState::amplitudes() const {
+  if (nQubits > 30) {
+    xacc::error("Too many qubits to list the amplitudes of.");
+  }
+  // Rows index the qubits contracted so far, columns the open bond
+  MatrixXc psi = MatrixXc::Ones(1, 1);
+  for (auto &site : sites) {
+    MatrixXc next(2 * psi.rows(), site.dimension(2));
+    next.topRows(psi.rows()) = psi * slice(site, 0);
+    next.bottomRows(psi.rows()) = psi * slice(site, 1);
+    psi = std::move(next);
+  }
+  return std::vector<Amplitude>(psi.data(), psi.data() + psi.size());
+}
+
+int MatrixProductState::bondDimension() const {
+  long bond = 1;
+  for (auto &site : sites) {
+    bond = std::max(bond, site.dimension(2));
+  }
+  return bond;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_MATRIXPRODUCTSTATE_HPP_
+#define QUANTUM_GATE_ACCELERATOR_MATRIXPRODUCTSTATE_HPP_
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <array>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The MatrixProductState holds an n qubit pure state as a chain of
+ * rank 3 tensors, one per qubit, indexed (left bond, physical, right
+ * bond), and applies gates to it with the gate interface of the
+ * StateVector, so the same visitor drives both.
+ *
+ * The chain is kept in mixed canonical form around one orthogonality
+ * center. Two qubit gates contract their two neighboring sites, apply
+ * the gate and split the result again by SVD, keeping at most the
+ * maximum bond dimension of singular values and dropping those below
+ * the cutoff relative to the largest. Gates on qubits that are not
+ * neighbors are applied after swapping them next to each other, and
+ * the swaps are undone afterwards. Memory and time grow with the bond
+ * dimension, not exponentially with the number of qubits, so shallow,
+ * roughly 1-D circuits on hundreds of qubits stay cheap.
+ */
+class MatrixProductState {
+
+public:
+  using Amplitude = std::complex<double>;
+
+  /**
+   * A 2x2 gate matrix in row major order.
+   */
+  using Matrix = std::array<Amplitude, 4>;
+
+  /**
+   * A 4x4 two qubit gate matrix in row major order, the basis
+   * state index being twice the first qubit's bit plus the second's.
+   */
+  using Matrix2 = std::array<Amplitude, 16>;
+
+  /**
+   * The tensor of one site, indexed (left bond, physical, right bond).
+   */
+  using Site = Eigen::Tensor<Amplitude, 3>;
+
+  /**
+   * The constructor, creates the state |0...0>.
+   *
+   * @param nQubits The number of qubits
+   * @param maxBond The maximum bond dimension
+   * @param cutoff The relative singular value cutoff
+   */
+  MatrixProductState(const int nQubits, const int maxBond = 64,
+                     const double cutoff = 1e-12);
+
+  /**
+   * Return the number of qubits.
+   */
+  const int size() const { return nQubits; }
+
+  /**
+   * Reset to the state |0...0>.
+   */
+  void reset();
+
+  void apply(const int q, const Matrix &m);
+  void applyControlled(const int c, const int t, const Matrix &m);
+  void applyDiagonal(const int q, const Amplitude d0, const Amplitude d1);
+  void applyX(const int q);
+  void applyCNOT(const int c, const int t);
+  void applySwap(const int a, const int b);
+
+  /**
+   * Apply the given 4x4 matrix to the given qubits, which
+   * need not be neighbors.
+   *
+   * @param a The first qubit
+   * @param b The second qubit
+   * @param m The gate matrix
+   */
+  void apply(const int a, const int b, const Matrix2 &m);
+
+  /**
+   * Measure the given qubit and collapse the state onto the outcome.
+   *
+   * @param q The qubit
+   * @param r A uniform random number in [0,1)
+   * @return outcome The measured bit
+   */
+  int measure(const int q, const double r);
+
+  /**
+   * Sample the outcomes of measuring every qubit, leaving the state
+   * unchanged up to its gauge. Each shot samples the qubits in turn
+   * from their conditional probabilities, at O(n chi^2) cost.
+   *
+   * @param shots The number of shots
+   * @param generator The source of random numbers
+   * @return samples For each shot, the outcomes packed 64 to a word
+   */
+  std::vector<std::vector<std::uint64_t>>
+  sample(const int shots, std::mt19937_64 &generator);
+
+  /**
+   * Return the 2^n amplitudes, qubit q being bit q of the
+   * basis state index, for comparison with a StateVector.
+   */
+  std::vector<Amplitude> amplitudes() const;
+
+  /**
+   * Return the largest bond dimension.
+   */
+  int bondDimension() const;
+
+  /**
+   * Return the total weight of the singular values discarded
+   * so far, an estimate of the infidelity of the state.
+   */
+  double truncationError() const { return discarded; }
+
+protected:
+  int nQubits;
+  int maxBond;
+  double cutoff;
+  double discarded = 0.0;
+
+  std::vector<Site> sites;
+
+  /**
+   * The site of the orthogonality center.
+   */
+  int center = 0;
+
+  /**
+   * Move the orthogonality center to the given site by QR
+   * decompositions of the sites in between.
+   */
+  void moveCenter(const int site);
+
+  /**
+   * Apply the given 4x4 matrix to sites i and i + 1, leaving the
+   * orthogonality center on site i if centerLeft, else on i + 1.
+   */
+  void applyNeighbors(const int i, const Matrix2 &m, const bool centerLeft);
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
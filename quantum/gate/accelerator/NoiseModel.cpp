@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "NoiseModel.hpp"
+#include "XACC.hpp"
+#include <regex>
+
+#define RAPIDJSON_HAS_STDSTRING 1
+
+#include "rapidjson/document.h"
+using namespace rapidjson;
+
+namespace xacc {
+namespace quantum {
+
+void NoiseModel::load(const std::string &json) {
+  gateErrors.clear();
+  readoutErrors.clear();
+  multiQubitGates.clear();
+  multiQubitGateErrors.clear();
+  pairErrors.clear();
+
+  Document d;
+  d.Parse(json);
+  if (d.HasParseError() || !d.IsObject() || !d.HasMember("qubits")) {
+    xacc::error("Invalid calibration JSON, expected a qubits array.");
+  }
+
+  auto qubits = d["qubits"].GetArray();
+  for (int i = 0; i < qubits.Size(); i++) {
+    gateErrors.push_back(qubits[i]["gateError"]["value"].GetDouble());
+    readoutErrors.push_back(qubits[i]["readoutError"]["value"].GetDouble());
+  }
+
+  if (d.HasMember("multiQubitGates")) {
+    auto mqGates = d["multiQubitGates"].GetArray();
+    for (int i = 0; i < mqGates.Size(); i++) {
+      std::string name = mqGates[i]["name"].GetString();
+      auto error = mqGates[i]["gateError"]["value"].GetDouble();
+      auto split =
+          xacc::split(std::regex_replace(name, std::regex("CX"), ""), '_');
+      if (split.size() != 2) {
+        xacc::error("Invalid two qubit gate name " + name +
+                    " in calibration JSON.");
+      }
+      multiQubitGates.push_back(name);
+      multiQubitGateErrors.push_back(error);
+      pairErrors[{std::stoi(split[0]), std::stoi(split[1])}] = error;
+    }
+  }
+}
+
+double NoiseModel::gateError(const int a, const int b) const {
+  auto error = pairErrors.find({a, b});
+  if (error == pairErrors.end()) {
+    error = pairErrors.find({b, a});
+  }
+  return error == pairErrors.end() ? 0.0 : error->second;
+}
+
+std::vector<std::pair<std::pair<int, int>, double>>
+NoiseModel::twoBitErrorRates() const {
+  std::vector<std::pair<std::pair<int, int>, double>> rates;
+  for (auto &kv : pairErrors) {
+    rates.push_back(kv);
+  }
+  return rates;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_NOISEMODEL_HPP_
+#define QUANTUM_GATE_ACCELERATOR_NOISEMODEL_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The NoiseModel holds per qubit gate and readout error rates and per
+ * pair two qubit gate error rates, read from backend calibration JSON
+ * of the form the IBMAccelerator retrieves,
+ *
+ * {
+ *   "qubits": [
+ *     {"gateError": {"value": 1e-3}, "readoutError": {"value": 2e-2}}, ...
+ *   ],
+ *   "multiQubitGates": [
+ *     {"name": "CX0_1", "gateError": {"value": 3e-2}}, ...
+ *   ]
+ * }
+ *
+ * An empty NoiseModel is noiseless.
+ */
+class NoiseModel {
+
+protected:
+  std::vector<double> gateErrors;
+  std::vector<double> readoutErrors;
+  std::vector<std::string> multiQubitGates;
+  std::vector<double> multiQubitGateErrors;
+  std::map<std::pair<int, int>, double> pairErrors;
+
+public:
+  /**
+   * Load the error rates from the given calibration JSON,
+   * replacing any loaded before.
+   *
+   * @param json The calibration JSON
+   */
+  void load(const std::string &json);
+
+  /**
+   * Return the depolarizing probability of a single qubit
+   * gate on the given qubit.
+   */
+  double gateError(const int q) const {
+    return q < gateErrors.size() ? gateErrors[q] : 0.0;
+  }
+
+  /**
+   * Return the depolarizing probability of a two qubit gate on the
+   * given qubits, in either order, 0 if the pair is not calibrated.
+   */
+  double gateError(const int a, const int b) const;
+
+  /**
+   * Return the probability that measuring the given qubit
+   * reports the wrong bit.
+   */
+  double readoutError(const int q) const {
+    return q < readoutErrors.size() ? readoutErrors[q] : 0.0;
+  }
+
+  /**
+   * Return the single qubit gate error rates, indexed by qubit.
+   */
+  const std::vector<double> &oneBitErrorRates() const { return gateErrors; }
+
+  /**
+   * Return the readout error rates, indexed by qubit.
+   */
+  const std::vector<double> &readoutErrorRates() const {
+    return readoutErrors;
+  }
+
+  /**
+   * Return the two qubit gate error rates as ((q1,q2), rate) pairs,
+   * as Accelerator::getTwoBitErrorRates does.
+   */
+  std::vector<std::pair<std::pair<int, int>, double>>
+  twoBitErrorRates() const;
+
+  /**
+   * Return the calibrated two qubit gate names, such as CX0_1.
+   */
+  const std::vector<std::string> &twoBitGates() const {
+    return multiQubitGates;
+  }
+
+  /**
+   * Return the two qubit gate error rates, in the order of twoBitGates().
+   */
+  const std::vector<double> &twoBitGateErrors() const {
+    return multiQubitGateErrors;
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
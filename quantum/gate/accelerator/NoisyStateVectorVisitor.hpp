@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_NOISYSTATEVECTORVISITOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_NOISYSTATEVECTORVISITOR_HPP_
+
+#include "StateVectorVisitor.hpp"
+#include "NoiseModel.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The NoisyStateVectorVisitor runs one Monte-Carlo trajectory of a
+ * noisy Function. Each gate is followed by depolarizing noise, a
+ * uniformly random non-identity Pauli on its qubits with the gate's
+ * error probability, and each measured bit is flipped with the
+ * qubit's readout error probability before ConditionalFunctions or
+ * the counts see it. Measurements always collapse the state.
+ */
+class NoisyStateVectorVisitor : public StateVectorVisitor {
+
+protected:
+  const NoiseModel &model;
+
+  void pauli(const int q, const int p) {
+    if (p == 1) {
+      state.applyX(q);
+    } else if (p == 2) {
+      state.apply(q, pauliY());
+    } else if (p == 3) {
+      state.applyDiagonal(q, 1.0, -1.0);
+    }
+  }
+
+  void noise(Instruction &inst) {
+    auto bits = inst.bits();
+    if (bits.size() == 1) {
+      if (random() < model.gateError(bits[0])) {
+        pauli(bits[0], 1 + std::min(2, static_cast<int>(3 * random())));
+      }
+    } else if (bits.size() == 2) {
+      if (random() < model.gateError(bits[0], bits[1])) {
+        // One of the 15 non-identity two qubit Paulis
+        auto p = 1 + std::min(14, static_cast<int>(15 * random()));
+        pauli(bits[0], p % 4);
+        pauli(bits[1], p / 4);
+      }
+    }
+  }
+
+  void visitNoisy(const std::vector<InstPtr> &instructions,
+                  const bool enabledOnly) {
+    for (auto &inst : instructions) {
+      if (inst->isComposite()) {
+        inst->accept(this);
+      } else if (!enabledOnly || inst->isEnabled()) {
+        inst->accept(this);
+        if (inst->name() != "Measure") {
+          noise(*inst);
+        }
+      }
+    }
+  }
+
+public:
+  /**
+   * The constructor.
+   *
+   * @param s The state to apply gates to
+   * @param r The source of uniform random numbers in [0,1)
+   * @param m The error rates
+   */
+  NoisyStateVectorVisitor(StateVector &s, std::function<double()> r,
+                          const NoiseModel &m)
+      : StateVectorVisitor(s, r), model(m) {}
+
+  void visit(GateFunction &f) override {
+    visitNoisy(f.getInstructions(), true);
+  }
+
+  void visit(ConditionalFunction &c) override {
+    auto bit = classicalBits.find(c.getConditionalQubit());
+    if (bit == classicalBits.end() || bit->second != 1) {
+      return;
+    }
+    visitNoisy(c.getInstructions(), false);
+  }
+
+  void visit(Measure &m) override {
+    StateVectorVisitor::visit(m);
+    if (random() < model.readoutError(m.bits()[0])) {
+      auto &bit = classicalBits[m.getParameter(0).as<int>()];
+      bit = 1 - bit;
+    }
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
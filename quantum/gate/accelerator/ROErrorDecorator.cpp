@@ -50,9 +50,7 @@ void ROErrorDecorator::execute(std::shared_ptr<AcceleratorBuffer> buffer,
 
   auto supports = [](std::shared_ptr<Function> f) {
     std::set<int> supportSet;
-    InstructionIterator it(f);
-    while (it.hasNext()) {
-      auto nextInst = it.next();
+    for (auto &nextInst : InstructionRange(f, Traversal::Leaves)) {
       if (nextInst->name() == "Measure") {
         auto bits = nextInst->bits();
         for (auto &b : bits)
@@ -111,9 +109,7 @@ std::vector<std::shared_ptr<AcceleratorBuffer>> ROErrorDecorator::execute(
 
   auto supports = [](std::shared_ptr<Function> f) {
     std::set<int> supportSet;
-    InstructionIterator it(f);
-    while (it.hasNext()) {
-      auto nextInst = it.next();
+    for (auto &nextInst : InstructionRange(f, Traversal::Leaves)) {
       if (nextInst->name() == "Measure") {
         auto bits = nextInst->bits();
         for (auto &b : bits) {
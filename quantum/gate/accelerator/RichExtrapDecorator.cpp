@@ -28,18 +28,12 @@ void RichExtrapDecorator::execute(std::shared_ptr<AcceleratorBuffer> buffer,
   auto f = provider->createFunction(function->name(), function->bits(),
                                     function->getParameters());
 
-  InstructionIterator it(function);
-  while (it.hasNext()) {
-    auto nextInst = it.next();
-
-    if (!nextInst->isComposite() && nextInst->isEnabled()) {
-
-      if (nextInst->name() == "CNOT") {
-        for (int i = 0; i < r; i++)
-          f->addInstruction(nextInst);
-      } else {
+  for (auto &nextInst : InstructionRange(function, Traversal::EnabledLeaves)) {
+    if (nextInst->name() == "CNOT") {
+      for (int i = 0; i < r; i++)
         f->addInstruction(nextInst);
-      }
+    } else {
+      f->addInstruction(nextInst);
     }
   }
 
@@ -77,18 +71,12 @@ std::vector<std::shared_ptr<AcceleratorBuffer>> RichExtrapDecorator::execute(
     auto newF =
         provider->createFunction(f->name(), f->bits(), f->getParameters());
 
-    InstructionIterator it(f);
-    while (it.hasNext()) {
-      auto nextInst = it.next();
-
-      if (!nextInst->isComposite() && nextInst->isEnabled()) {
-
-        if (nextInst->name() == "CNOT") {
-          for (int i = 0; i < r; i++)
-            newF->addInstruction(nextInst);
-        } else {
+    for (auto &nextInst : InstructionRange(f, Traversal::EnabledLeaves)) {
+      if (nextInst->name() == "CNOT") {
+        for (int i = 0; i < r; i++)
           newF->addInstruction(nextInst);
-        }
+      } else {
+        newF->addInstruction(nextInst);
       }
     }
 
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "StabilizerAccelerator.hpp"
+#include "StabilizerVisitor.hpp"
+#include "CircuitScan.hpp"
+#include <random>
+
+namespace xacc {
+namespace quantum {
+
+std::shared_ptr<AcceleratorBuffer>
+StabilizerAccelerator::createBuffer(const std::string &varId) {
+  return createBuffer(varId, 100);
+}
+
+std::shared_ptr<AcceleratorBuffer>
+StabilizerAccelerator::createBuffer(const std::string &varId,
+                                    const int size) {
+  if (!isValidBufferSize(size)) {
+    xacc::error("Invalid buffer size.");
+  }
+
+  auto buffer = std::make_shared<AcceleratorBuffer>(varId, size);
+  storeBuffer(varId, buffer);
+  return buffer;
+}
+
+void StabilizerAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::shared_ptr<Function> function) {
+  const int shots = xacc::optionExists("stabilizer-shots")
+                        ? std::stoi(xacc::getOption("stabilizer-shots"))
+                        : 1024;
+  std::mt19937_64 generator(
+      xacc::optionExists("stabilizer-seed")
+          ? std::stoull(xacc::getOption("stabilizer-seed"))
+          : std::random_device()());
+  auto randomBit = [&]() { return static_cast<int>(generator() & 1); };
+
+  CircuitScan s(function);
+  StabilizerTableau tableau(s.nQubits());
+
+  std::map<std::string, int> counts;
+  if (s.terminal) {
+    StabilizerVisitor visitor(tableau, randomBit, false);
+    function->accept(&visitor);
+    if (visitor.measurements.empty()) {
+      return;
+    }
+
+    for (auto &sample : tableau.sample(shots, generator)) {
+      std::map<int, int> bits;
+      for (auto &m : visitor.measurements) {
+        bits[m.second] = (sample[m.first / 64] >> (m.first % 64)) & 1;
+      }
+      counts[s.bitString(buffer->size(),
+                         [&](const int i) { return bits[i]; })]++;
+    }
+  } else {
+    for (int shot = 0; shot < shots; shot++) {
+      tableau.reset();
+      StabilizerVisitor visitor(tableau, randomBit);
+      function->accept(&visitor);
+      counts[s.bitString(buffer->size(), [&](const int i) {
+        return visitor.classicalBits[i];
+      })]++;
+    }
+  }
+
+  buffer->appendMeasurements(counts);
+}
+
+std::vector<std::shared_ptr<AcceleratorBuffer>>
+StabilizerAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::vector<std::shared_ptr<Function>> functions) {
+  int counter = 0;
+  std::vector<std::shared_ptr<AcceleratorBuffer>> tmpBuffers;
+  for (auto f : functions) {
+    auto tmpBuffer = createBuffer(buffer->name() + std::to_string(counter),
+                                  buffer->size());
+    execute(tmpBuffer, f);
+    tmpBuffers.push_back(tmpBuffer);
+    counter++;
+  }
+
+  return tmpBuffers;
+}
+
+} // namespace quantum
+} // namespace xacc
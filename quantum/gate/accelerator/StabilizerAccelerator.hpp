@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STABILIZERACCELERATOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STABILIZERACCELERATOR_HPP_
+
+#include "Accelerator.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The StabilizerAccelerator simulates Clifford gate model Functions on
+ * a local StabilizerTableau in polynomial time, and fills the
+ * AcceleratorBuffer with the measurement counts of the requested number
+ * of shots. Functions with non-Clifford gates are rejected.
+ *
+ * Like the StateVectorAccelerator, a Function whose measurements are
+ * all at the end is simulated once and its shots sampled from the
+ * final tableau, otherwise it is simulated once per shot.
+ */
+class StabilizerAccelerator : public Accelerator {
+public:
+  void initialize() override {}
+
+  AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
+
+  std::vector<std::shared_ptr<IRTransformation>>
+  getIRTransformations() override {
+    return {};
+  }
+
+  std::shared_ptr<AcceleratorBuffer>
+  createBuffer(const std::string &varId) override;
+
+  std::shared_ptr<AcceleratorBuffer> createBuffer(const std::string &varId,
+                                                  const int size) override;
+
+  bool isValidBufferSize(const int NBits) override { return NBits > 0; }
+
+  void execute(std::shared_ptr<AcceleratorBuffer> buffer,
+               const std::shared_ptr<Function> function) override;
+
+  std::vector<std::shared_ptr<AcceleratorBuffer>>
+  execute(std::shared_ptr<AcceleratorBuffer> buffer,
+          const std::vector<std::shared_ptr<Function>> functions) override;
+
+  OptionPairs getOptions() override {
+    return OptionPairs{{"stabilizer-shots",
+                        "The number of shots to sample, 1024 by default."},
+                       {"stabilizer-seed",
+                        "The seed of the measurement outcomes."}};
+  }
+
+  const std::string name() const override { return "stabilizer"; }
+
+  const std::string description() const override {
+    return "The Stabilizer Accelerator simulates Clifford XACC quantum IR "
+           "on a local stabilizer tableau.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
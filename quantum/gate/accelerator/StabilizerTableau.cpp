@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "StabilizerTableau.hpp"
+#include "XACC.hpp"
+#include <algorithm>
+#include <bitset>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+inline int popcount(const std::uint64_t w) {
+  return std::bitset<64>(w).count();
+}
+} // namespace
+
+StabilizerTableau::StabilizerTableau(const int n)
+    : nQubits(n), nWords((n + 63) / 64) {
+  if (nQubits < 1) {
+    xacc::error("Invalid StabilizerTableau size " + std::to_string(nQubits) +
+                ".");
+  }
+  xs.resize((2 * nQubits + 1) * nWords);
+  zs.resize((2 * nQubits + 1) * nWords);
+  signs.resize(2 * nQubits + 1);
+  reset();
+}
+
+void StabilizerTableau::reset() {
+  std::fill(xs.begin(), xs.end(), 0);
+  std::fill(zs.begin(), zs.end(), 0);
+  std::fill(signs.begin(), signs.end(), 0);
+  // Destabilizer i is X_i and stabilizer i is Z_i
+  for (int i = 0; i < nQubits; i++) {
+    xRow(i)[i / 64] = 1ULL << (i % 64);
+    zRow(i + nQubits)[i / 64] = 1ULL << (i % 64);
+  }
+}
+
+// Each gate below updates the column of its qubits in every row, the
+// sign updates are those of Aaronson and Gottesman, PRA 70, 052328
+
+void StabilizerTableau::h(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    auto &xw = xRow(i)[w], &zw = zRow(i)[w];
+    signs[i] ^= (xw & zw & m) != 0;
+    auto t = (xw ^ zw) & m;
+    xw ^= t;
+    zw ^= t;
+  }
+}
+
+void StabilizerTableau::s(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    auto &xw = xRow(i)[w], &zw = zRow(i)[w];
+    signs[i] ^= (xw & zw & m) != 0;
+    zw ^= xw & m;
+  }
+}
+
+void StabilizerTableau::sdg(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    auto &xw = xRow(i)[w], &zw = zRow(i)[w];
+    signs[i] ^= (xw & ~zw & m) != 0;
+    zw ^= xw & m;
+  }
+}
+
+void StabilizerTableau::x(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    signs[i] ^= (zRow(i)[w] & m) != 0;
+  }
+}
+
+void StabilizerTableau::y(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    signs[i] ^= ((xRow(i)[w] ^ zRow(i)[w]) & m) != 0;
+  }
+}
+
+void StabilizerTableau::z(const int q) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+  for (int i = 0; i < 2 * nQubits; i++) {
+    signs[i] ^= (xRow(i)[w] & m) != 0;
+  }
+}
+
+void StabilizerTableau::cnot(const int c, const int t) {
+  const int wc = c / 64, wt = t / 64;
+  const int bc = c % 64, bt = t % 64;
+  for (int i = 0; i < 2 * nQubits; i++) {
+    auto xi = xRow(i), zi = zRow(i);
+    int xc = (xi[wc] >> bc) & 1, zc = (zi[wc] >> bc) & 1;
+    int xt = (xi[wt] >> bt) & 1, zt = (zi[wt] >> bt) & 1;
+    signs[i] ^= xc & zt & (xt ^ zc ^ 1);
+    xi[wt] ^= std::uint64_t(xc) << bt;
+    zi[wc] ^= std::uint64_t(zt) << bc;
+  }
+}
+
+void StabilizerTableau::cz(const int a, const int b) {
+  const int wa = a / 64, wb = b / 64;
+  const int ba = a % 64, bb = b % 64;
+  for (int i = 0; i < 2 * nQubits; i++) {
+    auto xi = xRow(i), zi = zRow(i);
+    int xa = (xi[wa] >> ba) & 1, za = (zi[wa] >> ba) & 1;
+    int xb = (xi[wb] >> bb) & 1, zb = (zi[wb] >> bb) & 1;
+    signs[i] ^= xa & xb & (za ^ zb);
+    zi[wa] ^= std::uint64_t(xb) << ba;
+    zi[wb] ^= std::uint64_t(xa) << bb;
+  }
+}
+
+void StabilizerTableau::swap(const int a, const int b) {
+  const int wa = a / 64, wb = b / 64;
+  const int ba = a % 64, bb = b % 64;
+  for (int i = 0; i < 2 * nQubits; i++) {
+    for (auto row : {xRow(i), zRow(i)}) {
+      auto d = ((row[wa] >> ba) ^ (row[wb] >> bb)) & 1;
+      row[wa] ^= d << ba;
+      row[wb] ^= d << bb;
+    }
+  }
+}
+
+void StabilizerTableau::rowsum(const int h, const int i) {
+  // The exponent of i picked up by multiplying the Paulis of row i
+  // into those of row h, counted over whole words
+  int phase = 2 * signs[h] + 2 * signs[i];
+  auto x1 = xRow(i), z1 = zRow(i), x2 = xRow(h), z2 = zRow(h);
+  for (int w = 0; w < nWords; w++) {
+    auto a = x1[w], b = z1[w], c = x2[w], d = z2[w];
+    auto plus = (a & b & ~c & d) | (a & ~b & c & d) | (~a & b & c & ~d);
+    auto minus = (a & b & c & ~d) | (a & ~b & ~c & d) | (~a & b & c & d);
+    phase += popcount(plus) - popcount(minus);
+    x2[w] ^= a;
+    z2[w] ^= b;
+  }
+  signs[h] = ((phase % 4) + 4) % 4 == 2;
+}
+
+int StabilizerTableau::measure(const int q, const int randomBit) {
+  const int w = q / 64;
+  const std::uint64_t m = 1ULL << (q % 64);
+
+  int p = -1;
+  for (int i = nQubits; i < 2 * nQubits; i++) {
+    if (xRow(i)[w] & m) {
+      p = i;
+      break;
+    }
+  }
+
+  if (p >= 0) {
+    // A stabilizer anticommutes with Z_q, the outcome is random
+    for (int i = 0; i < 2 * nQubits; i++) {
+      if (i != p && (xRow(i)[w] & m)) {
+        rowsum(i, p);
+      }
+    }
+    std::copy(xRow(p), xRow(p) + nWords, xRow(p - nQubits));
+    std::copy(zRow(p), zRow(p) + nWords, zRow(p - nQubits));
+    signs[p - nQubits] = signs[p];
+    std::fill(xRow(p), xRow(p) + nWords, 0);
+    std::fill(zRow(p), zRow(p) + nWords, 0);
+    zRow(p)[w] = m;
+    signs[p] = randomBit;
+    return randomBit;
+  }
+
+  // Z_q is a product of stabilizers, build it in the scratch row
+  const int scratch = 2 * nQubits;
+  std::fill(xRow(scratch), xRow(scratch) + nWords, 0);
+  std::fill(zRow(scratch), zRow(scratch) + nWords, 0);
+  signs[scratch] = 0;
+  for (int i = 0; i < nQubits; i++) {
+    if (xRow(i)[w] & m) {
+      rowsum(scratch, i + nQubits);
+    }
+  }
+  return signs[scratch];
+}
+
+std::vector<std::vector<std::uint64_t>>
+StabilizerTableau::sample(const int shots, std::mt19937_64 &generator) const {
+  // One reference outcome, measuring a copy with all random bits 0
+  StabilizerTableau reference(*this);
+  std::vector<std::uint64_t> outcome(nWords);
+  for (int q = 0; q < nQubits; q++) {
+    outcome[q / 64] |= std::uint64_t(reference.measure(q, 0)) << (q % 64);
+  }
+
+  // A basis of the X parts of the stabilizers, by Gaussian elimination
+  std::vector<std::vector<std::uint64_t>> basis;
+  std::vector<std::vector<std::uint64_t>> rows;
+  for (int i = nQubits; i < 2 * nQubits; i++) {
+    rows.emplace_back(xs.begin() + i * nWords, xs.begin() + (i + 1) * nWords);
+  }
+  for (int q = 0; q < nQubits && !rows.empty(); q++) {
+    const int w = q / 64;
+    const std::uint64_t m = 1ULL << (q % 64);
+    auto pivot = std::find_if(rows.begin(), rows.end(),
+                              [&](const std::vector<std::uint64_t> &r) {
+                                return (r[w] & m) != 0;
+                              });
+    if (pivot == rows.end()) {
+      continue;
+    }
+    std::swap(*pivot, rows.back());
+    auto v = std::move(rows.back());
+    rows.pop_back();
+    for (auto &r : rows) {
+      if (r[w] & m) {
+        for (int k = 0; k < nWords; k++) {
+          r[k] ^= v[k];
+        }
+      }
+    }
+    basis.push_back(std::move(v));
+  }
+
+  std::vector<std::vector<std::uint64_t>> samples(shots, outcome);
+  for (auto &sample : samples) {
+    std::uint64_t bits = 0;
+    for (int j = 0; j < basis.size(); j++) {
+      if (j % 64 == 0) {
+        bits = generator();
+      }
+      if ((bits >> (j % 64)) & 1) {
+        for (int k = 0; k < nWords; k++) {
+          sample[k] ^= basis[j][k];
+        }
+      }
+    }
+  }
+  return samples;
+}
+
+} // namespace quantum
+} // namespace xacc
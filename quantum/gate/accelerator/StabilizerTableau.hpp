@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STABILIZERTABLEAU_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STABILIZERTABLEAU_HPP_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The StabilizerTableau holds an n qubit stabilizer state as the
+ * Aaronson-Gottesman tableau of n destabilizer and n stabilizer
+ * generators, and applies Clifford gates and measurements to it.
+ *
+ * Each generator is a row of packed X and Z bits and a sign bit, so
+ * gates cost O(n) and measurements O(n^2 / 64) word operations,
+ * which keeps thousands of qubits tractable.
+ */
+class StabilizerTableau {
+
+public:
+  /**
+   * The constructor, creates the state |0...0>.
+   *
+   * @param nQubits The number of qubits
+   */
+  StabilizerTableau(const int nQubits);
+
+  /**
+   * Return the number of qubits.
+   */
+  const int size() const { return nQubits; }
+
+  /**
+   * Reset to the state |0...0>.
+   */
+  void reset();
+
+  void h(const int q);
+  void s(const int q);
+  void sdg(const int q);
+  void x(const int q);
+  void y(const int q);
+  void z(const int q);
+  void cnot(const int c, const int t);
+  void cz(const int a, const int b);
+  void swap(const int a, const int b);
+
+  /**
+   * Measure the given qubit and collapse the state onto the outcome.
+   *
+   * @param q The qubit
+   * @param randomBit The outcome, if it is not determined by the state
+   * @return outcome The measured bit
+   */
+  int measure(const int q, const int randomBit);
+
+  /**
+   * Sample the outcomes of measuring every qubit, leaving this
+   * state unchanged. The outcomes are uniform over an affine space,
+   * spanned by the X parts of the stabilizers, so after one reference
+   * measurement each shot costs O(n^2 / 64) at most.
+   *
+   * @param shots The number of shots
+   * @param generator The source of random bits
+   * @return samples For each shot, the outcomes packed 64 to a word
+   */
+  std::vector<std::vector<std::uint64_t>>
+  sample(const int shots, std::mt19937_64 &generator) const;
+
+protected:
+  int nQubits;
+
+  /**
+   * The words per row.
+   */
+  int nWords;
+
+  /**
+   * The 2n + 1 rows, destabilizers, stabilizers and one scratch row.
+   */
+  std::vector<std::uint64_t> xs;
+  std::vector<std::uint64_t> zs;
+  std::vector<std::uint8_t> signs;
+
+  std::uint64_t *xRow(const int row) { return xs.data() + row * nWords; }
+  std::uint64_t *zRow(const int row) { return zs.data() + row * nWords; }
+
+  /**
+   * Multiply row h by row i, keeping the product in row h.
+   */
+  void rowsum(const int h, const int i);
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STABILIZERVISITOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STABILIZERVISITOR_HPP_
+
+#include "AllGateVisitor.hpp"
+#include "StabilizerTableau.hpp"
+#include "XACC.hpp"
+#include <cmath>
+#include <functional>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The StabilizerVisitor applies each gate it visits to a
+ * StabilizerTableau. Visiting a GateFunction visits its enabled
+ * Instructions in order.
+ *
+ * Rotations and U are accepted at angles that are multiples of pi/2,
+ * CRZ and CPhase at multiples of pi, where they are Clifford. T, Tdg, CH
+ * and all other angles are rejected with an error. Measurements and
+ * ConditionalFunctions are handled as by the StateVectorVisitor.
+ */
+class StabilizerVisitor : public AllGateVisitor {
+
+protected:
+  StabilizerTableau &tableau;
+  std::function<int()> randomBit;
+  bool collapse;
+
+  void nonClifford(Instruction &inst) {
+    xacc::error("The stabilizer simulator cannot apply non-Clifford gate " +
+                inst.toString("q") + ".");
+  }
+
+  // The angle as a multiple of the given unit, mod the given period
+  int steps(Instruction &inst, const int idx, const double unit,
+            const int period) {
+    auto p = inst.getParameter(idx);
+    if (p.isVariable()) {
+      xacc::error("Cannot simulate " + inst.name() +
+                  " with variable parameter " + p.toString() +
+                  ", evaluate the function first.");
+    }
+    double theta = p.which() == 0 ? p.as<int>() : p.as<double>();
+    auto k = std::round(theta / unit);
+    if (std::fabs(theta - k * unit) > 1e-9) {
+      nonClifford(inst);
+    }
+    return ((static_cast<long>(k) % period) + period) % period;
+  }
+
+  int quarterTurns(Instruction &inst, const int idx) {
+    return steps(inst, idx, M_PI / 2.0, 4);
+  }
+
+  // Rz by the given quarter turns, up to a global phase
+  void rz(const int q, const int turns) {
+    if (turns == 1) {
+      tableau.s(q);
+    } else if (turns == 2) {
+      tableau.z(q);
+    } else if (turns == 3) {
+      tableau.sdg(q);
+    }
+  }
+
+  // Ry by the given quarter turns, which is Rz conjugated by S H
+  void ry(const int q, const int turns) {
+    tableau.sdg(q);
+    tableau.h(q);
+    rz(q, turns);
+    tableau.h(q);
+    tableau.s(q);
+  }
+
+public:
+  /**
+   * The classical bits written by collapsing measurements.
+   */
+  std::map<int, int> classicalBits;
+
+  /**
+   * The (qubit, classical bit) pairs of the recorded measurements.
+   */
+  std::vector<std::pair<int, int>> measurements;
+
+  /**
+   * The constructor.
+   *
+   * @param t The tableau to apply gates to
+   * @param r The source of random measurement outcomes
+   * @param collapseOnMeasure If false, Measures are only recorded
+   */
+  StabilizerVisitor(StabilizerTableau &t, std::function<int()> r,
+                    const bool collapseOnMeasure = true)
+      : tableau(t), randomBit(r), collapse(collapseOnMeasure) {}
+
+  void visit(GateFunction &f) override {
+    for (auto &inst : f.getInstructions()) {
+      if (inst->isComposite() || inst->isEnabled()) {
+        inst->accept(this);
+      }
+    }
+  }
+
+  void visit(ConditionalFunction &c) override {
+    auto bit = classicalBits.find(c.getConditionalQubit());
+    if (bit == classicalBits.end() || bit->second != 1) {
+      return;
+    }
+    for (auto &inst : c.getInstructions()) {
+      inst->accept(this);
+    }
+  }
+
+  void visit(Identity &i) override {}
+
+  void visit(Hadamard &h) override { tableau.h(h.bits()[0]); }
+
+  void visit(X &x) override { tableau.x(x.bits()[0]); }
+
+  void visit(Y &y) override { tableau.y(y.bits()[0]); }
+
+  void visit(Z &z) override { tableau.z(z.bits()[0]); }
+
+  void visit(S &s) override { tableau.s(s.bits()[0]); }
+
+  void visit(Sdg &sdg) override { tableau.sdg(sdg.bits()[0]); }
+
+  void visit(T &t) override { nonClifford(t); }
+
+  void visit(Tdg &tdg) override { nonClifford(tdg); }
+
+  void visit(Rx &rx) override {
+    auto q = rx.bits()[0];
+    tableau.h(q);
+    rz(q, quarterTurns(rx, 0));
+    tableau.h(q);
+  }
+
+  void visit(Ry &r) override { ry(r.bits()[0], quarterTurns(r, 0)); }
+
+  void visit(Rz &r) override { rz(r.bits()[0], quarterTurns(r, 0)); }
+
+  void visit(U &u) override {
+    // U(theta, phi, lambda) = Rz(phi) Ry(theta) Rz(lambda), up to phase
+    auto q = u.bits()[0];
+    auto theta = quarterTurns(u, 0), phi = quarterTurns(u, 1),
+         lambda = quarterTurns(u, 2);
+    rz(q, lambda);
+    ry(q, theta);
+    rz(q, phi);
+  }
+
+  void visit(CNOT &cn) override { tableau.cnot(cn.bits()[0], cn.bits()[1]); }
+
+  void visit(CY &cy) override {
+    tableau.sdg(cy.bits()[1]);
+    tableau.cnot(cy.bits()[0], cy.bits()[1]);
+    tableau.s(cy.bits()[1]);
+  }
+
+  void visit(CZ &cz) override { tableau.cz(cz.bits()[0], cz.bits()[1]); }
+
+  void visit(CH &ch) override { nonClifford(ch); }
+
+  void visit(CRZ &crz) override {
+    // CRZ(k pi) = (Sdg on the control, CZ)^k, up to phase
+    auto k = steps(crz, 0, M_PI, 4);
+    for (int i = 0; i < k; i++) {
+      tableau.sdg(crz.bits()[0]);
+      tableau.cz(crz.bits()[0], crz.bits()[1]);
+    }
+  }
+
+  void visit(CPhase &cp) override {
+    if (steps(cp, 0, M_PI, 2) == 1) {
+      tableau.cz(cp.bits()[0], cp.bits()[1]);
+    }
+  }
+
+  void visit(Swap &s) override { tableau.swap(s.bits()[0], s.bits()[1]); }
+
+  void visit(Measure &m) override {
+    auto qubit = m.bits()[0];
+    auto bit = m.getParameter(0).as<int>();
+    measurements.push_back({qubit, bit});
+    if (collapse) {
+      classicalBits[bit] = tableau.measure(qubit, randomBit());
+    }
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
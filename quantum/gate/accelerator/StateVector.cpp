@@ -0,0 +1,373 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "StateVector.hpp"
+#include "XACC.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XACC_STATEVECTOR_AVX2
+#include <immintrin.h>
+#endif
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+
+using Amplitude = StateVector::Amplitude;
+
+// Loops over fewer amplitudes than this stay on one thread
+const std::int64_t parallelThreshold = 1 << 14;
+
+// Insert a 0 bit at position q of i
+inline std::uint64_t insertZero(const std::uint64_t i, const int q) {
+  const std::uint64_t low = i & ((1ULL << q) - 1);
+  return ((i ^ low) << 1) | low;
+}
+
+// Insert 0 bits at positions a and b of i
+inline std::uint64_t insertZeros(const std::uint64_t i, const int a,
+                                 const int b) {
+  return a < b ? insertZero(insertZero(i, a), b)
+               : insertZero(insertZero(i, b), a);
+}
+
+// std::complex operator* checks for infinities, which keeps it from
+// inlining, amplitudes are always finite
+inline Amplitude mul(const Amplitude &a, const Amplitude &b) {
+  return Amplitude(a.real() * b.real() - a.imag() * b.imag(),
+                   a.real() * b.imag() + a.imag() * b.real());
+}
+
+// The nonzero elements of a matrix row by row, those of row r at
+// positions rows[r] to rows[r + 1] of columns and values
+struct SparseMatrix {
+  std::vector<int> rows;
+  std::vector<int> columns;
+  std::vector<Amplitude> values;
+
+  SparseMatrix(const std::vector<Amplitude> &m, const int d) : rows(d + 1) {
+    for (int r = 0; r < d; r++) {
+      for (int c = 0; c < d; c++) {
+        // Products of gates leave rounding errors where they cancel
+        if (std::norm(m[r * d + c]) > 1e-30) {
+          columns.push_back(c);
+          values.push_back(m[r * d + c]);
+        }
+      }
+      rows[r + 1] = columns.size();
+    }
+  }
+};
+
+#ifdef XACC_STATEVECTOR_AVX2
+// Two complex numbers times one broadcast complex number
+__attribute__((target("avx2,fma"))) inline __m256d
+mul(const __m256d a, const __m256d re, const __m256d im) {
+  auto swapped = _mm256_permute_pd(a, 0x5);
+  return _mm256_fmaddsub_pd(a, re, _mm256_mul_pd(swapped, im));
+}
+
+// The apply() kernel for q > 0, two amplitude pairs at a time
+__attribute__((target("avx2,fma"))) void
+applyAVX2(Amplitude *s, const std::int64_t half, const int q,
+          const StateVector::Matrix &m) {
+  __m256d re[4], im[4];
+  for (int k = 0; k < 4; k++) {
+    re[k] = _mm256_set1_pd(m[k].real());
+    im[k] = _mm256_set1_pd(m[k].imag());
+  }
+  const std::uint64_t stride = 1ULL << q;
+#pragma omp parallel for if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i += 2) {
+    auto i0 = insertZero(i, q);
+    auto p0 = reinterpret_cast<double *>(s + i0);
+    auto p1 = reinterpret_cast<double *>(s + i0 + stride);
+    auto a = _mm256_loadu_pd(p0), b = _mm256_loadu_pd(p1);
+    _mm256_storeu_pd(p0, _mm256_add_pd(mul(a, re[0], im[0]),
+                                       mul(b, re[1], im[1])));
+    _mm256_storeu_pd(p1, _mm256_add_pd(mul(a, re[2], im[2]),
+                                       mul(b, re[3], im[3])));
+  }
+}
+
+// The applyMatrix() kernel, two blocks at a time, the second block
+// that of the first with the lowest of the other qubits set. Summing
+// the products with the real and imaginary parts of the elements
+// separately takes two FMAs per element and pair of blocks.
+__attribute__((target("avx2,fma"))) void
+applyMatrixAVX2(Amplitude *s, const std::int64_t blocks, const int k,
+                const int *sorted, const std::uint64_t *offsets,
+                const SparseMatrix &m) {
+  const int d = 1 << k;
+  std::vector<double> re(m.values.size()), im(m.values.size());
+  for (int e = 0; e < m.values.size(); e++) {
+    re[e] = m.values[e].real();
+    im[e] = m.values[e].imag();
+  }
+  auto rows = m.rows.data();
+  auto columns = m.columns.data();
+  int low = 0;
+  while (low < k && sorted[low] == low) {
+    low++;
+  }
+  const std::uint64_t next = 1ULL << low;
+#pragma omp parallel for if ((blocks << k) >= parallelThreshold)
+  for (std::int64_t i = 0; i < blocks; i += 2) {
+    std::uint64_t base = i;
+    for (int t = 0; t < k; t++) {
+      base = insertZero(base, sorted[t]);
+    }
+    __m256d in[1 << StateVector::maxMatrixQubits];
+    __m256d swapped[1 << StateVector::maxMatrixQubits];
+    for (int c = 0; c < d; c++) {
+      auto p = reinterpret_cast<double *>(s + base + offsets[c]);
+      in[c] = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p)),
+                                   _mm_loadu_pd(p + 2 * next), 1);
+      swapped[c] = _mm256_permute_pd(in[c], 0x5);
+    }
+    for (int r = 0; r < d; r++) {
+      auto a = _mm256_setzero_pd(), b = _mm256_setzero_pd();
+      for (int e = rows[r]; e < rows[r + 1]; e++) {
+        a = _mm256_fmadd_pd(in[columns[e]], _mm256_broadcast_sd(&re[e]), a);
+        b = _mm256_fmadd_pd(swapped[columns[e]], _mm256_broadcast_sd(&im[e]),
+                            b);
+      }
+      auto out = _mm256_addsub_pd(a, b);
+      auto p = reinterpret_cast<double *>(s + base + offsets[r]);
+      _mm_storeu_pd(p, _mm256_castpd256_pd128(out));
+      _mm_storeu_pd(p + 2 * next, _mm256_extractf128_pd(out, 1));
+    }
+  }
+}
+
+bool hasAVX2() {
+  static const bool supported =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return supported;
+}
+#endif
+
+} // namespace
+
+StateVector::StateVector(const int n) : nQubits(n) {
+  if (nQubits < 1 || nQubits > 40) {
+    xacc::error("Invalid StateVector size " + std::to_string(nQubits) + ".");
+  }
+  dim = 1ULL << nQubits;
+  state.resize(dim);
+  state[0] = 1.0;
+}
+
+void StateVector::reset() {
+  std::fill(state.begin(), state.end(), Amplitude(0.0));
+  state[0] = 1.0;
+}
+
+void StateVector::apply(const int q, const Matrix &m) {
+  const std::int64_t half = dim / 2;
+  auto s = state.data();
+#ifdef XACC_STATEVECTOR_AVX2
+  if (q > 0 && hasAVX2()) {
+    applyAVX2(s, half, q, m);
+    return;
+  }
+#endif
+  const std::uint64_t stride = 1ULL << q;
+#pragma omp parallel for if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i++) {
+    auto i0 = insertZero(i, q), i1 = i0 | stride;
+    auto a = s[i0], b = s[i1];
+    s[i0] = mul(m[0], a) + mul(m[1], b);
+    s[i1] = mul(m[2], a) + mul(m[3], b);
+  }
+}
+
+void StateVector::applyControlled(const int c, const int t, const Matrix &m) {
+  const std::int64_t quarter = dim / 4;
+  const std::uint64_t control = 1ULL << c, target = 1ULL << t;
+  auto s = state.data();
+#pragma omp parallel for if (quarter >= parallelThreshold)
+  for (std::int64_t i = 0; i < quarter; i++) {
+    auto i0 = insertZeros(i, c, t) | control, i1 = i0 | target;
+    auto a = s[i0], b = s[i1];
+    s[i0] = mul(m[0], a) + mul(m[1], b);
+    s[i1] = mul(m[2], a) + mul(m[3], b);
+  }
+}
+
+void StateVector::applyDiagonal(const int q, const Amplitude d0,
+                                const Amplitude d1) {
+  const std::int64_t half = dim / 2;
+  const std::uint64_t stride = 1ULL << q;
+  auto s = state.data();
+  if (d0 == Amplitude(1.0)) {
+#pragma omp parallel for if (half >= parallelThreshold)
+    for (std::int64_t i = 0; i < half; i++) {
+      auto i1 = insertZero(i, q) | stride;
+      s[i1] = mul(d1, s[i1]);
+    }
+    return;
+  }
+#pragma omp parallel for if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i++) {
+    auto i0 = insertZero(i, q), i1 = i0 | stride;
+    s[i0] = mul(d0, s[i0]);
+    s[i1] = mul(d1, s[i1]);
+  }
+}
+
+void StateVector::applyX(const int q) {
+  const std::int64_t half = dim / 2;
+  const std::uint64_t stride = 1ULL << q;
+  auto s = state.data();
+#pragma omp parallel for if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i++) {
+    auto i0 = insertZero(i, q);
+    std::swap(s[i0], s[i0 | stride]);
+  }
+}
+
+void StateVector::applyCNOT(const int c, const int t) {
+  const std::int64_t quarter = dim / 4;
+  const std::uint64_t control = 1ULL << c, target = 1ULL << t;
+  auto s = state.data();
+#pragma omp parallel for if (quarter >= parallelThreshold)
+  for (std::int64_t i = 0; i < quarter; i++) {
+    auto i0 = insertZeros(i, c, t) | control;
+    std::swap(s[i0], s[i0 | target]);
+  }
+}
+
+void StateVector::applySwap(const int a, const int b) {
+  const std::int64_t quarter = dim / 4;
+  const std::uint64_t bitA = 1ULL << a, bitB = 1ULL << b;
+  auto s = state.data();
+#pragma omp parallel for if (quarter >= parallelThreshold)
+  for (std::int64_t i = 0; i < quarter; i++) {
+    auto i0 = insertZeros(i, a, b);
+    std::swap(s[i0 | bitA], s[i0 | bitB]);
+  }
+}
+
+void StateVector::applyMatrix(const std::vector<int> &qubits,
+                              const std::vector<Amplitude> &m) {
+  const int k = qubits.size(), d = 1 << k;
+  if (k < 1 || k > maxMatrixQubits || m.size() != d * d) {
+    xacc::error("Invalid " + std::to_string(k) + " qubit matrix of size " +
+                std::to_string(m.size()) + ".");
+  }
+
+  // The offset of each of the 2^k amplitudes a block of the matrix
+  // mixes, from the index with all of the qubits 0
+  std::uint64_t offsets[1 << maxMatrixQubits] = {};
+  for (int j = 0; j < d; j++) {
+    for (int t = 0; t < k; t++) {
+      if ((j >> t) & 1) {
+        offsets[j] |= 1ULL << qubits[t];
+      }
+    }
+  }
+  int sorted[maxMatrixQubits];
+  std::copy(qubits.begin(), qubits.end(), sorted);
+  std::sort(sorted, sorted + k);
+
+  const SparseMatrix sparse(m, d);
+  const std::int64_t blocks = dim >> k;
+  auto s = state.data();
+#ifdef XACC_STATEVECTOR_AVX2
+  if (blocks >= 2 && hasAVX2()) {
+    applyMatrixAVX2(s, blocks, k, sorted, offsets, sparse);
+    return;
+  }
+#endif
+#pragma omp parallel for if ((blocks << k) >= parallelThreshold)
+  for (std::int64_t i = 0; i < blocks; i++) {
+    std::uint64_t base = i;
+    for (int t = 0; t < k; t++) {
+      base = insertZero(base, sorted[t]);
+    }
+    Amplitude in[1 << maxMatrixQubits];
+    for (int c = 0; c < d; c++) {
+      in[c] = s[base + offsets[c]];
+    }
+    for (int r = 0; r < d; r++) {
+      Amplitude out = 0.0;
+      for (int e = sparse.rows[r]; e < sparse.rows[r + 1]; e++) {
+        out += mul(sparse.values[e], in[sparse.columns[e]]);
+      }
+      s[base + offsets[r]] = out;
+    }
+  }
+}
+
+double StateVector::probability(const int q) const {
+  const std::int64_t half = dim / 2;
+  const std::uint64_t stride = 1ULL << q;
+  auto s = state.data();
+  double p = 0.0;
+#pragma omp parallel for reduction(+ : p) if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i++) {
+    p += std::norm(s[insertZero(i, q) | stride]);
+  }
+  return p;
+}
+
+int StateVector::measure(const int q, const double r) {
+  const auto p1 = probability(q);
+  const int outcome = r < p1 ? 1 : 0;
+  const double scale = 1.0 / std::sqrt(outcome ? p1 : 1.0 - p1);
+  const std::int64_t half = dim / 2;
+  const std::uint64_t stride = 1ULL << q;
+  auto s = state.data();
+#pragma omp parallel for if (half >= parallelThreshold)
+  for (std::int64_t i = 0; i < half; i++) {
+    auto i0 = insertZero(i, q), i1 = i0 | stride;
+    s[outcome ? i0 : i1] = 0.0;
+    s[outcome ? i1 : i0] *= scale;
+  }
+  return outcome;
+}
+
+std::vector<double> StateVector::probabilities() const {
+  std::vector<double> probs(dim);
+  const std::int64_t n = dim;
+  auto s = state.data();
+#pragma omp parallel for if (n >= parallelThreshold)
+  for (std::int64_t i = 0; i < n; i++) {
+    probs[i] = std::norm(s[i]);
+  }
+  return probs;
+}
+
+double StateVector::expectationZ(const std::uint64_t mask) const {
+  const std::int64_t n = dim;
+  auto s = state.data();
+  double expVal = 0.0;
+#pragma omp parallel for reduction(+ : expVal) if (n >= parallelThreshold)
+  for (std::int64_t i = 0; i < n; i++) {
+    std::uint64_t parity = i & mask;
+    parity ^= parity >> 32;
+    parity ^= parity >> 16;
+    parity ^= parity >> 8;
+    parity ^= parity >> 4;
+    parity ^= parity >> 2;
+    parity ^= parity >> 1;
+    expVal += (parity & 1) ? -std::norm(s[i]) : std::norm(s[i]);
+  }
+  return expVal;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STATEVECTOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STATEVECTOR_HPP_
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The StateVector holds the 2^n complex amplitudes of an n qubit
+ * pure state, qubit q being bit q of the basis state index, and
+ * applies one and two qubit gates to it in place.
+ *
+ * Gate kernels are parallelized with OpenMP when it is enabled, for
+ * states large enough to amortize the threads, and use AVX2 when the
+ * host CPU supports it, checked once at runtime.
+ */
+class StateVector {
+
+public:
+  using Amplitude = std::complex<double>;
+
+  /**
+   * A 2x2 gate matrix in row major order.
+   */
+  using Matrix = std::array<Amplitude, 4>;
+
+  /**
+   * The most qubits applyMatrix() accepts.
+   */
+  static const int maxMatrixQubits = 5;
+
+  /**
+   * The constructor, creates the state |0...0>.
+   *
+   * @param nQubits The number of qubits
+   */
+  StateVector(const int nQubits);
+
+  /**
+   * Return the number of qubits.
+   */
+  const int size() const { return nQubits; }
+
+  /**
+   * Return the amplitudes.
+   */
+  const std::vector<Amplitude> &amplitudes() const { return state; }
+
+  /**
+   * Reset to the state |0...0>.
+   */
+  void reset();
+
+  /**
+   * Apply the given 2x2 matrix to the given qubit.
+   *
+   * @param q The qubit
+   * @param m The gate matrix
+   */
+  void apply(const int q, const Matrix &m);
+
+  /**
+   * Apply the given 2x2 matrix to the target qubit on the
+   * states where the control qubit is 1.
+   *
+   * @param c The control qubit
+   * @param t The target qubit
+   * @param m The gate matrix
+   */
+  void applyControlled(const int c, const int t, const Matrix &m);
+
+  /**
+   * Multiply the |0> and |1> amplitudes of the given qubit by the given
+   * phases, cheaper than apply() for diagonal gates.
+   *
+   * @param q The qubit
+   * @param d0 The |0> phase
+   * @param d1 The |1> phase
+   */
+  void applyDiagonal(const int q, const Amplitude d0, const Amplitude d1);
+
+  /**
+   * Flip the given qubit.
+   *
+   * @param q The qubit
+   */
+  void applyX(const int q);
+
+  /**
+   * Flip the target qubit on the states where the control qubit is 1.
+   *
+   * @param c The control qubit
+   * @param t The target qubit
+   */
+  void applyCNOT(const int c, const int t);
+
+  /**
+   * Exchange the given qubits.
+   *
+   * @param a The first qubit
+   * @param b The second qubit
+   */
+  void applySwap(const int a, const int b);
+
+  /**
+   * Apply the given 2^k x 2^k matrix to the given k qubits in one pass
+   * over the amplitudes, bit t of its row and column indices being
+   * qubit qubits[t]. Zero elements are skipped, so that products of
+   * diagonal and permutation gates cost little more than one gate.
+   *
+   * @param qubits The distinct qubits, at most maxMatrixQubits
+   * @param m The matrix in row major order
+   */
+  void applyMatrix(const std::vector<int> &qubits,
+                   const std::vector<Amplitude> &m);
+
+  /**
+   * Return the probability of measuring 1 on the given qubit.
+   *
+   * @param q The qubit
+   * @return p The probability
+   */
+  double probability(const int q) const;
+
+  /**
+   * Measure the given qubit and collapse the state onto the outcome.
+   *
+   * @param q The qubit
+   * @param r A uniform random number in [0,1)
+   * @return outcome The measured bit
+   */
+  int measure(const int q, const double r);
+
+  /**
+   * Return the probabilities of all basis states.
+   */
+  std::vector<double> probabilities() const;
+
+  /**
+   * Return the exact expectation value of the product of
+   * Pauli-Z on the given qubits.
+   *
+   * @param mask The qubits, bit q set for qubit q
+   * @return expVal The expectation value
+   */
+  double expectationZ(const std::uint64_t mask) const;
+
+protected:
+  int nQubits;
+  std::uint64_t dim;
+  std::vector<Amplitude> state;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
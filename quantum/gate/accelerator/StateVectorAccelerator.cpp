@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "StateVectorAccelerator.hpp"
+#include "FusedStateVectorVisitor.hpp"
+#include "CircuitScan.hpp"
+#include "AliasSampler.hpp"
+#include <random>
+
+namespace xacc {
+namespace quantum {
+
+std::shared_ptr<AcceleratorBuffer>
+StateVectorAccelerator::createBuffer(const std::string &varId) {
+  return createBuffer(varId, 30);
+}
+
+std::shared_ptr<AcceleratorBuffer>
+StateVectorAccelerator::createBuffer(const std::string &varId,
+                                     const int size) {
+  if (!isValidBufferSize(size)) {
+    xacc::error("Invalid buffer size.");
+  }
+
+  auto buffer = std::make_shared<AcceleratorBuffer>(varId, size);
+  storeBuffer(varId, buffer);
+  return buffer;
+}
+
+void StateVectorAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::shared_ptr<Function> function) {
+  const int shots = xacc::optionExists("statevector-shots")
+                        ? std::stoi(xacc::getOption("statevector-shots"))
+                        : 1024;
+  std::mt19937_64 generator(
+      xacc::optionExists("statevector-seed")
+          ? std::stoull(xacc::getOption("statevector-seed"))
+          : std::random_device()());
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  auto random = [&]() { return distribution(generator); };
+
+  CircuitScan s(function);
+  StateVector state(s.nQubits());
+
+  // Building a block of k qubits costs about as much as a gate on 2^(2k)
+  // amplitudes, so by default only states larger than that are fused
+  const int maxFusion = StateVector::maxMatrixQubits;
+  const int fusion =
+      xacc::optionExists("statevector-fusion")
+          ? std::stoi(xacc::getOption("statevector-fusion"))
+          : (s.nQubits() > 2 * maxFusion ? maxFusion : 0);
+  if (fusion != 0 && (fusion < 2 || fusion > maxFusion)) {
+    xacc::error("Invalid statevector-fusion " + std::to_string(fusion) +
+                ", it must be 0 or between 2 and " +
+                std::to_string(maxFusion) + ".");
+  }
+  auto makeVisitor = [&](const bool collapse) {
+    return std::shared_ptr<StateVectorVisitor>(
+        fusion ? new FusedStateVectorVisitor(state, random, fusion, collapse)
+               : new StateVectorVisitor(state, random, collapse));
+  };
+
+  std::map<std::string, int> counts;
+  if (s.terminal) {
+    auto visitor = makeVisitor(false);
+    function->accept(visitor.get());
+    if (visitor->measurements.empty()) {
+      return;
+    }
+
+    if (xacc::optionExists("statevector-exact")) {
+      std::uint64_t mask = 0;
+      for (auto &m : visitor->measurements) {
+        mask |= 1ULL << m.first;
+      }
+      buffer->setExpectationValueZ(state.expectationZ(mask));
+      return;
+    }
+
+    AliasSampler sampler(state.probabilities());
+    auto histogram = sampler.histogram(shots, generator);
+    for (std::uint64_t idx = 0; idx < histogram.size(); idx++) {
+      if (histogram[idx] == 0) {
+        continue;
+      }
+      std::map<int, int> bits;
+      for (auto &m : visitor->measurements) {
+        bits[m.second] = (idx >> m.first) & 1;
+      }
+      counts[s.bitString(buffer->size(),
+                         [&](const int i) { return bits[i]; })] +=
+          histogram[idx];
+    }
+  } else {
+    if (xacc::optionExists("statevector-exact")) {
+      xacc::info("Function " + function->name() + " has mid-circuit "
+                 "measurements, sampling instead of computing the exact "
+                 "expectation value.");
+    }
+    for (int shot = 0; shot < shots; shot++) {
+      state.reset();
+      auto visitor = makeVisitor(true);
+      function->accept(visitor.get());
+      counts[s.bitString(buffer->size(), [&](const int i) {
+        return visitor->classicalBits[i];
+      })]++;
+    }
+  }
+
+  buffer->appendMeasurements(counts);
+}
+
+std::vector<std::shared_ptr<AcceleratorBuffer>>
+StateVectorAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::vector<std::shared_ptr<Function>> functions) {
+  int counter = 0;
+  std::vector<std::shared_ptr<AcceleratorBuffer>> tmpBuffers;
+  for (auto f : functions) {
+    auto tmpBuffer = createBuffer(buffer->name() + std::to_string(counter),
+                                  buffer->size());
+    execute(tmpBuffer, f);
+    tmpBuffers.push_back(tmpBuffer);
+    counter++;
+  }
+
+  return tmpBuffers;
+}
+
+} // namespace quantum
+} // namespace xacc
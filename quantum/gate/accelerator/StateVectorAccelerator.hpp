@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STATEVECTORACCELERATOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STATEVECTORACCELERATOR_HPP_
+
+#include "Accelerator.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The StateVectorAccelerator simulates gate model Functions exactly on
+ * a local StateVector, and fills the AcceleratorBuffer with the
+ * measurement counts of the requested number of shots.
+ *
+ * Only the qubits up to the largest one the Function uses are
+ * simulated. When no gate follows a measurement and there are no
+ * ConditionalFunctions, the Function is simulated once and all shots
+ * are sampled from the final state, otherwise it is simulated once per
+ * shot. Bit strings hold classical bit 0 rightmost.
+ *
+ * With the statevector-exact option, Functions whose measurements are
+ * all at the end are simulated once and the exact expectation value of
+ * Z on the measured qubits is stored in the AcceleratorBuffer instead
+ * of counts, free of sampling noise.
+ *
+ * Runs of consecutive gates on at most k qubits are fused into dense
+ * matrices, each applied in one pass over the state, k being 5 by
+ * default for states of more than 10 qubits and set with the
+ * statevector-fusion option, 0 to apply each gate on its own.
+ */
+class StateVectorAccelerator : public Accelerator {
+public:
+  void initialize() override {}
+
+  AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
+
+  std::vector<std::shared_ptr<IRTransformation>>
+  getIRTransformations() override {
+    return {};
+  }
+
+  std::shared_ptr<AcceleratorBuffer>
+  createBuffer(const std::string &varId) override;
+
+  std::shared_ptr<AcceleratorBuffer> createBuffer(const std::string &varId,
+                                                  const int size) override;
+
+  bool isValidBufferSize(const int NBits) override {
+    return NBits > 0 && NBits <= 40;
+  }
+
+  void execute(std::shared_ptr<AcceleratorBuffer> buffer,
+               const std::shared_ptr<Function> function) override;
+
+  std::vector<std::shared_ptr<AcceleratorBuffer>>
+  execute(std::shared_ptr<AcceleratorBuffer> buffer,
+          const std::vector<std::shared_ptr<Function>> functions) override;
+
+  OptionPairs getOptions() override {
+    return OptionPairs{
+        {"statevector-shots",
+         "The number of shots to sample, 1024 by default."},
+        {"statevector-seed", "The seed of the measurement outcomes."},
+        {"statevector-exact",
+         "Compute exact expectation values of Z instead of sampling."},
+        {"statevector-fusion",
+         "Fuse runs of gates on at most this many qubits, between 2 and 5, "
+         "0 disables fusion."}};
+  }
+
+  const std::string name() const override { return "statevector"; }
+
+  const std::string description() const override {
+    return "The StateVector Accelerator simulates XACC quantum IR "
+           "on a local multithreaded state vector.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_STATEVECTORVISITOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_STATEVECTORVISITOR_HPP_
+
+#include "AllGateVisitor.hpp"
+#include "StateVector.hpp"
+#include "XACC.hpp"
+#include <cmath>
+#include <functional>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The BasicStateVectorVisitor applies each gate it visits to a state
+ * with the gate interface of the StateVector, such as the StateVector
+ * itself or the MatrixProductState. Visiting a GateFunction visits its
+ * enabled Instructions in order.
+ *
+ * Measurements either collapse the state, with outcomes drawn from the
+ * given random number source and kept as classical bits that
+ * ConditionalFunctions read, or are only recorded, leaving the state
+ * to be sampled once the whole Function has been visited.
+ */
+template <typename State>
+class BasicStateVectorVisitor : public AllGateVisitor {
+
+protected:
+  using Amplitude = typename State::Amplitude;
+  using Matrix = typename State::Matrix;
+
+  State &state;
+  std::function<double()> random;
+  bool collapse;
+
+  double angle(Instruction &inst, const int idx) {
+    auto p = inst.getParameter(idx);
+    if (p.isVariable()) {
+      xacc::error("Cannot simulate " + inst.name() +
+                  " with variable parameter " + p.toString() +
+                  ", evaluate the function first.");
+    }
+    return p.which() == 0 ? p.as<int>() : p.as<double>();
+  }
+
+  static Matrix rz(const double theta) {
+    return {std::polar(1.0, -theta / 2.0), 0.0, 0.0,
+            std::polar(1.0, theta / 2.0)};
+  }
+
+  static Matrix hadamard() {
+    const double r = 1.0 / std::sqrt(2.0);
+    return {r, r, r, -r};
+  }
+
+  static Matrix pauliY() {
+    const Amplitude i(0.0, 1.0);
+    return {0.0, -i, i, 0.0};
+  }
+
+  static Matrix phase(const Amplitude d1) {
+    return {1.0, 0.0, 0.0, d1};
+  }
+
+public:
+  /**
+   * The classical bits written by collapsing measurements.
+   */
+  std::map<int, int> classicalBits;
+
+  /**
+   * The (qubit, classical bit) pairs of the recorded measurements.
+   */
+  std::vector<std::pair<int, int>> measurements;
+
+  /**
+   * The constructor.
+   *
+   * @param s The state to apply gates to
+   * @param r The source of uniform random numbers in [0,1)
+   * @param collapseOnMeasure If false, Measures are only recorded
+   */
+  BasicStateVectorVisitor(State &s, std::function<double()> r,
+                          const bool collapseOnMeasure = true)
+      : state(s), random(r), collapse(collapseOnMeasure) {}
+
+  void visit(GateFunction &f) override {
+    for (auto &inst : f.getInstructions()) {
+      if (inst->isComposite() || inst->isEnabled()) {
+        inst->accept(this);
+      }
+    }
+  }
+
+  void visit(ConditionalFunction &c) override {
+    // Children are disabled until their condition holds, as in
+    // ConditionalFunction::evaluate(), which we do not call so
+    // that the IR is left unchanged for the next shot
+    auto bit = classicalBits.find(c.getConditionalQubit());
+    if (bit == classicalBits.end() || bit->second != 1) {
+      return;
+    }
+    for (auto &inst : c.getInstructions()) {
+      inst->accept(this);
+    }
+  }
+
+  void visit(Identity &i) override {}
+
+  void visit(Hadamard &h) override { state.apply(h.bits()[0], hadamard()); }
+
+  void visit(X &x) override { state.applyX(x.bits()[0]); }
+
+  void visit(Y &y) override { state.apply(y.bits()[0], pauliY()); }
+
+  void visit(Z &z) override { state.applyDiagonal(z.bits()[0], 1.0, -1.0); }
+
+  void visit(S &s) override {
+    state.applyDiagonal(s.bits()[0], 1.0, Amplitude(0.0, 1.0));
+  }
+
+  void visit(Sdg &sdg) override {
+    state.applyDiagonal(sdg.bits()[0], 1.0, Amplitude(0.0, -1.0));
+  }
+
+  void visit(T &t) override {
+    state.applyDiagonal(t.bits()[0], 1.0, std::polar(1.0, M_PI / 4.0));
+  }
+
+  void visit(Tdg &tdg) override {
+    state.applyDiagonal(tdg.bits()[0], 1.0, std::polar(1.0, -M_PI / 4.0));
+  }
+
+  void visit(Rx &rx) override {
+    auto theta = angle(rx, 0);
+    const Amplitude c = std::cos(theta / 2.0), s(0.0, -std::sin(theta / 2.0));
+    state.apply(rx.bits()[0], {c, s, s, c});
+  }
+
+  void visit(Ry &ry) override {
+    auto theta = angle(ry, 0);
+    const double c = std::cos(theta / 2.0), s = std::sin(theta / 2.0);
+    state.apply(ry.bits()[0], {c, -s, s, c});
+  }
+
+  void visit(Rz &r) override {
+    auto theta = angle(r, 0);
+    state.applyDiagonal(r.bits()[0], std::polar(1.0, -theta / 2.0),
+                        std::polar(1.0, theta / 2.0));
+  }
+
+  void visit(U &u) override {
+    auto theta = angle(u, 0), phi = angle(u, 1), lambda = angle(u, 2);
+    const double c = std::cos(theta / 2.0), s = std::sin(theta / 2.0);
+    state.apply(u.bits()[0],
+                {c, -std::polar(s, lambda), std::polar(s, phi),
+                 std::polar(c, phi + lambda)});
+  }
+
+  void visit(CNOT &cn) override {
+    state.applyCNOT(cn.bits()[0], cn.bits()[1]);
+  }
+
+  void visit(CY &cy) override {
+    state.applyControlled(cy.bits()[0], cy.bits()[1], pauliY());
+  }
+
+  void visit(CZ &cz) override {
+    state.applyControlled(cz.bits()[0], cz.bits()[1], phase(-1.0));
+  }
+
+  void visit(CH &ch) override {
+    state.applyControlled(ch.bits()[0], ch.bits()[1], hadamard());
+  }
+
+  void visit(CRZ &crz) override {
+    state.applyControlled(crz.bits()[0], crz.bits()[1], rz(angle(crz, 0)));
+  }
+
+  void visit(CPhase &cp) override {
+    state.applyControlled(cp.bits()[0], cp.bits()[1],
+                          phase(std::polar(1.0, angle(cp, 0))));
+  }
+
+  void visit(Swap &s) override { state.applySwap(s.bits()[0], s.bits()[1]); }
+
+  void visit(Measure &m) override {
+    auto qubit = m.bits()[0];
+    auto bit = m.getParameter(0).as<int>();
+    measurements.push_back({qubit, bit});
+    if (collapse) {
+      classicalBits[bit] = state.measure(qubit, random());
+    }
+  }
+};
+
+/**
+ * The StateVectorVisitor applies gates to a StateVector.
+ */
+using StateVectorVisitor = BasicStateVectorVisitor<StateVector>;
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
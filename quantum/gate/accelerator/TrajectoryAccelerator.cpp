@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "TrajectoryAccelerator.hpp"
+#include "NoisyStateVectorVisitor.hpp"
+#include "CircuitScan.hpp"
+#include <fstream>
+#include <random>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+// Below this many qubits the StateVector kernels run serially,
+// so the trajectories themselves are run in parallel
+const int parallelQubits = 15;
+} // namespace
+
+void TrajectoryAccelerator::loadCalibration() {
+  if (!xacc::optionExists("trajectory-calibration")) {
+    if (!calibrationFile.empty()) {
+      model = NoiseModel();
+      calibrationFile.clear();
+    }
+    return;
+  }
+
+  auto fileName = xacc::getOption("trajectory-calibration");
+  if (fileName == calibrationFile) {
+    return;
+  }
+
+  std::ifstream t(fileName);
+  std::string json((std::istreambuf_iterator<char>(t)),
+                   std::istreambuf_iterator<char>());
+  if (json.empty()) {
+    xacc::error("Invalid calibration JSON file: " + fileName);
+  }
+  model.load(json);
+  calibrationFile = fileName;
+}
+
+const std::vector<double> TrajectoryAccelerator::getOneBitErrorRates() {
+  loadCalibration();
+  return model.oneBitErrorRates();
+}
+
+const std::vector<std::pair<std::pair<int, int>, double>>
+TrajectoryAccelerator::getTwoBitErrorRates() {
+  loadCalibration();
+  return model.twoBitErrorRates();
+}
+
+std::shared_ptr<AcceleratorBuffer>
+TrajectoryAccelerator::createBuffer(const std::string &varId) {
+  return createBuffer(varId, 20);
+}
+
+std::shared_ptr<AcceleratorBuffer>
+TrajectoryAccelerator::createBuffer(const std::string &varId,
+                                    const int size) {
+  if (!isValidBufferSize(size)) {
+    xacc::error("Invalid buffer size.");
+  }
+
+  auto buffer = std::make_shared<AcceleratorBuffer>(varId, size);
+  storeBuffer(varId, buffer);
+  return buffer;
+}
+
+void TrajectoryAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::shared_ptr<Function> function) {
+  loadCalibration();
+  const int shots = xacc::optionExists("trajectory-shots")
+                        ? std::stoi(xacc::getOption("trajectory-shots"))
+                        : 1024;
+  const std::uint64_t seed =
+      xacc::optionExists("trajectory-seed")
+          ? std::stoull(xacc::getOption("trajectory-seed"))
+          : std::random_device()();
+
+  CircuitScan s(function);
+  if (s.measured.empty() || shots < 1) {
+    return;
+  }
+
+  std::vector<std::string> bitStrings(shots);
+  auto trajectory = [&](StateVector &state, const int shot) {
+    std::mt19937_64 generator(seed + shot);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    state.reset();
+    NoisyStateVectorVisitor visitor(
+        state, [&]() { return distribution(generator); }, model);
+    function->accept(&visitor);
+    bitStrings[shot] = s.bitString(buffer->size(), [&](const int i) {
+      return visitor.classicalBits[i];
+    });
+  };
+
+  // The first trajectory runs on this thread, so that errors in
+  // the Function are raised here and not on a worker
+  StateVector first(s.nQubits());
+  trajectory(first, 0);
+
+#pragma omp parallel if (s.nQubits() < parallelQubits)
+  {
+    StateVector state(s.nQubits());
+#pragma omp for schedule(dynamic, 16)
+    for (int shot = 1; shot < shots; shot++) {
+      trajectory(state, shot);
+    }
+  }
+
+  std::map<std::string, int> counts;
+  for (auto &b : bitStrings) {
+    counts[b]++;
+  }
+  buffer->appendMeasurements(counts);
+
+  buffer->addExtraInfo("readoutErrors", model.readoutErrorRates());
+  buffer->addExtraInfo("gateErrors", model.oneBitErrorRates());
+  buffer->addExtraInfo("multiQubitGates", model.twoBitGates());
+  buffer->addExtraInfo("multiQubitGateErrors", model.twoBitGateErrors());
+}
+
+std::vector<std::shared_ptr<AcceleratorBuffer>>
+TrajectoryAccelerator::execute(
+    std::shared_ptr<AcceleratorBuffer> buffer,
+    const std::vector<std::shared_ptr<Function>> functions) {
+  int counter = 0;
+  std::vector<std::shared_ptr<AcceleratorBuffer>> tmpBuffers;
+  for (auto f : functions) {
+    auto tmpBuffer = createBuffer(buffer->name() + std::to_string(counter),
+                                  buffer->size());
+    execute(tmpBuffer, f);
+    tmpBuffers.push_back(tmpBuffer);
+    counter++;
+  }
+
+  return tmpBuffers;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_ACCELERATOR_TRAJECTORYACCELERATOR_HPP_
+#define QUANTUM_GATE_ACCELERATOR_TRAJECTORYACCELERATOR_HPP_
+
+#include "Accelerator.hpp"
+#include "NoiseModel.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The TrajectoryAccelerator simulates gate model Functions under
+ * depolarizing gate noise and readout noise, as one Monte-Carlo
+ * trajectory of a local StateVector per shot. The error rates are read
+ * from the backend calibration JSON file given by the
+ * trajectory-calibration option, and are reported through
+ * getOneBitErrorRates() and getTwoBitErrorRates() and in the buffer's
+ * ExtraInfo, as the IBMAccelerator does, so error mitigation
+ * decorators can be exercised offline.
+ *
+ * Trajectories run in parallel when the state is small enough that
+ * the StateVector kernels themselves run serially. Each trajectory is
+ * seeded from trajectory-seed and its index, so results do not depend
+ * on the number of threads.
+ */
+class TrajectoryAccelerator : public Accelerator {
+
+protected:
+  NoiseModel model;
+
+  /**
+   * The calibration file the model was loaded from.
+   */
+  std::string calibrationFile;
+
+  void loadCalibration();
+
+public:
+  void initialize() override { loadCalibration(); }
+
+  AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
+
+  std::vector<std::shared_ptr<IRTransformation>>
+  getIRTransformations() override {
+    return {};
+  }
+
+  const std::vector<double> getOneBitErrorRates() override;
+
+  const std::vector<std::pair<std::pair<int, int>, double>>
+  getTwoBitErrorRates() override;
+
+  std::shared_ptr<AcceleratorBuffer>
+  createBuffer(const std::string &varId) override;
+
+  std::shared_ptr<AcceleratorBuffer> createBuffer(const std::string &varId,
+                                                  const int size) override;
+
+  bool isValidBufferSize(const int NBits) override {
+    return NBits > 0 && NBits <= 40;
+  }
+
+  void execute(std::shared_ptr<AcceleratorBuffer> buffer,
+               const std::shared_ptr<Function> function) override;
+
+  std::vector<std::shared_ptr<AcceleratorBuffer>>
+  execute(std::shared_ptr<AcceleratorBuffer> buffer,
+          const std::vector<std::shared_ptr<Function>> functions) override;
+
+  OptionPairs getOptions() override {
+    return OptionPairs{
+        {"trajectory-calibration",
+         "The backend calibration JSON file of the error rates, "
+         "noiseless if not given."},
+        {"trajectory-shots",
+         "The number of trajectories to sample, 1024 by default."},
+        {"trajectory-seed", "The seed of the noise and measurements."}};
+  }
+
+  const std::string name() const override { return "trajectory"; }
+
+  const std::string description() const override {
+    return "The Trajectory Accelerator simulates XACC quantum IR under "
+           "calibrated depolarizing and readout noise.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
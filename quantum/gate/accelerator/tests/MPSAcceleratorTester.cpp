@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "MPSAccelerator.hpp"
+#include "MatrixProductState.hpp"
+#include "StateVectorVisitor.hpp"
+#include <chrono>
+#include <random>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+using MPSVisitor = BasicStateVectorVisitor<MatrixProductState>;
+
+std::shared_ptr<GateFunction> circuit(std::vector<InstPtr> gates) {
+  auto f = std::make_shared<GateFunction>("foo");
+  for (auto &g : gates) {
+    f->addInstruction(g);
+  }
+  return f;
+}
+
+InstPtr crz(const int control, const int target, const double theta) {
+  auto gate = std::make_shared<CRZ>(std::vector<int>{control, target});
+  InstructionParameter angle(theta);
+  gate->setParameter(0, angle);
+  return gate;
+}
+
+// Random gates of every kind, two qubit gates on any pair
+std::shared_ptr<GateFunction> randomCircuit(const int n, const int nGates,
+                                            std::mt19937 &gen) {
+  std::uniform_int_distribution<int> gate(0, 19), qubit(0, n - 1);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::vector<InstPtr> gates;
+  for (int i = 0; i < nGates; i++) {
+    auto a = qubit(gen), b = (a + 1 + qubit(gen) % (n - 1)) % n;
+    switch (gate(gen)) {
+    case 0: gates.push_back(std::make_shared<Identity>(a)); break;
+    case 1: gates.push_back(std::make_shared<Hadamard>(a)); break;
+    case 2: gates.push_back(std::make_shared<X>(a)); break;
+    case 3: gates.push_back(std::make_shared<Y>(a)); break;
+    case 4: gates.push_back(std::make_shared<Z>(a)); break;
+    case 5: gates.push_back(std::make_shared<S>(a)); break;
+    case 6: gates.push_back(std::make_shared<Sdg>(a)); break;
+    case 7: gates.push_back(std::make_shared<T>(a)); break;
+    case 8: gates.push_back(std::make_shared<Tdg>(a)); break;
+    case 9: gates.push_back(std::make_shared<Rx>(a, angle(gen))); break;
+    case 10: gates.push_back(std::make_shared<Ry>(a, angle(gen))); break;
+    case 11: gates.push_back(std::make_shared<Rz>(a, angle(gen))); break;
+    case 12:
+      gates.push_back(
+          std::make_shared<U>(a, angle(gen), angle(gen), angle(gen)));
+      break;
+    case 13: gates.push_back(std::make_shared<CNOT>(a, b)); break;
+    case 14: gates.push_back(std::make_shared<CY>(a, b)); break;
+    case 15: gates.push_back(std::make_shared<CZ>(a, b)); break;
+    case 16: gates.push_back(std::make_shared<CH>(a, b)); break;
+    case 17: gates.push_back(crz(a, b, angle(gen))); break;
+    case 18:
+      gates.push_back(std::make_shared<CPhase>(a, b, angle(gen)));
+      break;
+    default: gates.push_back(std::make_shared<Swap>(a, b));
+    }
+  }
+  return circuit(gates);
+}
+
+// Layers of Ry on every qubit followed by a CNOT ladder
+std::shared_ptr<GateFunction> ansatz(const int n, const int depth) {
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::vector<InstPtr> gates;
+  for (int layer = 0; layer < depth; layer++) {
+    for (int q = 0; q < n; q++) {
+      gates.push_back(std::make_shared<Ry>(q, angle(gen)));
+    }
+    for (int q = 0; q < n - 1; q++) {
+      gates.push_back(std::make_shared<CNOT>(q, q + 1));
+    }
+  }
+  return circuit(gates);
+}
+
+double overlap(const std::vector<StateVector::Amplitude> &a,
+               const std::vector<MatrixProductState::Amplitude> &b) {
+  StateVector::Amplitude o = 0.0;
+  for (int i = 0; i < a.size(); i++) {
+    o += std::conj(a[i]) * b[i];
+  }
+  return std::abs(o);
+}
+
+TEST(MPSAcceleratorTester, checkAgainstStateVector) {
+  auto r = []() { return 0.5; };
+  std::mt19937 gen(29);
+  for (int trial = 0; trial < 10; trial++) {
+    auto f = randomCircuit(6, 60, gen);
+    StateVector expected(6);
+    StateVectorVisitor svVisitor(expected, r);
+    f->accept(&svVisitor);
+
+    MatrixProductState state(6);
+    MPSVisitor visitor(state, r);
+    f->accept(&visitor);
+    EXPECT_NEAR(1.0, overlap(expected.amplitudes(), state.amplitudes()),
+                1e-10);
+    EXPECT_NEAR(0.0, state.truncationError(), 1e-12);
+  }
+
+  // Collapsing measurements agree too
+  auto f = randomCircuit(5, 30, gen);
+  f->addInstruction(std::make_shared<Measure>(1, 0));
+  f->addInstruction(std::make_shared<Hadamard>(1));
+  f->addInstruction(std::make_shared<Measure>(3, 1));
+  StateVector expected(5);
+  StateVectorVisitor svVisitor(expected, r);
+  f->accept(&svVisitor);
+  MatrixProductState state(5);
+  MPSVisitor visitor(state, r);
+  f->accept(&visitor);
+  EXPECT_EQ(svVisitor.classicalBits, visitor.classicalBits);
+  EXPECT_NEAR(1.0, overlap(expected.amplitudes(), state.amplitudes()),
+              1e-10);
+}
+
+TEST(MPSAcceleratorTester, checkLargeGHZ) {
+  auto acc = std::make_shared<MPSAccelerator>();
+  xacc::setOption("mps-shots", "500");
+  xacc::setOption("mps-seed", "7");
+  const int n = 100;
+  std::vector<InstPtr> gates{std::make_shared<Hadamard>(0)};
+  for (int q = 0; q < n - 1; q++) {
+    gates.push_back(std::make_shared<CNOT>(q, q + 1));
+  }
+  for (int q = 0; q < n; q++) {
+    gates.push_back(std::make_shared<Measure>(q, q));
+  }
+  auto buffer = acc->createBuffer("q", n);
+  acc->execute(buffer, circuit(gates));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(2, counts.size());
+  EXPECT_EQ(500, counts[std::string(n, '0')] + counts[std::string(n, '1')]);
+  EXPECT_NEAR(250, counts[std::string(n, '0')], 50);
+  EXPECT_EQ(2, mpark::get<int>(buffer->getInformation("mps-bond-dimension")));
+  xacc::unsetOption("mps-shots");
+  xacc::unsetOption("mps-seed");
+}
+
+TEST(MPSAcceleratorTester, checkTruncation) {
+  // A Bell pair with bond dimension 1 keeps one of its two terms
+  MatrixProductState state(2, 1);
+  state.apply(0, {M_SQRT1_2, M_SQRT1_2, M_SQRT1_2, -M_SQRT1_2});
+  state.applyCNOT(0, 1);
+  EXPECT_EQ(1, state.bondDimension());
+  EXPECT_NEAR(0.5, state.truncationError(), 1e-12);
+  auto amplitudes = state.amplitudes();
+  EXPECT_NEAR(1.0, std::norm(amplitudes[0]) + std::norm(amplitudes[3]),
+              1e-12);
+
+  // A loose cutoff truncates a weakly entangled pair
+  MatrixProductState loose(2, 64, 0.1), tight(2);
+  for (auto s : {&loose, &tight}) {
+    s->apply(0, {std::cos(0.05), -std::sin(0.05), std::sin(0.05),
+                 std::cos(0.05)});
+    s->applyCNOT(0, 1);
+  }
+  EXPECT_EQ(1, loose.bondDimension());
+  EXPECT_EQ(2, tight.bondDimension());
+}
+
+TEST(MPSAcceleratorTester, checkConditional) {
+  auto acc = xacc::getAccelerator("mps");
+  xacc::setOption("mps-shots", "1000");
+  xacc::setOption("mps-seed", "3");
+
+  // Flip qubit 1 exactly when qubit 0 measured 1
+  auto conditional = std::make_shared<ConditionalFunction>(0);
+  conditional->addInstruction(std::make_shared<X>(1));
+  auto buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 0), conditional,
+                                std::make_shared<Measure>(1, 1)}));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(1000, counts["00"] + counts["11"]);
+  EXPECT_NEAR(500, counts["11"], 80);
+  xacc::unsetOption("mps-shots");
+  xacc::unsetOption("mps-seed");
+}
+
+TEST(MPSAcceleratorTester, DISABLED_benchmarkAgainstStateVector) {
+  auto r = []() { return 0.5; };
+  auto seconds = [](std::function<void()> run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+    return s.count();
+  };
+
+  // A depth 4 ansatz on sizes both can hold, then on sizes only
+  // the MPS can
+  for (int n = 10; n <= 100; n += (n < 26 ? 2 : 10)) {
+    auto f = ansatz(n, 4);
+    MatrixProductState state(n);
+    MPSVisitor visitor(state, r);
+    auto mpsTime = seconds([&]() { f->accept(&visitor); });
+    std::cout << n << " qubits: mps " << mpsTime << " s, bond "
+              << state.bondDimension();
+    if (n <= 26) {
+      StateVector expected(n);
+      StateVectorVisitor svVisitor(expected, r);
+      auto svTime = seconds([&]() { f->accept(&svVisitor); });
+      std::cout << ", statevector " << svTime << " s";
+      if (n <= 20) {
+        std::cout << ", overlap "
+                  << overlap(expected.amplitudes(), state.amplitudes());
+      }
+    }
+    std::cout << "\n";
+  }
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
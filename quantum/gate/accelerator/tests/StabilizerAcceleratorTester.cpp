@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "StabilizerAccelerator.hpp"
+#include "StabilizerVisitor.hpp"
+#include "StateVectorAccelerator.hpp"
+#include <random>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+std::shared_ptr<GateFunction> circuit(std::vector<InstPtr> gates) {
+  auto f = std::make_shared<GateFunction>("foo");
+  for (auto &g : gates) {
+    f->addInstruction(g);
+  }
+  return f;
+}
+
+InstPtr crz(const int control, const int target, const double theta) {
+  auto gate = std::make_shared<CRZ>(std::vector<int>{control, target});
+  InstructionParameter angle(theta);
+  gate->setParameter(0, angle);
+  return gate;
+}
+
+std::set<std::string> outcomes(std::shared_ptr<AcceleratorBuffer> buffer) {
+  std::set<std::string> result;
+  for (auto &kv : buffer->getMeasurementCounts()) {
+    result.insert(kv.first);
+  }
+  return result;
+}
+
+TEST(StabilizerAcceleratorTester, checkRandomCliffords) {
+  auto stabilizer = std::make_shared<StabilizerAccelerator>();
+  auto statevector = std::make_shared<StateVectorAccelerator>();
+  xacc::setOption("stabilizer-shots", "4000");
+  xacc::setOption("stabilizer-seed", "5");
+  xacc::setOption("statevector-exact", "");
+
+  // The sampled outcomes of random Clifford circuits must be exactly
+  // those the state vector gives nonzero probability
+  const int n = 5;
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> gate(0, 13), qubit(0, n - 1),
+      turns(-4, 4);
+  for (int trial = 0; trial < 20; trial++) {
+    std::vector<InstPtr> gates;
+    for (int i = 0; i < 40; i++) {
+      auto a = qubit(gen), b = (a + 1 + qubit(gen) % (n - 1)) % n;
+      auto t = turns(gen) * M_PI / 2.0;
+      switch (gate(gen)) {
+      case 0: gates.push_back(std::make_shared<Hadamard>(a)); break;
+      case 1: gates.push_back(std::make_shared<S>(a)); break;
+      case 2: gates.push_back(std::make_shared<Sdg>(a)); break;
+      case 3: gates.push_back(std::make_shared<X>(a)); break;
+      case 4: gates.push_back(std::make_shared<Y>(a)); break;
+      case 5: gates.push_back(std::make_shared<CNOT>(a, b)); break;
+      case 6: gates.push_back(std::make_shared<CZ>(a, b)); break;
+      case 7: gates.push_back(std::make_shared<Swap>(a, b)); break;
+      case 8: gates.push_back(std::make_shared<CY>(a, b)); break;
+      case 9: gates.push_back(std::make_shared<Rx>(a, t)); break;
+      case 10: gates.push_back(std::make_shared<Ry>(a, t)); break;
+      case 11:
+        gates.push_back(std::make_shared<U>(a, t, M_PI / 2.0, -t));
+        break;
+      case 12: gates.push_back(crz(a, b, 2.0 * t)); break;
+      default: gates.push_back(std::make_shared<CPhase>(a, b, M_PI));
+      }
+    }
+    for (int q = 0; q < n; q++) {
+      gates.push_back(std::make_shared<Measure>(q, q));
+    }
+
+    auto buffer = stabilizer->createBuffer("q", n);
+    stabilizer->execute(buffer, circuit(gates));
+
+    // The exact mode leaves no counts, sample the support instead
+    xacc::unsetOption("statevector-exact");
+    xacc::setOption("statevector-shots", "4000");
+    auto expected = statevector->createBuffer("q", n);
+    statevector->execute(expected, circuit(gates));
+    xacc::setOption("statevector-exact", "");
+
+    EXPECT_EQ(outcomes(expected), outcomes(buffer));
+  }
+  xacc::unsetOption("statevector-exact");
+  xacc::unsetOption("statevector-shots");
+  xacc::unsetOption("stabilizer-shots");
+  xacc::unsetOption("stabilizer-seed");
+}
+
+TEST(StabilizerAcceleratorTester, checkConditional) {
+  auto acc = std::make_shared<StabilizerAccelerator>();
+  xacc::setOption("stabilizer-shots", "1000");
+  xacc::setOption("stabilizer-seed", "3");
+
+  // Flip qubit 1 exactly when qubit 0 measured 1
+  auto conditional = std::make_shared<ConditionalFunction>(0);
+  conditional->addInstruction(std::make_shared<X>(1));
+  auto buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 0), conditional,
+                                std::make_shared<Measure>(1, 1)}));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(1000, counts["00"] + counts["11"]);
+  EXPECT_NEAR(500, counts["11"], 80);
+
+  // Measuring collapses the state, the second H randomizes it again
+  buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 1)}));
+  counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(4, counts.size());
+  for (auto &kv : counts) {
+    EXPECT_NEAR(250, kv.second, 60);
+  }
+  xacc::unsetOption("stabilizer-shots");
+  xacc::unsetOption("stabilizer-seed");
+}
+
+TEST(StabilizerAcceleratorTester, checkLargeGHZ) {
+  auto acc = std::make_shared<StabilizerAccelerator>();
+  xacc::setOption("stabilizer-shots", "200");
+  const int n = 2000;
+  std::vector<InstPtr> gates{std::make_shared<Hadamard>(0)};
+  for (int q = 0; q < n - 1; q++) {
+    gates.push_back(std::make_shared<CNOT>(q, q + 1));
+  }
+  for (int q = 0; q < n; q++) {
+    gates.push_back(std::make_shared<Measure>(q, q));
+  }
+  auto buffer = acc->createBuffer("q", n);
+  acc->execute(buffer, circuit(gates));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(2, counts.size());
+  EXPECT_EQ(200, counts[std::string(n, '0')] + counts[std::string(n, '1')]);
+  xacc::unsetOption("stabilizer-shots");
+}
+
+TEST(StabilizerAcceleratorTester, checkNonClifford) {
+  xacc::setIsPyApi();
+  auto acc = xacc::getAccelerator("stabilizer");
+  auto buffer = acc->createBuffer("q", 1);
+  EXPECT_THROW(acc->execute(buffer, circuit({std::make_shared<T>(0),
+                                             std::make_shared<Measure>(0, 0)})),
+               std::runtime_error);
+  EXPECT_THROW(acc->execute(buffer, circuit({std::make_shared<Rz>(0, 0.3)})),
+               std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -0,0 +1,458 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "StateVectorAccelerator.hpp"
+#include "FusedStateVectorVisitor.hpp"
+#include "QFT.hpp"
+#include "InverseQFT.hpp"
+#include <chrono>
+#include <random>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+using Amplitudes = std::vector<StateVector::Amplitude>;
+
+// Run the Function on a random product state of n qubits, with a
+// Visitor constructed from the state, a random source and the args
+template <typename Visitor = StateVectorVisitor, typename... Args>
+Amplitudes run(std::shared_ptr<Function> f, const int n, Args... args) {
+  StateVector state(n);
+  Visitor visitor(state, []() { return 0.5; }, args...);
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+  for (int q = 0; q < n; q++) {
+    U u(q, angle(gen), angle(gen), angle(gen));
+    visitor.visit(u);
+  }
+  f->accept(&visitor);
+  return state.amplitudes();
+}
+
+// Equal up to a global phase
+void expectSameState(const Amplitudes &a, const Amplitudes &b) {
+  StateVector::Amplitude overlap = 0.0;
+  for (int i = 0; i < a.size(); i++) {
+    overlap += std::conj(a[i]) * b[i];
+  }
+  EXPECT_NEAR(1.0, std::abs(overlap), 1e-10);
+}
+
+std::shared_ptr<GateFunction> circuit(std::vector<InstPtr> gates) {
+  auto f = std::make_shared<GateFunction>("foo");
+  for (auto &g : gates) {
+    f->addInstruction(g);
+  }
+  return f;
+}
+
+InstPtr crz(const int control, const int target, const double theta) {
+  auto gate = std::make_shared<CRZ>(std::vector<int>{control, target});
+  InstructionParameter angle(theta);
+  gate->setParameter(0, angle);
+  return gate;
+}
+
+TEST(StateVectorAcceleratorTester, checkAmplitudes) {
+  const double r = 1.0 / std::sqrt(2.0);
+  const StateVector::Amplitude i(0.0, 1.0);
+  StateVector state(2);
+  StateVectorVisitor visitor(state, []() { return 0.5; });
+  Hadamard h(0);
+  visitor.visit(h);
+  EXPECT_NEAR(r, state.amplitudes()[0].real(), 1e-12);
+  EXPECT_NEAR(r, state.amplitudes()[1].real(), 1e-12);
+  T t(0);
+  visitor.visit(t);
+  EXPECT_NEAR(0.0, std::abs(state.amplitudes()[1] - (0.5 + 0.5 * i)), 1e-12);
+
+  state.reset();
+  Rx rx(1, M_PI);
+  visitor.visit(rx);
+  EXPECT_NEAR(0.0, std::abs(state.amplitudes()[2] + i), 1e-12);
+  Ry ry(0, M_PI);
+  visitor.visit(ry);
+  EXPECT_NEAR(0.0, std::abs(state.amplitudes()[3] + i), 1e-12);
+  EXPECT_NEAR(1.0, state.probability(0), 1e-12);
+}
+
+TEST(StateVectorAcceleratorTester, checkGates) {
+  const double theta = 0.7, phi = -1.3, lambda = 2.1;
+  const std::vector<std::pair<InstPtr, std::vector<InstPtr>>> identities{
+      {std::make_shared<Identity>(1), {}},
+      {std::make_shared<Y>(2),
+       {std::make_shared<Z>(2), std::make_shared<X>(2)}},
+      {std::make_shared<Z>(2), {std::make_shared<Rz>(2, M_PI)}},
+      {std::make_shared<S>(0), {std::make_shared<Rz>(0, M_PI / 2)}},
+      {std::make_shared<Sdg>(3), {std::make_shared<Rz>(3, -M_PI / 2)}},
+      {std::make_shared<T>(1), {std::make_shared<Rz>(1, M_PI / 4)}},
+      {std::make_shared<Tdg>(1), {std::make_shared<Rz>(1, -M_PI / 4)}},
+      {std::make_shared<Rx>(2, theta),
+       {std::make_shared<Hadamard>(2), std::make_shared<Rz>(2, theta),
+        std::make_shared<Hadamard>(2)}},
+      {std::make_shared<U>(0, theta, phi, lambda),
+       {std::make_shared<Rz>(0, lambda), std::make_shared<Ry>(0, theta),
+        std::make_shared<Rz>(0, phi)}},
+      {std::make_shared<CZ>(0, 3),
+       {std::make_shared<Hadamard>(3), std::make_shared<CNOT>(0, 3),
+        std::make_shared<Hadamard>(3)}},
+      {std::make_shared<CY>(3, 1),
+       {std::make_shared<Sdg>(1), std::make_shared<CNOT>(3, 1),
+        std::make_shared<S>(1)}},
+      {std::make_shared<CH>(1, 2),
+       {std::make_shared<Ry>(2, -M_PI / 4), std::make_shared<CZ>(1, 2),
+        std::make_shared<Ry>(2, M_PI / 4)}},
+      {std::make_shared<Swap>(0, 2),
+       {std::make_shared<CNOT>(0, 2), std::make_shared<CNOT>(2, 0),
+        std::make_shared<CNOT>(0, 2)}},
+      {crz(2, 0, theta),
+       {std::make_shared<Rz>(0, theta / 2), std::make_shared<CNOT>(2, 0),
+        std::make_shared<Rz>(0, -theta / 2), std::make_shared<CNOT>(2, 0)}},
+      {std::make_shared<CPhase>(1, 3, theta),
+       {crz(1, 3, theta), std::make_shared<Rz>(1, theta / 2)}}};
+
+  // Each gate against an equivalent sequence, on a small state and
+  // on one large enough to take the parallel kernels
+  for (auto n : {4, 16}) {
+    for (auto &kv : identities) {
+      expectSameState(run(circuit({kv.first}), n),
+                      run(circuit(kv.second), n));
+    }
+  }
+}
+
+TEST(StateVectorAcceleratorTester, checkBell) {
+  auto acc = std::make_shared<StateVectorAccelerator>();
+  auto buffer = acc->createBuffer("q", 2);
+  xacc::setOption("statevector-shots", "2000");
+  xacc::setOption("statevector-seed", "7");
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<CNOT>(0, 1),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Measure>(1, 1)}));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(2, counts.size());
+  EXPECT_EQ(2000, counts["00"] + counts["11"]);
+  EXPECT_NEAR(1000, counts["00"], 100);
+  EXPECT_DOUBLE_EQ(1.0, buffer->getExpectationValueZ());
+
+  // Bit strings hold classical bit 0 rightmost
+  buffer = acc->createBuffer("q", 3);
+  acc->execute(buffer, circuit({std::make_shared<X>(2),
+                                std::make_shared<Measure>(2, 0),
+                                std::make_shared<Measure>(0, 2)}));
+  EXPECT_EQ(2000, buffer->getMeasurementCounts()["001"]);
+  xacc::unsetOption("statevector-shots");
+  xacc::unsetOption("statevector-seed");
+}
+
+TEST(StateVectorAcceleratorTester, checkConditional) {
+  auto acc = std::make_shared<StateVectorAccelerator>();
+  xacc::setOption("statevector-shots", "1000");
+  xacc::setOption("statevector-seed", "3");
+
+  // Flip qubit 1 exactly when qubit 0 measured 1
+  auto conditional = std::make_shared<ConditionalFunction>(0);
+  conditional->addInstruction(std::make_shared<X>(1));
+  auto f = circuit({std::make_shared<Hadamard>(0),
+                    std::make_shared<Measure>(0, 0), conditional,
+                    std::make_shared<Measure>(1, 1)});
+  auto buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, f);
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(1000, counts["00"] + counts["11"]);
+  EXPECT_NEAR(500, counts["11"], 80);
+  EXPECT_FALSE(conditional->getInstruction(0)->isEnabled());
+
+  // Measuring collapses the state, the second H randomizes it again
+  buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 1)}));
+  counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(4, counts.size());
+  for (auto &kv : counts) {
+    EXPECT_NEAR(250, kv.second, 60);
+  }
+  xacc::unsetOption("statevector-shots");
+  xacc::unsetOption("statevector-seed");
+}
+
+TEST(StateVectorAcceleratorTester, checkExact) {
+  auto acc = std::make_shared<StateVectorAccelerator>();
+  xacc::setOption("statevector-exact", "");
+  const double a = 0.4, b = 1.1;
+
+  // <Z0 Z1> and, after a change of basis, <X0 Z1>
+  auto buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Ry>(0, a),
+                                std::make_shared<Ry>(1, b),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Measure>(1, 1)}));
+  EXPECT_TRUE(buffer->hasExactExpectationValueZ());
+  EXPECT_TRUE(buffer->getMeasurementCounts().empty());
+  EXPECT_NEAR(std::cos(a) * std::cos(b), buffer->getExpectationValueZ(),
+              1e-12);
+
+  buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Ry>(0, a),
+                                std::make_shared<Ry>(1, b),
+                                std::make_shared<Hadamard>(0),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Measure>(1, 1)}));
+  EXPECT_NEAR(std::sin(a) * std::cos(b), buffer->getExpectationValueZ(),
+              1e-12);
+
+  // Mid-circuit measurements are sampled
+  buffer = acc->createBuffer("q", 1);
+  acc->execute(buffer, circuit({std::make_shared<Measure>(0, 0),
+                                std::make_shared<X>(0),
+                                std::make_shared<Measure>(0, 0)}));
+  EXPECT_FALSE(buffer->hasExactExpectationValueZ());
+  EXPECT_EQ(1024, buffer->getMeasurementCounts()["1"]);
+  xacc::unsetOption("statevector-exact");
+}
+
+TEST(StateVectorAcceleratorTester, checkFusion) {
+  // Random circuits of every gate, fused into blocks of up to k qubits,
+  // on a small state and on one large enough to take the parallel kernels
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  for (auto n : {6, 16}) {
+    std::uniform_int_distribution<int> qubit(0, n - 1);
+    auto f = std::make_shared<GateFunction>("random");
+    for (int i = 0; i < 300; i++) {
+      int a = qubit(gen), b = qubit(gen);
+      while (b == a) {
+        b = qubit(gen);
+      }
+      const std::vector<InstPtr> gates{
+          std::make_shared<Hadamard>(a), std::make_shared<X>(a),
+          std::make_shared<Y>(a), std::make_shared<Z>(a),
+          std::make_shared<S>(a), std::make_shared<Tdg>(a),
+          std::make_shared<Rx>(a, angle(gen)),
+          std::make_shared<Ry>(a, angle(gen)),
+          std::make_shared<Rz>(a, angle(gen)),
+          std::make_shared<U>(a, angle(gen), angle(gen), angle(gen)),
+          std::make_shared<CNOT>(a, b), std::make_shared<CY>(a, b),
+          std::make_shared<CZ>(a, b), std::make_shared<CH>(a, b),
+          crz(a, b, angle(gen)), std::make_shared<CPhase>(a, b, angle(gen)),
+          std::make_shared<Swap>(a, b)};
+      f->addInstruction(gates[gen() % gates.size()]);
+    }
+
+    auto expected = run(f, n);
+    for (int k = 2; k <= StateVector::maxMatrixQubits; k++) {
+      auto amplitudes = run<FusedStateVectorVisitor>(f, n, k);
+      for (int i = 0; i < expected.size(); i++) {
+        EXPECT_NEAR(0.0, std::abs(amplitudes[i] - expected[i]), 1e-10);
+      }
+    }
+  }
+
+  // Blocks are applied before measurements and ConditionalFunctions
+  // read the collapsed bits, here teleporting Ry(0.9)|0>
+  xacc::setOption("statevector-fusion", "3");
+  xacc::setOption("statevector-shots", "2000");
+  xacc::setOption("statevector-seed", "9");
+  auto acc = std::make_shared<StateVectorAccelerator>();
+  auto xFix = std::make_shared<ConditionalFunction>(1);
+  xFix->addInstruction(std::make_shared<X>(2));
+  auto zFix = std::make_shared<ConditionalFunction>(0);
+  zFix->addInstruction(std::make_shared<Z>(2));
+  auto buffer = acc->createBuffer("q", 3);
+  acc->execute(buffer,
+               circuit({std::make_shared<Ry>(0, 0.9),
+                        std::make_shared<Hadamard>(1),
+                        std::make_shared<CNOT>(1, 2),
+                        std::make_shared<CNOT>(0, 1),
+                        std::make_shared<Hadamard>(0),
+                        std::make_shared<Measure>(0, 0),
+                        std::make_shared<Measure>(1, 1), xFix, zFix,
+                        std::make_shared<Measure>(2, 2)}));
+  double p1 = 0.0;
+  for (auto &kv : buffer->getMeasurementCounts()) {
+    if (kv.first[0] == '1') {
+      p1 += kv.second / 2000.0;
+    }
+  }
+  EXPECT_NEAR(std::pow(std::sin(0.45), 2), p1, 0.03);
+
+  xacc::setOption("statevector-fusion", "6");
+  xacc::setIsPyApi();
+  EXPECT_ANY_THROW(acc->execute(acc->createBuffer("q", 1),
+                                circuit({std::make_shared<Measure>(0, 0)})));
+  xacc::unsetOption("statevector-fusion");
+  xacc::unsetOption("statevector-shots");
+  xacc::unsetOption("statevector-seed");
+}
+
+TEST(StateVectorAcceleratorTester, checkService) {
+  EXPECT_TRUE(xacc::hasAccelerator("statevector"));
+  auto acc = xacc::getAccelerator("statevector");
+  auto buffer = acc->createBuffer("q", 3);
+  auto ry = std::make_shared<Ry>(1, 2.0 * M_PI / 3.0);
+  auto buffers = acc->execute(
+      buffer, std::vector<std::shared_ptr<Function>>{
+                  circuit({ry, std::make_shared<Measure>(1, 1)}),
+                  circuit({std::make_shared<Measure>(0, 0)})});
+  EXPECT_EQ(2, buffers.size());
+  EXPECT_NEAR(0.75, buffers[0]->computeMeasurementProbability("010"), 0.06);
+  EXPECT_EQ(1024, buffers[1]->getMeasurementCounts()["000"]);
+}
+
+TEST(StateVectorAcceleratorTester, DISABLED_benchmarkGatesPerSecond) {
+  // Layers of H, Rz and a CNOT ladder over all qubits
+  for (int n = 10; n <= 30; n += 2) {
+    auto f = std::make_shared<GateFunction>("bench");
+    for (int layer = 0; layer < 4; layer++) {
+      for (int q = 0; q < n; q++) {
+        f->addInstruction(std::make_shared<Hadamard>(q));
+        f->addInstruction(std::make_shared<Rz>(q, 0.1 * q));
+      }
+      for (int q = 0; q < n - 1; q++) {
+        f->addInstruction(std::make_shared<CNOT>(q, q + 1));
+      }
+    }
+
+    StateVector state(n);
+    StateVectorVisitor visitor(state, []() { return 0.5; });
+    auto start = std::chrono::steady_clock::now();
+    f->accept(&visitor);
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+    std::cout << n << " qubits: " << f->nInstructions() / seconds.count()
+              << " gates/sec\n";
+  }
+}
+
+// exp(-i theta / 2 P) for the Pauli string P, an 'X', 'Y' or 'Z' on
+// each of the given qubits, by the basis changes and CNOT ladder of
+// UCCSD circuits
+void addPauliExponential(std::shared_ptr<GateFunction> f,
+                         const std::vector<std::pair<int, char>> &paulis,
+                         const double theta) {
+  auto basis = [&](const double sign) {
+    for (auto &p : paulis) {
+      if (p.second == 'X') {
+        f->addInstruction(std::make_shared<Hadamard>(p.first));
+      } else if (p.second == 'Y') {
+        f->addInstruction(std::make_shared<Rx>(p.first, sign * M_PI / 2));
+      }
+    }
+  };
+  basis(1.0);
+  for (int i = 0; i + 1 < paulis.size(); i++) {
+    f->addInstruction(
+        std::make_shared<CNOT>(paulis[i].first, paulis[i + 1].first));
+  }
+  f->addInstruction(std::make_shared<Rz>(paulis.back().first, theta));
+  for (int i = paulis.size() - 2; i >= 0; i--) {
+    f->addInstruction(
+        std::make_shared<CNOT>(paulis[i].first, paulis[i + 1].first));
+  }
+  basis(-1.0);
+}
+
+// The Jordan-Wigner UCCSD ansatz of the given number of electrons in
+// n spin orbitals, with the Pauli strings of each excitation
+std::shared_ptr<GateFunction> uccsd(const int n, const int electrons) {
+  auto f = std::make_shared<GateFunction>("uccsd");
+  for (int q = 0; q < electrons; q++) {
+    f->addInstruction(std::make_shared<X>(q));
+  }
+  double theta = 0.0;
+  // The string with the given Paulis on the given orbitals and
+  // Z between each pair of them
+  auto excitation = [&](const std::vector<int> &orbitals,
+                        const std::string &ops) {
+    std::vector<std::pair<int, char>> paulis;
+    for (int k = 0; k < orbitals.size(); k++) {
+      paulis.push_back({orbitals[k], ops[k]});
+      if (k % 2 == 0) {
+        for (int q = orbitals[k] + 1; q < orbitals[k + 1]; q++) {
+          paulis.push_back({q, 'Z'});
+        }
+      }
+    }
+    addPauliExponential(f, paulis, theta += 0.01);
+  };
+  for (int i = 0; i < electrons; i++) {
+    for (int a = electrons; a < n; a++) {
+      for (auto ops : {"XY", "YX"}) {
+        excitation({i, a}, ops);
+      }
+    }
+  }
+  for (int i = 0; i < electrons; i++) {
+    for (int j = i + 1; j < electrons; j++) {
+      for (int a = electrons; a < n; a++) {
+        for (int b = a + 1; b < n; b++) {
+          for (auto ops : {"XXXY", "XXYX", "XYXX", "YXXX", "YYYX", "YYXY",
+                           "YXYY", "XYYY"}) {
+            excitation({i, j, a, b}, ops);
+          }
+        }
+      }
+    }
+  }
+  return f;
+}
+
+TEST(StateVectorAcceleratorTester, DISABLED_benchmarkFusion) {
+  auto seconds = [](std::function<void()> f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  };
+
+  // Passes over the amplitudes and wall clock time, without fusion
+  // and with blocks of up to k qubits
+  auto compare = [&](const std::string &label, std::shared_ptr<Function> f,
+                     const int n) {
+    StateVector state(n);
+    StateVectorVisitor plain(state, []() { return 0.5; });
+    std::cout << label << ", " << n << " qubits, " << f->nInstructions()
+              << " gates: "
+              << seconds([&]() { f->accept(&plain); }) << " s unfused";
+    for (int k = 2; k <= StateVector::maxMatrixQubits; k++) {
+      state.reset();
+      FusedStateVectorVisitor fused(state, []() { return 0.5; }, k);
+      auto t = seconds([&]() { f->accept(&fused); });
+      std::cout << ", k = " << k << ": " << fused.sweeps << " sweeps "
+                << t << " s";
+    }
+    std::cout << "\n";
+  };
+
+  for (int n : {16, 20, 24}) {
+    auto buffer = std::make_shared<AcceleratorBuffer>("q", n);
+    compare("QFT", QFT().generate(buffer), n);
+    compare("InverseQFT", InverseQFT().generate(buffer), n);
+  }
+  compare("UCCSD", uccsd(12, 4), 12);
+  compare("UCCSD", uccsd(16, 2), 16);
+  compare("UCCSD", uccsd(18, 2), 18);
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "TrajectoryAccelerator.hpp"
+#include "NoisyStateVectorVisitor.hpp"
+#include "ROErrorDecorator.hpp"
+#include <fstream>
+#include <unistd.h>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+std::shared_ptr<GateFunction> circuit(std::vector<InstPtr> gates) {
+  auto f = std::make_shared<GateFunction>("foo");
+  for (auto &g : gates) {
+    f->addInstruction(g);
+  }
+  return f;
+}
+
+// Write the given JSON to a file unique to this process, return its name
+std::string writeFile(const std::string &name, const std::string &json) {
+  auto file = "/tmp/xacc-trajectory-" + std::to_string(getpid()) + "-" +
+              name + ".json";
+  std::ofstream out(file);
+  out << json;
+  return file;
+}
+
+// Two qubits, 1q gate errors e0 and e1, readout errors r0 and r1,
+// and a CX0_1 error of e01
+std::string calibration(const double e0, const double e1, const double r0,
+                        const double r1, const double e01) {
+  auto qubit = [](const double e, const double r) {
+    return "{\"gateError\": {\"value\": " + std::to_string(e) +
+           "}, \"readoutError\": {\"value\": " + std::to_string(r) + "}}";
+  };
+  return "{\"qubits\": [" + qubit(e0, r0) + ", " + qubit(e1, r1) +
+         "], \"multiQubitGates\": [{\"name\": \"CX0_1\", \"gateError\": "
+         "{\"value\": " +
+         std::to_string(e01) + "}}]}";
+}
+
+class TrajectoryAcceleratorTester : public ::testing::Test {
+protected:
+  std::vector<std::string> files;
+
+  void useCalibration(const std::string &json) {
+    files.push_back(writeFile(std::to_string(files.size()), json));
+    xacc::setOption("trajectory-calibration", files.back());
+  }
+
+  void SetUp() override {
+    xacc::setOption("trajectory-shots", "4000");
+    xacc::setOption("trajectory-seed", "17");
+  }
+
+  void TearDown() override {
+    xacc::unsetOption("trajectory-calibration");
+    xacc::unsetOption("trajectory-shots");
+    xacc::unsetOption("trajectory-seed");
+    for (auto &f : files) {
+      std::remove(f.c_str());
+    }
+  }
+};
+
+TEST_F(TrajectoryAcceleratorTester, checkCalibration) {
+  useCalibration(calibration(0.001, 0.002, 0.03, 0.04, 0.05));
+  auto acc = xacc::getAccelerator("trajectory");
+  auto oneBit = acc->getOneBitErrorRates();
+  EXPECT_EQ(2, oneBit.size());
+  EXPECT_DOUBLE_EQ(0.002, oneBit[1]);
+  auto twoBit = acc->getTwoBitErrorRates();
+  EXPECT_EQ(1, twoBit.size());
+  EXPECT_EQ(std::make_pair(0, 1), twoBit[0].first);
+  EXPECT_DOUBLE_EQ(0.05, twoBit[0].second);
+
+  auto buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Measure>(0, 0)}));
+  auto readout =
+      mpark::get<std::vector<double>>(buffer->getInformation("readoutErrors"));
+  EXPECT_DOUBLE_EQ(0.04, readout[1]);
+
+  // Without a calibration there is no noise
+  xacc::unsetOption("trajectory-calibration");
+  EXPECT_TRUE(acc->getOneBitErrorRates().empty());
+  buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<Hadamard>(0),
+                                std::make_shared<CNOT>(0, 1),
+                                std::make_shared<Measure>(0, 0),
+                                std::make_shared<Measure>(1, 1)}));
+  auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(4000, counts["00"] + counts["11"]);
+}
+
+TEST_F(TrajectoryAcceleratorTester, checkDepolarizing) {
+  auto acc = std::make_shared<TrajectoryAccelerator>();
+
+  // A Pauli error after the identity flips the bit 2/3 of the time
+  useCalibration(calibration(0.3, 0.0, 0.0, 0.0, 0.0));
+  auto buffer = acc->createBuffer("q", 1);
+  acc->execute(buffer, circuit({std::make_shared<Identity>(0),
+                                std::make_shared<Measure>(0, 0)}));
+  EXPECT_NEAR(0.2, buffer->computeMeasurementProbability("1"), 0.02);
+
+  // A two qubit Pauli error flips qubit 0 in 8 of its 15 cases
+  useCalibration(calibration(0.0, 0.0, 0.0, 0.0, 0.3));
+  buffer = acc->createBuffer("q", 2);
+  acc->execute(buffer, circuit({std::make_shared<CNOT>(1, 0),
+                                std::make_shared<Measure>(0, 0)}));
+  EXPECT_NEAR(0.16, buffer->computeMeasurementProbability("01"), 0.02);
+}
+
+TEST_F(TrajectoryAcceleratorTester, checkReadoutMitigation) {
+  useCalibration(calibration(0.0, 0.0, 0.1, 0.0, 0.0));
+  auto acc = std::make_shared<TrajectoryAccelerator>();
+  auto f = circuit({std::make_shared<X>(0), std::make_shared<Measure>(0, 0)});
+  auto buffer = acc->createBuffer("q", 1);
+  acc->execute(buffer, f);
+  EXPECT_NEAR(-0.8, buffer->getExpectationValueZ(), 0.03);
+
+  // A symmetric flip probability p is pi+ = 2p and pi- = 0
+  auto roFile = writeFile("ro", "{\"0\": {\"+\": 0.2, \"-\": 0.0}}");
+  files.push_back(roFile);
+  xacc::setOption("ro-error-file", roFile);
+  auto decorator = std::make_shared<ROErrorDecorator>();
+  decorator->setDecorated(acc);
+  buffer = acc->createBuffer("q", 1);
+  decorator->execute(buffer, f);
+  EXPECT_NEAR(-1.0,
+              mpark::get<double>(buffer->getInformation("ro-fixed-exp-val-z")),
+              0.04);
+  xacc::unsetOption("ro-error-file");
+}
+
+TEST_F(TrajectoryAcceleratorTester, checkReproducible) {
+  useCalibration(calibration(0.05, 0.05, 0.02, 0.02, 0.1));
+  auto acc = std::make_shared<TrajectoryAccelerator>();
+  auto f = circuit({std::make_shared<Hadamard>(0),
+                    std::make_shared<CNOT>(0, 1),
+                    std::make_shared<Measure>(0, 0),
+                    std::make_shared<Measure>(1, 1)});
+  auto a = acc->createBuffer("q", 2), b = acc->createBuffer("q", 2);
+  acc->execute(a, f);
+  acc->execute(b, f);
+  EXPECT_EQ(a->getMeasurementCounts(), b->getMeasurementCounts());
+  EXPECT_EQ(4, a->getMeasurementCounts().size());
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
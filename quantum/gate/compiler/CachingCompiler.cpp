@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "CachingCompiler.hpp"
+#include "CompilationCache.hpp"
+#include "XACC.hpp"
+#include <mutex>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+
+// The CompilationCache for the given directory, opened once per process
+std::shared_ptr<CompilationCache> cacheFor(const std::string &directory) {
+  static std::mutex lock;
+  static std::map<std::string, std::shared_ptr<CompilationCache>> caches;
+  std::lock_guard<std::mutex> guard(lock);
+  auto &cache = caches[directory];
+  if (!cache) {
+    cache = std::make_shared<CompilationCache>(directory);
+  }
+  return cache;
+}
+
+} // namespace
+
+std::shared_ptr<IR> CachingCompiler::compile(const std::string &src,
+                                             std::shared_ptr<Accelerator> acc) {
+  if (!xacc::optionExists("compilation-cache-dir")) {
+    return decoratedCompiler->compile(src, acc);
+  }
+  auto cache = cacheFor(xacc::getOption("compilation-cache-dir"));
+  return cache->compile(decoratedCompiler, src, acc);
+}
+
+std::shared_ptr<IR> CachingCompiler::compile(const std::string &src) {
+  if (!xacc::optionExists("compilation-cache-dir")) {
+    return decoratedCompiler->compile(src);
+  }
+  auto cache = cacheFor(xacc::getOption("compilation-cache-dir"));
+  auto key = CompilationCache::key(decoratedCompiler, src, nullptr);
+  if (!cache->cacheable(key)) {
+    return decoratedCompiler->compile(src);
+  }
+  auto ir = cache->get(key);
+  if (!ir) {
+    ir = decoratedCompiler->compile(src);
+    cache->put(key, ir);
+  }
+  return ir;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_COMPILER_CACHINGCOMPILER_HPP_
+#define QUANTUM_GATE_COMPILER_CACHINGCOMPILER_HPP_
+
+#include "CompilerDecorator.hpp"
+#include "Cloneable.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The CachingCompiler compiles source with the Compiler it decorates
+ * through a CompilationCache kept in the compilation-cache-dir
+ * directory. xacc::getCompiler() decorates the Compilers it returns
+ * with it whenever that option is set.
+ */
+class CachingCompiler : public CompilerDecorator,
+                        public Cloneable<CompilerDecorator> {
+public:
+  std::shared_ptr<IR> compile(const std::string &src,
+                              std::shared_ptr<Accelerator> acc) override;
+
+  std::shared_ptr<IR> compile(const std::string &src) override;
+
+  std::shared_ptr<CompilerDecorator> clone() override {
+    return std::make_shared<CachingCompiler>();
+  }
+
+protected:
+  OptionPairs decoratorOptions() override {
+    OptionPairs desc{{"compilation-cache-dir",
+                      "Cache compiled kernels in the given directory."}};
+    return desc;
+  }
+
+  const std::string decoratorName() const override {
+    return "compilation-cache";
+  }
+  const std::string decoratorDescription() const override {
+    return "Caches the IR of compiled kernels on disk.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -24,7 +24,16 @@ public:
     OptionPairs desc {{"circuit-opt-n-tries",
                         "Provide the number of passes to use in optimizing "
                         "this circuit. Default = 2."},{"circuit-opt-silent",
-                                                      "Do not print any info"}};
+                                                      "Do not print any info"},
+                       {"transformation-threads",
+                        "The number of threads IR transformations optimize "
+                        "kernels on. Default = the hardware concurrency."},
+                       {"pass-manager-max-iterations",
+                        "The maximum number of times a PassManager repeats "
+                        "a fixed-point group of passes. Default = 10."},
+                       {"pass-manager-budget-ms",
+                        "The time in milliseconds a PassManager spends on a "
+                        "fixed-point group of passes. Default = no limit."}};
     return desc;
   }
 
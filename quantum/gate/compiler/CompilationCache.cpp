@@ -0,0 +1,723 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "CompilationCache.hpp"
+#include "ConditionalFunction.hpp"
+#include "IRGenerator.hpp"
+#include "IRProvider.hpp"
+#include "StructuralHash.hpp"
+#include "XACC.hpp"
+#include "xacc_service.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <set>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+
+// Bump whenever the binary format or the key changes
+const std::uint32_t formatVersion = 1;
+const char magic[] = "XACCIR";
+const std::string entrySuffix = ".xir";
+
+// Appends little-endian values to a byte string
+class Writer {
+public:
+  std::string bytes;
+
+  void u8(const std::uint8_t v) { bytes.push_back(static_cast<char>(v)); }
+  void u32(const std::uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+      u8(v >> (8 * i));
+    }
+  }
+  void i32(const int v) { u32(static_cast<std::uint32_t>(v)); }
+  void f64(const double v) {
+    std::uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    u32(b);
+    u32(b >> 32);
+  }
+  void str(const std::string &s) {
+    u32(s.size());
+    bytes += s;
+  }
+  void ints(const std::vector<int> &v) {
+    u32(v.size());
+    for (auto i : v) {
+      i32(i);
+    }
+  }
+
+  void param(const InstructionParameter &p) {
+    u8(p.which());
+    switch (p.which()) {
+    case 0:
+      i32(p.as<int>());
+      break;
+    case 1:
+      f64(p.as<double>());
+      break;
+    case 2:
+      str(p.as<std::string>());
+      break;
+    case 3: {
+      auto c = p.as<std::complex<double>>();
+      f64(c.real());
+      f64(c.imag());
+      break;
+    }
+    case 4: {
+      auto v = p.as<std::vector<std::pair<int, int>>>();
+      u32(v.size());
+      for (auto &e : v) {
+        i32(e.first);
+        i32(e.second);
+      }
+      break;
+    }
+    case 5: {
+      auto v = p.as<std::vector<std::pair<double, double>>>();
+      u32(v.size());
+      for (auto &e : v) {
+        f64(e.first);
+        f64(e.second);
+      }
+      break;
+    }
+    case 6:
+      ints(p.as<std::vector<int>>());
+      break;
+    case 7: {
+      auto v = p.as<std::vector<double>>();
+      u32(v.size());
+      for (auto d : v) {
+        f64(d);
+      }
+      break;
+    }
+    case 8: {
+      auto v = p.as<std::vector<std::string>>();
+      u32(v.size());
+      for (auto &s : v) {
+        str(s);
+      }
+      break;
+    }
+    }
+  }
+
+  void params(const std::vector<InstructionParameter> &ps) {
+    u32(ps.size());
+    for (auto &p : ps) {
+      param(p);
+    }
+  }
+
+  void options(const std::map<std::string, InstructionParameter> &opts) {
+    u32(opts.size());
+    for (auto &kv : opts) {
+      str(kv.first);
+      param(kv.second);
+    }
+  }
+
+  // Returns false for IR the format cannot store
+  bool function(std::shared_ptr<Function> f) {
+    auto conditional = std::dynamic_pointer_cast<ConditionalFunction>(f);
+    if (conditional) {
+      u8('C');
+      i32(conditional->getConditionalQubit());
+    } else if (std::dynamic_pointer_cast<GateFunction>(f)) {
+      u8('G');
+    } else {
+      return false;
+    }
+    str(f->name());
+    params(f->getParameters());
+    ints(f->getBitMap());
+    options(f->getOptions());
+
+    u32(f->nInstructions());
+    for (auto &inst : f->getInstructions()) {
+      if (inst->isComposite()) {
+        if (!function(std::dynamic_pointer_cast<Function>(inst))) {
+          return false;
+        }
+        continue;
+      }
+
+      if (std::dynamic_pointer_cast<GateInstruction>(inst)) {
+        if (!creatable(inst->name())) {
+          return false;
+        }
+        u8('I');
+        str(inst->name());
+        ints(inst->bits());
+        params(inst->getParameters());
+      } else if (std::dynamic_pointer_cast<IRGenerator>(inst)) {
+        u8('R');
+        str(inst->name());
+      } else {
+        return false;
+      }
+      u8(inst->isEnabled());
+      options(inst->getOptions());
+    }
+    return true;
+  }
+
+protected:
+  std::map<std::string, bool> registered;
+
+  bool creatable(const std::string &name) {
+    auto it = registered.find(name);
+    if (it == registered.end()) {
+      it = registered
+               .insert({name, xacc::hasService<GateInstruction>(name)})
+               .first;
+    }
+    return it->second;
+  }
+};
+
+// Reads the values of a Writer back, failing on truncated input
+class Reader {
+public:
+  const std::string &bytes;
+  std::size_t pos = 0;
+  bool ok = true;
+
+  Reader(const std::string &b) : bytes(b) {}
+
+  bool has(const std::size_t n) {
+    ok = ok && n <= bytes.size() - pos;
+    return ok;
+  }
+
+  std::uint8_t u8() {
+    return has(1) ? static_cast<std::uint8_t>(bytes[pos++]) : 0;
+  }
+  std::uint32_t u32() {
+    if (!has(4)) {
+      return 0;
+    }
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+      v |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(bytes[pos++]))
+           << (8 * i);
+    }
+    return v;
+  }
+  int i32() { return static_cast<int>(u32()); }
+  double f64() {
+    std::uint64_t b = u32();
+    b |= static_cast<std::uint64_t>(u32()) << 32;
+    double v;
+    std::memcpy(&v, &b, sizeof(v));
+    return v;
+  }
+  std::string str() {
+    auto n = u32();
+    if (!has(n)) {
+      return "";
+    }
+    pos += n;
+    return bytes.substr(pos - n, n);
+  }
+  // Every element takes at least one byte, so a count
+  // beyond the remaining bytes is corrupt
+  std::uint32_t count() {
+    auto n = u32();
+    return has(n) ? n : 0;
+  }
+  std::vector<int> ints() {
+    std::vector<int> v(count());
+    for (auto &i : v) {
+      i = i32();
+    }
+    return v;
+  }
+
+  InstructionParameter param() {
+    switch (u8()) {
+    case 0:
+      return InstructionParameter(i32());
+    case 1:
+      return InstructionParameter(f64());
+    case 2:
+      return InstructionParameter(str());
+    case 3: {
+      auto re = f64();
+      return InstructionParameter(std::complex<double>(re, f64()));
+    }
+    case 4: {
+      std::vector<std::pair<int, int>> v(count());
+      for (auto &e : v) {
+        e.first = i32();
+        e.second = i32();
+      }
+      return InstructionParameter(v);
+    }
+    case 5: {
+      std::vector<std::pair<double, double>> v(count());
+      for (auto &e : v) {
+        e.first = f64();
+        e.second = f64();
+      }
+      return InstructionParameter(v);
+    }
+    case 6:
+      return InstructionParameter(ints());
+    case 7: {
+      std::vector<double> v(count());
+      for (auto &d : v) {
+        d = f64();
+      }
+      return InstructionParameter(v);
+    }
+    case 8: {
+      std::vector<std::string> v(count());
+      for (auto &s : v) {
+        s = str();
+      }
+      return InstructionParameter(v);
+    }
+    }
+    ok = false;
+    return InstructionParameter(0);
+  }
+
+  std::vector<InstructionParameter> params() {
+    std::vector<InstructionParameter> ps(count());
+    for (auto &p : ps) {
+      p = param();
+    }
+    return ps;
+  }
+
+  std::map<std::string, InstructionParameter> options() {
+    std::map<std::string, InstructionParameter> opts;
+    auto n = count();
+    for (int i = 0; i < n && ok; i++) {
+      auto name = str();
+      opts.insert({name, param()});
+    }
+    return opts;
+  }
+
+  std::shared_ptr<GateFunction> function(const std::uint8_t tag) {
+    std::shared_ptr<GateFunction> f;
+    if (tag == 'C') {
+      auto qubit = i32();
+      str();
+      f = std::make_shared<ConditionalFunction>(qubit);
+      for (auto &p : params()) {
+        f->addParameter(p);
+      }
+    } else if (tag == 'G') {
+      auto name = str();
+      f = std::make_shared<GateFunction>(name, params());
+    } else {
+      ok = false;
+      return nullptr;
+    }
+    auto bitMap = ints();
+    if (!bitMap.empty()) {
+      f->setBitMap(bitMap);
+    }
+    for (auto &kv : options()) {
+      f->setOption(kv.first, kv.second);
+    }
+
+    auto n = count();
+    for (int i = 0; i < n && ok; i++) {
+      auto kind = u8();
+      if (kind == 'G' || kind == 'C') {
+        auto child = function(kind);
+        if (child) {
+          f->addInstruction(child);
+        }
+        continue;
+      }
+
+      InstPtr inst;
+      if (kind == 'I') {
+        auto name = str();
+        auto bits = ints();
+        auto ps = params();
+        // Copy a prototype rather than going through the
+        // service registry for every gate
+        auto &prototype = prototypes[name];
+        if (!prototype && ok && xacc::hasService<GateInstruction>(name)) {
+          prototype = xacc::getService<GateInstruction>(name);
+        }
+        if (!prototype) {
+          ok = false;
+          break;
+        }
+        auto gate = prototype->clone();
+        gate->setBits(bits);
+        for (int p = 0; p < ps.size() && p < gate->nParameters(); p++) {
+          gate->setParameter(p, ps[p]);
+        }
+        inst = gate;
+      } else if (kind == 'R') {
+        auto name = str();
+        if (!ok || !xacc::hasService<IRGenerator>(name)) {
+          ok = false;
+          break;
+        }
+        inst = xacc::getService<IRGenerator>(name);
+      } else {
+        ok = false;
+        break;
+      }
+
+      auto enabled = u8();
+      for (auto &kv : options()) {
+        inst->setOption(kv.first, kv.second);
+      }
+      if (!ok) {
+        break;
+      }
+      f->addInstruction(inst);
+      if (enabled) {
+        inst->enable();
+      } else {
+        inst->disable();
+      }
+    }
+    return ok ? f : nullptr;
+  }
+
+protected:
+  std::map<std::string, std::shared_ptr<GateInstruction>> prototypes;
+};
+
+/**
+ * Holds an exclusive lock on a cache directory while in scope, so that
+ * processes sharing the directory update its index one at a time.
+ */
+class DirectoryLock {
+public:
+  DirectoryLock(const std::string &directory)
+      : fd(open((directory + "/lock").c_str(), O_RDWR | O_CREAT, 0644)) {
+    if (fd >= 0) {
+      flock(fd, LOCK_EX);
+    }
+  }
+  ~DirectoryLock() {
+    if (fd >= 0) {
+      flock(fd, LOCK_UN);
+      close(fd);
+    }
+  }
+
+protected:
+  int fd;
+};
+
+std::string hex(const std::uint64_t v) {
+  char s[17];
+  std::snprintf(s, sizeof(s), "%016llx", static_cast<unsigned long long>(v));
+  return s;
+}
+
+} // namespace
+
+CompilationCache::CompilationCache(const std::string &dir,
+                                   const std::size_t max)
+    : directory(dir), maxBytes(max) {
+  // Create the directory and any missing parents
+  for (auto i = directory.find('/', 1); ; i = directory.find('/', i + 1)) {
+    auto prefix = directory.substr(0, i);
+    if (!prefix.empty() && !xacc::directoryExists(prefix)) {
+      mkdir(prefix.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    }
+    if (i == std::string::npos) {
+      break;
+    }
+  }
+  if (!xacc::directoryExists(directory)) {
+    xacc::error("CompilationCache could not create " + directory);
+  }
+  DirectoryLock lock(directory);
+  loadIndex(true);
+  evict();
+  saveIndex();
+}
+
+std::string CompilationCache::key(std::shared_ptr<Compiler> compiler,
+                                  const std::string &src,
+                                  std::shared_ptr<Accelerator> acc) {
+  // Two independently seeded hashes make up the 128 bit key
+  StructuralHash lo, hi(0x3c6ef372fe94f82bULL);
+  auto add = [&](const std::string &s) {
+    lo.add(s);
+    hi.add(s);
+  };
+
+  lo.add(static_cast<std::uint64_t>(formatVersion));
+  hi.add(static_cast<std::uint64_t>(formatVersion));
+  add(compiler->name());
+  add(src);
+
+  // The options declared by the Compiler and Accelerator, in name order
+  auto declared = compiler->getOptions();
+  if (acc) {
+    add(acc->name());
+    for (auto &e : acc->getAcceleratorConnectivity()) {
+      add(std::to_string(e.first) + "," + std::to_string(e.second));
+    }
+    for (auto &kv : acc->getOptions()) {
+      declared.insert(kv);
+    }
+  } else {
+    add("");
+  }
+  for (auto &kv : declared) {
+    if (xacc::optionExists(kv.first)) {
+      add(kv.first);
+      add(xacc::getOption(kv.first));
+    }
+  }
+
+  return hex(hi.value()) + hex(lo.value());
+}
+
+std::shared_ptr<IR> CompilationCache::compile(std::shared_ptr<Compiler> compiler,
+                                              const std::string &src,
+                                              std::shared_ptr<Accelerator> acc) {
+  auto k = key(compiler, src, acc);
+  if (!cacheable(k)) {
+    return compiler->compile(src, acc);
+  }
+  auto ir = get(k);
+  if (!ir) {
+    ir = compiler->compile(src, acc);
+    put(k, ir);
+  }
+  return ir;
+}
+
+bool CompilationCache::cacheable(const std::string &key) {
+  std::lock_guard<std::mutex> lock(uncacheableLock);
+  return !uncacheable.count(key);
+}
+
+std::shared_ptr<IR> CompilationCache::get(const std::string &key) {
+  DirectoryLock lock(directory);
+  loadIndex(false);
+  auto it = find(key);
+  if (it == entries.end()) {
+    return nullptr;
+  }
+
+  std::ifstream in(path(key), std::ios::binary);
+  auto ir = decode(in);
+  if (!ir) {
+    // Written by another version, or damaged
+    remove(it);
+  } else {
+    entries.splice(entries.end(), entries, it);
+  }
+  saveIndex();
+  return ir;
+}
+
+bool CompilationCache::put(const std::string &key, std::shared_ptr<IR> ir) {
+  std::ostringstream s;
+  if (!encode(ir, s)) {
+    // Not gate model IR, compile it directly from now on
+    xacc::debug("CompilationCache cannot store this IR, skipping " + key);
+    std::lock_guard<std::mutex> lock(uncacheableLock);
+    uncacheable.insert(key);
+    return false;
+  }
+  auto bytes = s.str();
+
+  // Write then rename, so that readers never see a partial entry
+  auto tmp = path(key) + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+    if (!out) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+  }
+
+  DirectoryLock lock(directory);
+  std::rename(tmp.c_str(), path(key).c_str());
+  loadIndex(false);
+  auto it = find(key);
+  if (it != entries.end()) {
+    totalBytes -= it->bytes;
+    entries.erase(it);
+  }
+  entries.push_back({key, bytes.size()});
+  totalBytes += bytes.size();
+  evict();
+  saveIndex();
+  return find(key) != entries.end();
+}
+
+void CompilationCache::invalidate(const std::string &key) {
+  DirectoryLock lock(directory);
+  loadIndex(false);
+  auto it = find(key);
+  if (it != entries.end()) {
+    remove(it);
+    saveIndex();
+  }
+}
+
+void CompilationCache::clear() {
+  DirectoryLock lock(directory);
+  loadIndex(false);
+  while (!entries.empty()) {
+    remove(entries.begin());
+  }
+  saveIndex();
+}
+
+bool CompilationCache::encode(std::shared_ptr<IR> ir, std::ostream &out) {
+  Writer w;
+  w.bytes.append(magic, sizeof(magic));
+  w.u32(formatVersion);
+  auto kernels = ir->getKernels();
+  w.u32(kernels.size());
+  for (auto &k : kernels) {
+    if (!w.function(k)) {
+      return false;
+    }
+  }
+  out.write(w.bytes.data(), w.bytes.size());
+  return true;
+}
+
+std::shared_ptr<IR> CompilationCache::decode(std::istream &in) {
+  std::string bytes(std::istreambuf_iterator<char>(in), {});
+  Reader r(bytes);
+  if (!r.has(sizeof(magic)) ||
+      bytes.compare(0, sizeof(magic), std::string(magic, sizeof(magic))) != 0) {
+    return nullptr;
+  }
+  r.pos = sizeof(magic);
+  if (r.u32() != formatVersion) {
+    return nullptr;
+  }
+
+  auto ir = xacc::getService<IRProvider>("gate")->createIR();
+  auto n = r.count();
+  for (int i = 0; i < n && r.ok; i++) {
+    auto kernel = r.function(r.u8());
+    if (kernel) {
+      ir->addKernel(kernel);
+    }
+  }
+  return r.ok && r.pos == bytes.size() ? ir : nullptr;
+}
+
+std::string CompilationCache::path(const std::string &key) {
+  return directory + "/" + key + entrySuffix;
+}
+
+std::list<CompilationCache::Entry>::iterator
+CompilationCache::find(const std::string &key) {
+  return std::find_if(entries.begin(), entries.end(),
+                      [&](const Entry &e) { return e.key == key; });
+}
+
+void CompilationCache::remove(std::list<Entry>::iterator entry) {
+  std::remove(path(entry->key).c_str());
+  totalBytes -= entry->bytes;
+  entries.erase(entry);
+}
+
+void CompilationCache::evict() {
+  while (totalBytes > maxBytes && !entries.empty()) {
+    remove(entries.begin());
+  }
+}
+
+void CompilationCache::loadIndex(const bool collect) {
+  entries.clear();
+  totalBytes = 0;
+
+  auto index = directory + "/index";
+  std::ifstream in(index);
+  std::string header;
+  std::uint32_t version = 0;
+  in >> header >> version;
+
+  Entry e;
+  std::set<std::string> indexed;
+  while (version == formatVersion && in >> e.key >> e.bytes) {
+    struct stat st;
+    if (stat(path(e.key).c_str(), &st) == 0 && st.st_size == e.bytes &&
+        indexed.insert(e.key).second) {
+      entries.push_back(e);
+      totalBytes += e.bytes;
+    }
+  }
+
+  // Drop entries the index does not account for. Only those older than
+  // the index, since another process may have written an entry and not
+  // yet indexed it.
+  struct stat indexStat;
+  if (!collect || stat(index.c_str(), &indexStat) != 0) {
+    return;
+  }
+  auto dir = opendir(directory.c_str());
+  if (dir) {
+    while (auto file = readdir(dir)) {
+      std::string name = file->d_name;
+      auto filePath = directory + "/" + name;
+      struct stat st;
+      if (name.size() > entrySuffix.size() &&
+          name.compare(name.size() - entrySuffix.size(), entrySuffix.size(),
+                       entrySuffix) == 0 &&
+          !indexed.count(name.substr(0, name.size() - entrySuffix.size())) &&
+          stat(filePath.c_str(), &st) == 0 &&
+          st.st_mtime < indexStat.st_mtime) {
+        std::remove(filePath.c_str());
+      }
+    }
+    closedir(dir);
+  }
+}
+
+void CompilationCache::saveIndex() {
+  auto tmp = directory + "/index." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream out(tmp);
+    out << "xacc-compilation-cache " << formatVersion << "\n";
+    for (auto &e : entries) {
+      out << e.key << " " << e.bytes << "\n";
+    }
+  }
+  std::rename(tmp.c_str(), (directory + "/index").c_str());
+}
+
+} // namespace quantum
+} // namespace xacc
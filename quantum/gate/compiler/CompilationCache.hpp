@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_COMPILER_COMPILATIONCACHE_HPP_
+#define QUANTUM_GATE_COMPILER_COMPILATIONCACHE_HPP_
+
+#include "Compiler.hpp"
+#include <list>
+#include <mutex>
+#include <set>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The CompilationCache keeps compiled gate model IR on disk, so that
+ * compiling the same source for the same target again is a file read
+ * instead of a parse. Entries are keyed by a 128 bit hash of the source,
+ * the Compiler name, the Accelerator name and connectivity, and the
+ * values of the options that Compiler and Accelerator declare.
+ *
+ * IR is stored in a compact binary form. Entries written by another
+ * format version, or that fail to decode, are dropped on lookup. Once
+ * the entries exceed the size bound, the least recently used are evicted,
+ * in an order kept in an index file rather than taken from file times.
+ *
+ * Several processes may share a directory. Each operation takes a lock
+ * on the directory and rereads the index before changing it, so no
+ * process drops entries another one added. Entry files the index does
+ * not list are removed on open, but only once they are older than it.
+ *
+ * Kernels must be GateFunctions, possibly nesting GateFunctions and
+ * ConditionalFunctions, of Instructions the gate IRProvider can create
+ * or IRGenerators. Other IR is compiled but not cached, and its key
+ * is remembered so that later compiles skip the lookup.
+ */
+class CompilationCache {
+
+public:
+  /**
+   * Open the cache in the given directory, creating it if needed.
+   *
+   * @param directory The cache directory
+   * @param maxBytes The size bound of all entries
+   */
+  CompilationCache(const std::string &directory,
+                   const std::size_t maxBytes = 64 * 1024 * 1024);
+
+  /**
+   * Return the IR for the given source, from the cache if present,
+   * otherwise compiling it and caching the result.
+   *
+   * @param compiler The Compiler for the source
+   * @param src The kernel source
+   * @param acc The target Accelerator, may be null
+   * @return ir The compiled IR
+   */
+  std::shared_ptr<IR> compile(std::shared_ptr<Compiler> compiler,
+                              const std::string &src,
+                              std::shared_ptr<Accelerator> acc);
+
+  /**
+   * Return the cache key for compiling the given source.
+   *
+   * @param compiler The Compiler for the source
+   * @param src The kernel source
+   * @param acc The target Accelerator, may be null
+   * @return key The key, 32 hex digits
+   */
+  static std::string key(std::shared_ptr<Compiler> compiler,
+                         const std::string &src,
+                         std::shared_ptr<Accelerator> acc);
+
+  /**
+   * Return false if put() could not store the IR for the given key
+   * before, so that there is no point looking it up.
+   *
+   * @param key The cache key
+   * @return cacheable False if the IR for the key is not cached
+   */
+  bool cacheable(const std::string &key);
+
+  /**
+   * Return the cached IR for the given key, or null.
+   *
+   * @param key The cache key
+   * @return ir The cached IR
+   */
+  std::shared_ptr<IR> get(const std::string &key);
+
+  /**
+   * Cache the given IR under the given key, evicting the least
+   * recently used entries beyond the size bound.
+   *
+   * @param key The cache key
+   * @param ir The IR to cache
+   * @return cached False if the IR cannot be stored
+   */
+  bool put(const std::string &key, std::shared_ptr<IR> ir);
+
+  /**
+   * Remove the entry for the given key, if any.
+   *
+   * @param key The cache key
+   */
+  void invalidate(const std::string &key);
+
+  /**
+   * Remove all entries.
+   */
+  void clear();
+
+  /**
+   * Return the number of entries, as of the last operation.
+   */
+  const int size() { return entries.size(); }
+
+  /**
+   * Return the total size of the entries in bytes, as of the last operation.
+   */
+  const std::size_t bytes() { return totalBytes; }
+
+  /**
+   * Write the given IR in the binary cache format.
+   *
+   * @param ir The IR to write
+   * @param out The stream to write to
+   * @return written False if the IR holds Instructions the format cannot store
+   */
+  static bool encode(std::shared_ptr<IR> ir, std::ostream &out);
+
+  /**
+   * Read IR in the binary cache format.
+   *
+   * @param in The stream to read from
+   * @return ir The IR, or null if the stream is not valid
+   */
+  static std::shared_ptr<IR> decode(std::istream &in);
+
+protected:
+  struct Entry {
+    std::string key;
+    std::size_t bytes;
+  };
+
+  std::string directory;
+  std::size_t maxBytes;
+  std::size_t totalBytes = 0;
+
+  /**
+   * The entries, least recently used first.
+   */
+  std::list<Entry> entries;
+
+  /**
+   * The keys of IR that put() could not store.
+   */
+  std::set<std::string> uncacheable;
+  std::mutex uncacheableLock;
+
+  std::string path(const std::string &key);
+  std::list<Entry>::iterator find(const std::string &key);
+  void remove(std::list<Entry>::iterator entry);
+  void evict();
+
+  /**
+   * Reread the index, which the caller holds the directory lock for.
+   *
+   * @param collect True to also remove unindexed entries older than the index
+   */
+  void loadIndex(const bool collect);
+  void saveIndex();
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,532 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "PeepholeOptimizer.hpp"
+#include "ConditionalFunction.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+const double tolerance = 1e-12;
+
+/**
+ * Recursive descent parser for sums of terms, where a term is a
+ * product of numbers and at most one variable, like 2 * theta - 0.5.
+ * Anything else, parentheses and functions included, is rejected.
+ */
+class AngleParser {
+public:
+  AngleParser(const std::string &s) : str(s) {}
+
+  bool parse(xacc::quantum::LinearAngle &angle) {
+    if (!sum(angle)) {
+      return false;
+    }
+    skipSpace();
+    return pos == str.size();
+  }
+
+protected:
+  void skipSpace() {
+    while (pos < str.size() && std::isspace(str[pos])) {
+      pos++;
+    }
+  }
+
+  bool sum(xacc::quantum::LinearAngle &angle) {
+    double sign = 1.0;
+    while (true) {
+      double c;
+      std::string var;
+      if (!term(c, var)) {
+        return false;
+      }
+      xacc::quantum::LinearAngle t;
+      if (var.empty()) {
+        t.constant = sign * c;
+      } else {
+        t.coefficient = sign * c;
+        t.variable = var;
+      }
+      if (!angle.add(t)) {
+        return false;
+      }
+
+      skipSpace();
+      if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+        sign = str[pos] == '-' ? -1.0 : 1.0;
+        pos++;
+      } else {
+        return true;
+      }
+    }
+  }
+
+  bool term(double &c, std::string &var) {
+    c = 1.0;
+    var.clear();
+    bool divide = false;
+    while (true) {
+      double fc;
+      std::string fv;
+      if (!factor(fc, fv)) {
+        return false;
+      }
+      if (!fv.empty()) {
+        // Dividing by the variable, or a product of two, is not linear
+        if (divide || !var.empty()) {
+          return false;
+        }
+        var = fv;
+      }
+      if (divide) {
+        if (fc == 0.0) {
+          return false;
+        }
+        c /= fc;
+      } else {
+        c *= fc;
+      }
+
+      skipSpace();
+      if (pos < str.size() && (str[pos] == '*' || str[pos] == '/')) {
+        divide = str[pos] == '/';
+        pos++;
+      } else {
+        return true;
+      }
+    }
+  }
+
+  bool factor(double &c, std::string &var) {
+    c = 1.0;
+    skipSpace();
+    while (pos < str.size() && (str[pos] == '-' || str[pos] == '+')) {
+      if (str[pos] == '-') {
+        c = -c;
+      }
+      pos++;
+      skipSpace();
+    }
+    if (pos == str.size()) {
+      return false;
+    }
+
+    if (std::isdigit(str[pos]) || str[pos] == '.') {
+      char *end;
+      auto start = str.c_str() + pos;
+      auto value = std::strtod(start, &end);
+      if (end == start) {
+        return false;
+      }
+      pos += end - start;
+      c *= value;
+    } else if (std::isalpha(str[pos]) || str[pos] == '_') {
+      auto start = pos;
+      while (pos < str.size() && (std::isalnum(str[pos]) || str[pos] == '_')) {
+        pos++;
+      }
+      var = str.substr(start, pos - start);
+      if (var == "pi") {
+        var.clear();
+        c *= M_PI;
+      }
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  const std::string &str;
+  std::size_t pos = 0;
+};
+
+} // namespace
+
+namespace xacc {
+namespace quantum {
+
+bool LinearAngle::parse(const InstructionParameter &p, LinearAngle &angle) {
+  angle = LinearAngle();
+  if (p.which() == 0) {
+    angle.constant = p.as<int>();
+    return true;
+  } else if (p.which() == 1) {
+    angle.constant = p.as<double>();
+    return true;
+  } else if (p.which() == 2) {
+    AngleParser parser(p.as<std::string>());
+    return parser.parse(angle);
+  }
+  return false;
+}
+
+bool LinearAngle::add(const LinearAngle &other) {
+  if (!other.variable.empty()) {
+    if (variable.empty()) {
+      variable = other.variable;
+    } else if (variable != other.variable) {
+      return false;
+    }
+  }
+  coefficient += other.coefficient;
+  constant += other.constant;
+  return true;
+}
+
+const bool LinearAngle::isZero() const {
+  return std::fabs(coefficient) < tolerance && std::fabs(constant) < tolerance;
+}
+
+InstructionParameter LinearAngle::toParameter() const {
+  if (variable.empty() || std::fabs(coefficient) < tolerance) {
+    return InstructionParameter(constant);
+  }
+
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<double>::max_digits10);
+  if (std::fabs(coefficient - 1.0) < tolerance) {
+    ss << variable;
+  } else if (std::fabs(coefficient + 1.0) < tolerance) {
+    ss << "-" << variable;
+  } else {
+    ss << coefficient << " * " << variable;
+  }
+  if (std::fabs(constant) >= tolerance) {
+    ss << (constant < 0 ? " - " : " + ") << std::fabs(constant);
+  }
+  return InstructionParameter(ss.str());
+}
+
+PeepholeOptimizer::PeepholeOptimizer(std::shared_ptr<GateFunction> function,
+                                     const int w)
+    : window(w) {
+  // The last slot on each qubit
+  std::vector<int> last;
+  collect(function.get(), last);
+
+  alive.assign(gates.size(), true);
+  queued.assign(gates.size(), true);
+  worklist.reserve(gates.size());
+  for (int node = gates.size() - 1; node >= 0; node--) {
+    worklist.push_back(node);
+  }
+}
+
+void PeepholeOptimizer::collect(GateFunction *function,
+                                std::vector<int> &last) {
+  for (int i = 0; i < function->nInstructions(); i++) {
+    auto inst = function->getInstruction(i);
+    if (!inst->isEnabled()) {
+      continue;
+    }
+
+    int opcode = -1;
+    if (inst->isComposite()) {
+      // Nested functions are optimized gate by gate,
+      // conditionals are kept whole as barriers
+      if (!std::dynamic_pointer_cast<ConditionalFunction>(inst)) {
+        auto child = std::dynamic_pointer_cast<GateFunction>(inst);
+        if (child) {
+          collect(child.get(), last);
+        }
+        continue;
+      }
+    } else {
+      GateOp op;
+      if (GateTape::opcode(inst->name(), op)) {
+        opcode = static_cast<int>(op);
+      }
+    }
+
+    auto bits = inst->bits();
+    if (bits.empty()) {
+      continue;
+    }
+
+    int node = gates.size();
+    gates.push_back(inst);
+    opcodes.push_back(opcode);
+    parents.push_back(function);
+    indices.push_back(i);
+    for (auto b : bits) {
+      if (b >= last.size()) {
+        last.resize(b + 1, -1);
+      }
+      int slot = slotNode.size();
+      slotNode.push_back(node);
+      slotBit.push_back(b);
+      prev.push_back(last[b]);
+      next.push_back(-1);
+      if (last[b] >= 0) {
+        next[last[b]] = slot;
+      }
+      last[b] = slot;
+    }
+    slotOffsets.push_back(slotNode.size());
+  }
+}
+
+int PeepholeOptimizer::run() {
+  while (!worklist.empty()) {
+    auto node = worklist.back();
+    worklist.pop_back();
+    queued[node] = false;
+    if (alive[node]) {
+      rewrite(node);
+    }
+  }
+  return nRemoved;
+}
+
+void PeepholeOptimizer::enqueue(const int node) {
+  if (node >= 0 && alive[node] && !queued[node]) {
+    queued[node] = true;
+    worklist.push_back(node);
+  }
+}
+
+void PeepholeOptimizer::enqueueBefore(const int node) {
+  for (int s = slotOffsets[node]; s < slotOffsets[node + 1]; s++) {
+    int steps = 0;
+    for (int t = prev[s]; t >= 0 && steps < window; t = prev[t], steps++) {
+      enqueue(slotNode[t]);
+    }
+  }
+}
+
+void PeepholeOptimizer::remove(const int node) {
+  // Gates before this one may now reach a partner past it
+  enqueueBefore(node);
+  for (int s = slotOffsets[node]; s < slotOffsets[node + 1]; s++) {
+    if (prev[s] >= 0) {
+      next[prev[s]] = next[s];
+    }
+    if (next[s] >= 0) {
+      prev[next[s]] = prev[s];
+    }
+  }
+  alive[node] = false;
+  gates[node]->disable();
+  nRemoved++;
+}
+
+void PeepholeOptimizer::replaceAngle(const int node,
+                                     const LinearAngle &angle) {
+  auto gate = std::dynamic_pointer_cast<GateInstruction>(gates[node]);
+  auto replacement = gate->clone();
+  replacement->setBits(gate->bits());
+  auto p = angle.toParameter();
+  replacement->setParameter(0, p);
+
+  // The parent keeps its variables and evaluation plan in sync
+  parents[node]->replaceInstruction(indices[node], replacement);
+  gates[node] = replacement;
+  enqueue(node);
+  enqueueBefore(node);
+}
+
+int PeepholeOptimizer::slotOnWire(const int node, const int slot) const {
+  for (int s = slotOffsets[node]; s < slotOffsets[node + 1]; s++) {
+    if (slotBit[s] == slotBit[slot]) {
+      return s;
+    }
+  }
+  return -1;
+}
+
+PeepholeOptimizer::Action PeepholeOptimizer::action(const int slot) {
+  auto node = slotNode[slot];
+  if (opcodes[node] < 0) {
+    return Action::Other;
+  }
+
+  auto control = slot == slotOffsets[node];
+  switch (static_cast<GateOp>(opcodes[node])) {
+  case GateOp::I:
+  case GateOp::Z:
+  case GateOp::S:
+  case GateOp::Sdg:
+  case GateOp::T:
+  case GateOp::Tdg:
+  case GateOp::Rz:
+  case GateOp::CZ:
+  case GateOp::CPhase:
+  case GateOp::CRZ:
+    return Action::Diagonal;
+  case GateOp::X:
+  case GateOp::Rx:
+    return Action::XLike;
+  case GateOp::CNOT:
+    return control ? Action::Diagonal : Action::XLike;
+  case GateOp::CY:
+  case GateOp::CH:
+    return control ? Action::Diagonal : Action::Other;
+  default:
+    return Action::Other;
+  }
+}
+
+bool PeepholeOptimizer::commute(const int a, const int b) {
+  // Gates commute if on each shared qubit they are both diagonal
+  // in the Z basis, or both diagonal in the X basis
+  for (int s = slotOffsets[a]; s < slotOffsets[a + 1]; s++) {
+    auto t = slotOnWire(b, s);
+    if (t >= 0) {
+      auto act = action(s);
+      if (act == Action::Other || act != action(t)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool PeepholeOptimizer::matches(const int a, const int b) const {
+  if (opcodes[a] != opcodes[b] ||
+      slotOffsets[a + 1] - slotOffsets[a] != slotOffsets[b + 1] - slotOffsets[b]) {
+    return false;
+  }
+  for (int k = 0; k < slotOffsets[a + 1] - slotOffsets[a]; k++) {
+    if (slotBit[slotOffsets[a] + k] != slotBit[slotOffsets[b] + k]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int PeepholeOptimizer::findPartner(const int node) {
+  auto first = slotOffsets[node];
+
+  // Walk the first qubit up to the first gate that does not commute
+  int partner = -1, steps = 0;
+  for (int t = next[first]; t >= 0 && steps < window; t = next[t], steps++) {
+    auto u = slotNode[t];
+    if (matches(node, u)) {
+      partner = u;
+      break;
+    }
+    if (!commute(node, u)) {
+      return -1;
+    }
+  }
+  if (partner < 0) {
+    return -1;
+  }
+
+  // The other qubits must reach the same gate past commuting ones
+  for (int s = first + 1; s < slotOffsets[node + 1]; s++) {
+    bool found = false;
+    steps = 0;
+    for (int t = next[s]; t >= 0 && steps < window; t = next[t], steps++) {
+      auto u = slotNode[t];
+      if (u == partner) {
+        found = true;
+        break;
+      }
+      if (!commute(node, u)) {
+        return -1;
+      }
+    }
+    if (!found) {
+      return -1;
+    }
+  }
+  return partner;
+}
+
+bool PeepholeOptimizer::isRotation(const int node) const {
+  auto op = static_cast<GateOp>(opcodes[node]);
+  return op == GateOp::Rx || op == GateOp::Ry || op == GateOp::Rz;
+}
+
+bool PeepholeOptimizer::isSelfInverse(const int node) const {
+  switch (static_cast<GateOp>(opcodes[node])) {
+  case GateOp::H:
+  case GateOp::X:
+  case GateOp::Y:
+  case GateOp::Z:
+  case GateOp::CNOT:
+  case GateOp::CZ:
+  case GateOp::Swap:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool PeepholeOptimizer::angle(const int node, LinearAngle &a) {
+  auto p = gates[node]->getParameter(0);
+  if (p.which() > 2) {
+    xacc::error("CircuitOptimizer: invalid gate parameter " +
+                std::to_string(p.which()) + ", " + p.toString());
+  }
+  return LinearAngle::parse(p, a);
+}
+
+bool PeepholeOptimizer::rewrite(const int node) {
+  if (opcodes[node] < 0) {
+    return false;
+  }
+
+  auto rotation = isRotation(node);
+  LinearAngle a;
+  if (rotation) {
+    // Remove Rx, Ry and Rz by zero
+    if (!angle(node, a)) {
+      return false;
+    } else if (a.isZero()) {
+      remove(node);
+      return true;
+    }
+  } else if (!isSelfInverse(node)) {
+    return false;
+  }
+
+  auto other = findPartner(node);
+  if (other < 0) {
+    return false;
+  }
+
+  if (!rotation) {
+    remove(node);
+    remove(other);
+    return true;
+  }
+
+  // Merge the two rotations, into the one carrying a variable
+  LinearAngle b;
+  if (!angle(other, b) || !a.add(b)) {
+    return false;
+  }
+  if (a.isZero()) {
+    remove(node);
+    remove(other);
+  } else {
+    auto keep = node, drop = other;
+    if (!gates[node]->getParameter(0).isVariable() &&
+        gates[other]->getParameter(0).isVariable()) {
+      std::swap(keep, drop);
+    }
+    remove(drop);
+    replaceAngle(keep, a);
+  }
+  return true;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_COMPILER_PEEPHOLEOPTIMIZER_HPP_
+#define QUANTUM_GATE_COMPILER_PEEPHOLEOPTIMIZER_HPP_
+
+#include "GateFunction.hpp"
+#include "GateTape.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * A rotation angle of the form coefficient * variable + constant,
+ * the form of the angles of parameterized Trotter and UCCSD circuits.
+ */
+struct LinearAngle {
+  double coefficient = 0.0;
+  double constant = 0.0;
+  std::string variable;
+
+  /**
+   * Parse a numeric or string gate parameter.
+   *
+   * @param p The gate parameter
+   * @param angle The parsed angle
+   * @return linear False if p is not linear in at most one variable
+   */
+  static bool parse(const InstructionParameter &p, LinearAngle &angle);
+
+  /**
+   * Add the given angle to this one.
+   *
+   * @return linear False if the two angles use different variables
+   */
+  bool add(const LinearAngle &other);
+
+  const bool isZero() const;
+
+  /**
+   * Return this angle as a double, or as an expression
+   * string if it depends on a variable.
+   */
+  InstructionParameter toParameter() const;
+};
+
+/**
+ * The PeepholeOptimizer applies local rewrites to a GateFunction
+ * until none apply. It keeps the circuit as a live DAG, with every
+ * gate linked to the previous and next gate on each of its qubits.
+ * Removing a gate relinks its neighbours in O(number of qubits) and
+ * puts the gates just before it back on the worklist, so only gates
+ * near a change are looked at again and a full run is close to linear
+ * in circuit size.
+ *
+ * Each gate looks ahead a bounded window for a partner, stepping over
+ * gates it commutes with. Gates diagonal in Z (Rz, Z, S, T, CZ and
+ * CNOT controls) commute, as do gates that are functions of X (Rx, X
+ * and CNOT targets). A self-inverse partner (H, X, Y, Z, CNOT, CZ,
+ * Swap) cancels, a rotation about the same axis is merged into one,
+ * with numeric or symbolic angles.
+ *
+ * Removed gates are disabled in the GateFunction, not erased. Merged
+ * rotations are swapped in with GateFunction::replaceInstruction.
+ * Gates of a ConditionalFunction are never rewritten, and the
+ * conditional is a barrier on its qubits.
+ */
+class PeepholeOptimizer {
+
+public:
+  /**
+   * Build the live DAG of the enabled gates of the given function.
+   *
+   * @param function The circuit to optimize
+   * @param window The number of gates to look past for a partner
+   */
+  PeepholeOptimizer(std::shared_ptr<GateFunction> function,
+                    const int window = 16);
+
+  /**
+   * Apply rewrites until the worklist is empty.
+   *
+   * @return nRemoved The number of gates removed
+   */
+  int run();
+
+protected:
+  void collect(GateFunction *function, std::vector<int> &last);
+
+  // Try each rewrite at the given gate, true if one applied
+  bool rewrite(const int node);
+
+  // The first gate after node that it could cancel or merge with
+  // if they were adjacent, with only commuting gates in between
+  int findPartner(const int node);
+
+  // How a gate acts on the qubit of the given slot
+  enum class Action { Diagonal, XLike, Other };
+  Action action(const int slot);
+  bool commute(const int a, const int b);
+
+  // Disable the gate, link its neighbours and queue the gates before it
+  void remove(const int node);
+
+  // Swap in a rotation by the given angle for this gate
+  void replaceAngle(const int node, const LinearAngle &angle);
+
+  void enqueue(const int node);
+
+  // Queue the gates up to a window before node on each of its qubits
+  void enqueueBefore(const int node);
+
+  // The slot of node on the same qubit as the given slot, or -1
+  int slotOnWire(const int node, const int slot) const;
+
+  // Same gate on the same qubits in the same order
+  bool matches(const int a, const int b) const;
+
+  bool isRotation(const int node) const;
+  bool isSelfInverse(const int node) const;
+  bool angle(const int node, LinearAngle &a);
+
+  int window;
+
+  std::vector<InstPtr> gates;
+  // The GateOp of each gate, or -1 for gates to leave alone
+  std::vector<int> opcodes;
+  std::vector<bool> alive;
+
+  // The function holding each gate, and its index there
+  std::vector<GateFunction *> parents;
+  std::vector<int> indices;
+
+  // Each gate has one slot per qubit, slots of gate v are
+  // slotOffsets[v] to slotOffsets[v+1]
+  std::vector<int> slotOffsets{0};
+  std::vector<int> slotNode;
+  std::vector<int> slotBit;
+  std::vector<int> prev;
+  std::vector<int> next;
+
+  std::vector<int> worklist;
+  std::vector<bool> queued;
+  int nRemoved = 0;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
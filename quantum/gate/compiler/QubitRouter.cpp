@@ -0,0 +1,659 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "QubitRouter.hpp"
+#include "ConditionalFunction.hpp"
+#include "DigitalGates.hpp"
+#include "GateIR.hpp"
+#include "XACC.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+
+const int unreachable = std::numeric_limits<int>::max() / 4;
+
+// Weight of the look-ahead gates relative to the front layer
+const double lookaheadWeight = 0.5;
+
+// Decay added to a qubit each time it is swapped, so that
+// parallel Swaps are preferred over serial ones
+const double decayIncrement = 0.001;
+const int decayReset = 5;
+
+// One routable operation, a leaf gate or a whole conditional
+struct Op {
+  InstPtr inst;
+  std::vector<int> qubits;
+  bool conditional = false;
+};
+
+// A routing step, an Op or a Swap of two physical qubits
+struct Step {
+  int op;
+  int p1;
+  int p2;
+};
+
+// A front or extended gate between physical qubits, linked into
+// a list per qubit
+struct Touch {
+  int qubit;
+  int other;
+  int distance;
+  bool isFront;
+  int next;
+};
+
+// The coupling graph over physical qubit indices 0..n-1
+class Coupling {
+public:
+  int n;
+  std::vector<int> ids;
+  std::vector<std::vector<int>> neighbors;
+  // The undirected edges, and the edge to each neighbor
+  std::vector<std::pair<int, int>> edges;
+  std::vector<std::vector<int>> edgeIds;
+  std::vector<int> distance;
+  std::vector<char> forward;
+
+  Coupling(const std::vector<std::pair<int, int>> &connectivity) {
+    for (auto &e : connectivity) {
+      ids.push_back(e.first);
+      ids.push_back(e.second);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    n = ids.size();
+
+    neighbors.resize(n);
+    forward.assign(n * n, 0);
+    for (auto &e : connectivity) {
+      auto a = index(e.first), b = index(e.second);
+      if (a == b || forward[a * n + b]) {
+        continue;
+      }
+      forward[a * n + b] = 1;
+      if (!forward[b * n + a]) {
+        neighbors[a].push_back(b);
+        neighbors[b].push_back(a);
+      }
+    }
+    edgeIds.resize(n);
+    for (int a = 0; a < n; a++) {
+      std::sort(neighbors[a].begin(), neighbors[a].end());
+      for (auto b : neighbors[a]) {
+        if (a < b) {
+          edges.push_back({a, b});
+        }
+      }
+    }
+    for (int a = 0; a < n; a++) {
+      for (auto b : neighbors[a]) {
+        auto e = std::lower_bound(edges.begin(), edges.end(),
+                                  std::make_pair(std::min(a, b), std::max(a, b)));
+        edgeIds[a].push_back(e - edges.begin());
+      }
+    }
+
+    // All pairs shortest paths by BFS from each qubit
+    distance.assign(n * n, unreachable);
+    std::vector<int> queue(n);
+    for (int s = 0; s < n; s++) {
+      auto row = &distance[s * n];
+      row[s] = 0;
+      int head = 0, tail = 0;
+      queue[tail++] = s;
+      while (head < tail) {
+        auto p = queue[head++];
+        for (auto nb : neighbors[p]) {
+          if (row[nb] == unreachable) {
+            row[nb] = row[p] + 1;
+            queue[tail++] = nb;
+          }
+        }
+      }
+    }
+  }
+
+  int index(const int id) const {
+    return std::lower_bound(ids.begin(), ids.end(), id) - ids.begin();
+  }
+
+  int d(const int a, const int b) const { return distance[a * n + b]; }
+};
+
+// SABRE routing of the Ops in a given order
+class Sabre {
+public:
+  Sabre(const Coupling &coupling, const std::vector<Op> &ops,
+        const int nLogical, const int lookahead)
+      : coupling(coupling), ops(ops), nLogical(nLogical),
+        lookahead(lookahead) {}
+
+  /**
+   * Route the Ops in the given order starting from the given
+   * logical to physical layout, which is left as the final layout.
+   * Returns the number of Swaps inserted.
+   */
+  int run(const std::vector<int> &order, std::vector<int> &layout,
+          std::vector<Step> *steps) {
+    auto n = order.size();
+    auto P = coupling.n;
+
+    // The qubits of each two-qubit gate, second is -1 for
+    // gates that need no routing
+    std::vector<int> first(n), second(n, -1);
+    for (int pos = 0; pos < n; pos++) {
+      auto &op = ops[order[pos]];
+      if (!op.conditional && op.qubits.size() == 2) {
+        first[pos] = op.qubits[0];
+        second[pos] = op.qubits[1];
+      }
+    }
+
+    // Build the dependency DAG over positions in the order
+    std::vector<int> nPreds(n, 0), succOffsets(n + 1, 0), succs;
+    std::vector<std::pair<int, int>> deps;
+    std::vector<int> last(nLogical, -1);
+    for (int pos = 0; pos < n; pos++) {
+      for (auto q : ops[order[pos]].qubits) {
+        auto prev = last[q];
+        if (prev != -1 && (deps.empty() || deps.back() != std::make_pair(prev, pos))) {
+          deps.push_back({prev, pos});
+          nPreds[pos]++;
+          succOffsets[prev + 1]++;
+        }
+        last[q] = pos;
+      }
+    }
+    for (int pos = 0; pos < n; pos++) {
+      succOffsets[pos + 1] += succOffsets[pos];
+    }
+    succs.resize(deps.size());
+    auto fill = succOffsets;
+    for (auto &dep : deps) {
+      succs[fill[dep.first]++] = dep.second;
+    }
+
+    std::vector<int> inverse(P, -1);
+    for (int l = 0; l < nLogical; l++) {
+      inverse[layout[l]] = l;
+    }
+
+    std::vector<int> front;
+    for (int pos = 0; pos < n; pos++) {
+      if (nPreds[pos] == 0) {
+        front.push_back(pos);
+      }
+    }
+
+    std::vector<double> decay(P, 1.0);
+    std::vector<int> extended, stamp(n, -1), queue, kept, candidates;
+    std::vector<int> head(P, -1), edgeStamp(coupling.edges.size(), -1);
+    std::vector<Touch> touches;
+    int nSwaps = 0, swapsSinceProgress = 0, round = 0, generation = 0;
+    bool frontChanged = true;
+    auto maxStall = 3 * P + 10;
+
+    auto swap = [&](const int p1, const int p2) {
+      auto l1 = inverse[p1], l2 = inverse[p2];
+      std::swap(inverse[p1], inverse[p2]);
+      if (l1 != -1) {
+        layout[l1] = p2;
+      }
+      if (l2 != -1) {
+        layout[l2] = p1;
+      }
+      if (steps) {
+        steps->push_back({-1, p1, p2});
+      }
+      nSwaps++;
+      swapsSinceProgress++;
+      if (swapsSinceProgress % decayReset == 0) {
+        std::fill(decay.begin(), decay.end(), 1.0);
+      } else {
+        decay[p1] += decayIncrement;
+        decay[p2] += decayIncrement;
+      }
+    };
+
+    auto distance = [&](const int pos) {
+      return coupling.d(layout[first[pos]], layout[second[pos]]);
+    };
+
+    auto executable = [&](const int pos) {
+      return second[pos] == -1 || distance(pos) == 1;
+    };
+
+    while (!front.empty()) {
+      // Execute everything that is executable, repeatedly
+      bool progress = false, executed = true;
+      while (executed) {
+        executed = false;
+        kept.clear();
+        for (int i = 0; i < front.size(); i++) {
+          auto pos = front[i];
+          if (!executable(pos)) {
+            kept.push_back(pos);
+            continue;
+          }
+          if (steps) {
+            steps->push_back({order[pos], -1, -1});
+          }
+          for (int s = succOffsets[pos]; s < succOffsets[pos + 1]; s++) {
+            if (--nPreds[succs[s]] == 0) {
+              kept.push_back(succs[s]);
+            }
+          }
+          executed = progress = true;
+        }
+        front.swap(kept);
+      }
+      if (front.empty()) {
+        break;
+      }
+      if (progress) {
+        std::fill(decay.begin(), decay.end(), 1.0);
+        swapsSinceProgress = 0;
+      }
+
+      for (auto pos : front) {
+        if (distance(pos) >= unreachable) {
+          xacc::error("QubitRouter cannot route a gate between disconnected "
+                      "physical qubits.");
+        }
+      }
+
+      // Stuck, walk the closest front gate together along a shortest path
+      if (swapsSinceProgress > maxStall) {
+        auto closest = *std::min_element(
+            front.begin(), front.end(),
+            [&](const int a, const int b) { return distance(a) < distance(b); });
+        while (distance(closest) > 1) {
+          auto pa = layout[first[closest]], pb = layout[second[closest]];
+          for (auto nb : coupling.neighbors[pa]) {
+            if (coupling.d(nb, pb) < coupling.d(pa, pb)) {
+              swap(pa, nb);
+              break;
+            }
+          }
+        }
+        continue;
+      }
+
+      // The extended set, the next two-qubit gates after the front,
+      // only changes when the front does
+      if (progress || frontChanged) {
+        frontChanged = false;
+        generation++;
+        extended.clear();
+        queue.clear();
+        for (auto pos : front) {
+          stamp[pos] = generation;
+          queue.push_back(pos);
+        }
+        for (int head = 0; head < queue.size() && extended.size() < lookahead;
+             head++) {
+          auto pos = queue[head];
+          for (int s = succOffsets[pos]; s < succOffsets[pos + 1]; s++) {
+            auto next = succs[s];
+            if (stamp[next] == generation) {
+              continue;
+            }
+            stamp[next] = generation;
+            queue.push_back(next);
+            if (second[next] != -1 && extended.size() < lookahead) {
+              extended.push_back(next);
+            }
+          }
+        }
+      }
+
+      // Index the front and extended gates by physical qubit, so a
+      // Swap is scored by the few gates it moves
+      for (auto &t : touches) {
+        head[t.qubit] = -1;
+      }
+      touches.clear();
+      int frontSum = 0, extendedSum = 0;
+      auto index = [&](const std::vector<int> &set, const bool isFront) {
+        for (auto pos : set) {
+          auto pa = layout[first[pos]], pb = layout[second[pos]];
+          auto d = coupling.d(pa, pb);
+          (isFront ? frontSum : extendedSum) += d;
+          touches.push_back({pa, pb, d, isFront, head[pa]});
+          head[pa] = touches.size() - 1;
+          touches.push_back({pb, pa, d, isFront, head[pb]});
+          head[pb] = touches.size() - 1;
+        }
+      };
+      index(front, true);
+      index(extended, false);
+
+      // Swaps on an edge touching a qubit of a front gate
+      round++;
+      candidates.clear();
+      for (auto pos : front) {
+        for (auto q : {first[pos], second[pos]}) {
+          for (auto e : coupling.edgeIds[layout[q]]) {
+            if (edgeStamp[e] != round) {
+              edgeStamp[e] = round;
+              candidates.push_back(e);
+            }
+          }
+        }
+      }
+
+      auto frontWeight = 1.0 / front.size();
+      auto extendedWeight =
+          extended.empty() ? 0.0 : lookaheadWeight / extended.size();
+      int best = -1;
+      double bestScore = std::numeric_limits<double>::max();
+      for (auto e : candidates) {
+        auto p1 = coupling.edges[e].first, p2 = coupling.edges[e].second;
+        int frontDelta = 0, extendedDelta = 0;
+        for (int t = head[p1]; t != -1; t = touches[t].next) {
+          auto &g = touches[t];
+          if (g.other != p2) {
+            (g.isFront ? frontDelta : extendedDelta) +=
+                coupling.d(p2, g.other) - g.distance;
+          }
+        }
+        for (int t = head[p2]; t != -1; t = touches[t].next) {
+          auto &g = touches[t];
+          if (g.other != p1) {
+            (g.isFront ? frontDelta : extendedDelta) +=
+                coupling.d(p1, g.other) - g.distance;
+          }
+        }
+        auto score = ((frontSum + frontDelta) * frontWeight +
+                      (extendedSum + extendedDelta) * extendedWeight) *
+                     std::max(decay[p1], decay[p2]);
+        if (score < bestScore) {
+          bestScore = score;
+          best = e;
+        }
+      }
+      swap(coupling.edges[best].first, coupling.edges[best].second);
+    }
+
+    return nSwaps;
+  }
+
+protected:
+  const Coupling &coupling;
+  const std::vector<Op> &ops;
+  int nLogical;
+  int lookahead;
+};
+
+// Flatten the enabled leaves of a function into Ops
+void collect(std::shared_ptr<Function> function, std::vector<Op> &ops,
+             int &nLogical) {
+  for (int i = 0; i < function->nInstructions(); i++) {
+    auto inst = function->getInstruction(i);
+    if (std::dynamic_pointer_cast<ConditionalFunction>(inst)) {
+      Op op;
+      op.inst = inst;
+      op.conditional = true;
+      for (auto &b : inst->bits()) {
+        nLogical = std::max(nLogical, b + 1);
+      }
+      ops.push_back(op);
+    } else if (!inst->isEnabled()) {
+      continue;
+    } else if (inst->isComposite()) {
+      collect(std::dynamic_pointer_cast<Function>(inst), ops, nLogical);
+    } else {
+      if (inst->bits().size() > 2) {
+        xacc::error("QubitRouter can only route one and two-qubit gates, "
+                    "decompose " + inst->name() + " first.");
+      }
+      Op op;
+      op.inst = inst;
+      op.qubits = inst->bits();
+      for (auto &b : op.qubits) {
+        nLogical = std::max(nLogical, b + 1);
+      }
+      ops.push_back(op);
+    }
+  }
+}
+
+// Copy a gate onto new bits
+InstPtr copy(InstPtr inst, const std::vector<int> &bits) {
+  auto gate = std::dynamic_pointer_cast<GateInstruction>(inst);
+  if (!gate) {
+    xacc::error("QubitRouter can only route gate instructions.");
+  }
+  auto result = gate->clone();
+  result->setBits(bits);
+  for (int i = 0; i < inst->nParameters(); i++) {
+    auto p = inst->getParameter(i);
+    result->setParameter(i, p);
+  }
+  for (auto &kv : inst->getOptions()) {
+    result->setOption(kv.first, kv.second);
+  }
+  return result;
+}
+
+} // namespace
+
+std::shared_ptr<GateFunction>
+QubitRouter::route(std::shared_ptr<Function> function) {
+  return route(function, coupledPairs());
+}
+
+std::vector<std::pair<int, int>> QubitRouter::coupledPairs() {
+  if (connectivity.empty()) {
+    return xacc::getAccelerator()->getAcceleratorConnectivity();
+  }
+  return connectivity;
+}
+
+std::shared_ptr<GateFunction>
+QubitRouter::route(std::shared_ptr<Function> function,
+                   const std::vector<std::pair<int, int>> &edges) {
+  Coupling coupling(edges);
+
+  std::vector<Op> ops;
+  int nLogical = 0;
+  collect(function, ops, nLogical);
+
+  // Conditionals depend on every qubit
+  for (auto &op : ops) {
+    if (op.conditional) {
+      op.qubits.resize(nLogical);
+      std::iota(op.qubits.begin(), op.qubits.end(), 0);
+    }
+  }
+
+  if (nLogical > coupling.n) {
+    xacc::error("QubitRouter cannot place " + std::to_string(nLogical) +
+                " qubits on " + std::to_string(coupling.n) +
+                " physical qubits.");
+  }
+
+  int layoutPasses = 2, lookahead = 20;
+  if (xacc::optionExists("router-layout-passes")) {
+    layoutPasses = std::stoi(xacc::getOption("router-layout-passes"));
+  }
+  if (xacc::optionExists("router-lookahead")) {
+    lookahead = std::stoi(xacc::getOption("router-lookahead"));
+  }
+
+  // Find the initial layout by routing forward and backward
+  // from the trivial layout
+  std::vector<int> forwardOrder(ops.size()), layout(nLogical);
+  std::iota(forwardOrder.begin(), forwardOrder.end(), 0);
+  std::iota(layout.begin(), layout.end(), 0);
+  std::vector<int> backwardOrder(forwardOrder.rbegin(), forwardOrder.rend());
+  Sabre sabre(coupling, ops, nLogical, lookahead);
+  for (int pass = 0; pass < layoutPasses; pass++) {
+    sabre.run(forwardOrder, layout, nullptr);
+    sabre.run(backwardOrder, layout, nullptr);
+  }
+
+  std::vector<Step> steps;
+  auto initial = layout;
+  sabre.run(forwardOrder, layout, &steps);
+  auto finalLayout = layout;
+
+  auto routed =
+      std::make_shared<GateFunction>(function->name(), function->getParameters());
+
+  auto toIds = [&](std::vector<int> bits) {
+    for (auto &b : bits) {
+      b = coupling.ids[b];
+    }
+    return bits;
+  };
+
+  auto cnot = [&](std::shared_ptr<GateFunction> target, const int a,
+                  const int b) {
+    if (!directed || coupling.forward[a * coupling.n + b]) {
+      target->addInstruction(
+          std::make_shared<CNOT>(coupling.ids[a], coupling.ids[b]));
+      return;
+    }
+    // Against the edge, CNOT(a, b) = H H CNOT(b, a) H H
+    target->addInstruction(std::make_shared<Hadamard>(coupling.ids[a]));
+    target->addInstruction(std::make_shared<Hadamard>(coupling.ids[b]));
+    target->addInstruction(
+        std::make_shared<CNOT>(coupling.ids[b], coupling.ids[a]));
+    target->addInstruction(std::make_shared<Hadamard>(coupling.ids[a]));
+    target->addInstruction(std::make_shared<Hadamard>(coupling.ids[b]));
+  };
+
+  auto addSwap = [&](std::shared_ptr<GateFunction> target, const int a,
+                  const int b) {
+    if (directed) {
+      cnot(target, a, b);
+      cnot(target, b, a);
+      cnot(target, a, b);
+    } else {
+      target->addInstruction(
+          std::make_shared<Swap>(coupling.ids[a], coupling.ids[b]));
+    }
+  };
+
+  // Add a gate on the given coupled physical qubits
+  auto emit = [&](std::shared_ptr<GateFunction> target, InstPtr inst,
+                  const std::vector<int> &bits) {
+    if (directed && inst->name() == "CNOT") {
+      cnot(target, bits[0], bits[1]);
+    } else {
+      target->addInstruction(copy(inst, toIds(bits)));
+    }
+  };
+
+  // Map a gate through the current layout
+  auto place = [&](InstPtr inst) {
+    std::vector<int> bits;
+    for (auto b : inst->bits()) {
+      bits.push_back(layout[b]);
+    }
+    return bits;
+  };
+
+  // Replay the routing from the initial layout
+  layout = initial;
+  std::vector<int> inverse(coupling.n, -1);
+  for (int l = 0; l < nLogical; l++) {
+    inverse[layout[l]] = l;
+  }
+  for (auto &step : steps) {
+    if (step.op == -1) {
+      addSwap(routed, step.p1, step.p2);
+      auto l1 = inverse[step.p1], l2 = inverse[step.p2];
+      std::swap(inverse[step.p1], inverse[step.p2]);
+      if (l1 != -1) {
+        layout[l1] = step.p2;
+      }
+      if (l2 != -1) {
+        layout[l2] = step.p1;
+      }
+      continue;
+    }
+
+    auto &op = ops[step.op];
+    if (!op.conditional) {
+      emit(routed, op.inst, place(op.inst));
+      continue;
+    }
+
+    // The layout must not depend on the condition, so uncoupled
+    // gates in the body are routed with Swaps that are undone
+    // right after them, inside the conditional
+    auto conditional = std::dynamic_pointer_cast<ConditionalFunction>(op.inst);
+    auto mapped = std::make_shared<ConditionalFunction>(
+        conditional->getConditionalQubit());
+    for (int i = 0; i < conditional->nInstructions(); i++) {
+      auto inst = conditional->getInstruction(i);
+      auto bits = place(inst);
+      if (bits.size() > 2) {
+        xacc::error("QubitRouter can only route one and two-qubit gates, "
+                    "decompose " + inst->name() + " first.");
+      }
+      std::vector<std::pair<int, int>> path;
+      while (bits.size() == 2 && coupling.d(bits[0], bits[1]) > 1) {
+        if (coupling.d(bits[0], bits[1]) >= unreachable) {
+          xacc::error("QubitRouter cannot couple the qubits of " +
+                      inst->name() + " inside a conditional.");
+        }
+        for (auto next : coupling.neighbors[bits[0]]) {
+          if (coupling.d(next, bits[1]) < coupling.d(bits[0], bits[1])) {
+            addSwap(mapped, bits[0], next);
+            path.push_back({bits[0], next});
+            bits[0] = next;
+            break;
+          }
+        }
+      }
+      emit(mapped, inst, bits);
+      for (auto p = path.rbegin(); p != path.rend(); ++p) {
+        addSwap(mapped, p->first, p->second);
+      }
+    }
+    routed->addInstruction(mapped);
+  }
+
+  // Later gates, like measurements appended by an observable,
+  // must be mapped through the final layout
+  routed->setBitMap(toIds(finalLayout));
+
+  return routed;
+}
+
+std::shared_ptr<IR> QubitRouter::transform(std::shared_ptr<IR> ir) {
+  auto edges = coupledPairs();
+  std::vector<std::shared_ptr<Function>> routed(ir->getKernels().size());
+  xacc::parallelForEachKernel(
+      ir, [&](const int k, std::shared_ptr<Function> kernel) {
+        routed[k] = route(kernel, edges);
+      });
+
+  auto newIr = std::make_shared<GateIR>();
+  for (auto &kernel : routed) {
+    newIr->addKernel(kernel);
+  }
+  return newIr;
+}
+
+} // namespace quantum
+} // namespace xacc
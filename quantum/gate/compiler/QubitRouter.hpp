@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_COMPILER_QUBITROUTER_HPP_
+#define QUANTUM_GATE_COMPILER_QUBITROUTER_HPP_
+
+#include "IRTransformation.hpp"
+#include "OptionsProvider.hpp"
+#include "GateFunction.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The QubitRouter places the logical qubits of each kernel on the
+ * physical qubits of a coupling graph and inserts Swap gates so
+ * that every two-qubit gate acts on coupled qubits, following the
+ * SABRE look-ahead heuristic. The initial placement is found by
+ * routing the circuit forward and backward and keeping the final
+ * layout of the backward pass.
+ *
+ * Routed kernels are flattened GateFunctions on physical qubits,
+ * with the logical to physical layout at the end of the kernel
+ * stored as its bit map. Measurements keep their classical bits.
+ *
+ * On a directed coupling graph, CNOTs and Swaps that run against
+ * an edge are rewritten with Hadamards.
+ *
+ * Conditionals keep the layout. Two-qubit gates inside them on
+ * uncoupled qubits are routed with Swaps that are undone right
+ * after the gate, inside the conditional. Kernels are routed in
+ * parallel.
+ */
+class QubitRouter : public IRTransformation, public OptionsProvider {
+
+protected:
+  std::vector<std::pair<int, int>> connectivity;
+  bool directed = false;
+
+  /**
+   * Return the coupled pairs to route onto, the given
+   * connectivity or else that of the Accelerator.
+   */
+  std::vector<std::pair<int, int>> coupledPairs();
+
+  std::shared_ptr<GateFunction>
+  route(std::shared_ptr<Function> function,
+        const std::vector<std::pair<int, int>> &edges);
+
+public:
+  /**
+   * Route onto the connectivity of the Accelerator
+   * given by the accelerator option.
+   */
+  QubitRouter() {}
+
+  /**
+   * Route onto the given coupling graph.
+   *
+   * @param edges The coupled pairs of physical qubits
+   * @param directed True if CNOTs may only run from edge.first to edge.second
+   */
+  QubitRouter(const std::vector<std::pair<int, int>> &edges,
+              const bool directed = false)
+      : connectivity(edges), directed(directed) {}
+
+  std::shared_ptr<IR> transform(std::shared_ptr<IR> ir) override;
+
+  /**
+   * Route the given kernel onto the coupling graph.
+   *
+   * @param function The kernel to route
+   * @return routed The kernel on physical qubits
+   */
+  std::shared_ptr<GateFunction> route(std::shared_ptr<Function> function);
+
+  bool hardwareDependent() override { return true; }
+
+  const std::string name() const override { return "qubit-router"; }
+
+  const std::string description() const override {
+    return "Place and route qubits onto the Accelerator connectivity.";
+  }
+
+  OptionPairs getOptions() override {
+    OptionPairs desc{{"router-layout-passes",
+                      "The number of forward and backward routing passes "
+                      "used to find the initial layout. Default = 2."},
+                     {"router-lookahead",
+                      "The number of upcoming two-qubit gates that weigh on "
+                      "each Swap. Default = 20."}};
+    return desc;
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,246 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "SingleQubitFusion.hpp"
+#include "ConditionalFunction.hpp"
+#include "DigitalGates.hpp"
+#include "GateTape.hpp"
+#include "XACC.hpp"
+#include <cmath>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+
+using Matrix = SingleQubitFusion::Matrix;
+
+const double tolerance = 1e-10;
+
+Matrix multiply(const Matrix &a, const Matrix &b) {
+  return {a[0] * b[0] + a[1] * b[2], a[0] * b[1] + a[1] * b[3],
+          a[2] * b[0] + a[3] * b[2], a[2] * b[1] + a[3] * b[3]};
+}
+
+// True if m is the identity up to a global phase
+bool isIdentity(const Matrix &m) {
+  return std::abs(m[1]) < tolerance && std::abs(m[2]) < tolerance &&
+         std::abs(m[0] - m[3]) < tolerance;
+}
+
+// Wrap an angle to (-pi, pi]
+double wrap(double angle) {
+  angle = std::remainder(angle, 2.0 * M_PI);
+  return angle <= -M_PI ? angle + 2.0 * M_PI : angle;
+}
+
+// A run of fusible gates on one qubit
+struct Run {
+  std::vector<InstPtr> gates;
+  std::vector<GateFunction *> parents;
+  std::vector<int> indices;
+  std::vector<Matrix> matrices;
+};
+
+class Fuser {
+public:
+  int nRemoved = 0;
+
+  void walk(GateFunction *function) {
+    for (int i = 0; i < function->nInstructions(); i++) {
+      auto inst = function->getInstruction(i);
+      if (!inst->isEnabled()) {
+        continue;
+      }
+
+      if (inst->isComposite()) {
+        auto child = std::dynamic_pointer_cast<GateFunction>(inst);
+        if (child && !std::dynamic_pointer_cast<ConditionalFunction>(inst)) {
+          walk(child.get());
+        } else {
+          flushAll();
+        }
+        continue;
+      }
+
+      Matrix m;
+      if (SingleQubitFusion::matrix(inst, m)) {
+        auto &run = runs[inst->bits()[0]];
+        run.gates.push_back(inst);
+        run.parents.push_back(function);
+        run.indices.push_back(i);
+        run.matrices.push_back(m);
+      } else {
+        for (auto b : inst->bits()) {
+          flush(b);
+        }
+      }
+    }
+  }
+
+  void flushAll() {
+    for (auto &kv : runs) {
+      flush(kv.first);
+    }
+  }
+
+protected:
+  void flush(const int qubit) {
+    auto it = runs.find(qubit);
+    if (it == runs.end() || it->second.gates.empty()) {
+      return;
+    }
+    auto &run = it->second;
+
+    // Gates apply right to left
+    auto m = run.matrices[0];
+    for (int i = 1; i < run.matrices.size(); i++) {
+      m = multiply(run.matrices[i], m);
+    }
+
+    if (isIdentity(m)) {
+      for (auto &gate : run.gates) {
+        gate->disable();
+      }
+      nRemoved += run.gates.size();
+    } else if (run.gates.size() > 1) {
+      std::array<double, 3> angles;
+      SingleQubitFusion::zyz(m, angles);
+      auto u = std::make_shared<U>(qubit, angles[0], angles[1], angles[2]);
+      run.parents[0]->replaceInstruction(run.indices[0], u);
+      for (int i = 1; i < run.gates.size(); i++) {
+        run.gates[i]->disable();
+      }
+      nRemoved += run.gates.size() - 1;
+    }
+
+    run = Run();
+  }
+
+  std::map<int, Run> runs;
+};
+
+} // namespace
+
+bool SingleQubitFusion::matrix(InstPtr inst, Matrix &m) {
+  GateOp op;
+  if (inst->isComposite() || inst->bits().size() != 1 ||
+      !GateTape::opcode(inst->name(), op)) {
+    return false;
+  }
+
+  std::array<double, 3> p;
+  for (int i = 0; i < inst->nParameters() && i < 3; i++) {
+    auto param = inst->getParameter(i);
+    if (param.which() == 0) {
+      p[i] = param.as<int>();
+    } else if (param.which() == 1) {
+      p[i] = param.as<double>();
+    } else {
+      return false;
+    }
+  }
+
+  const std::complex<double> I(0.0, 1.0);
+  const double r = 1.0 / std::sqrt(2.0);
+  switch (op) {
+  case GateOp::I:
+    m = {1.0, 0.0, 0.0, 1.0};
+    break;
+  case GateOp::H:
+    m = {r, r, r, -r};
+    break;
+  case GateOp::X:
+    m = {0.0, 1.0, 1.0, 0.0};
+    break;
+  case GateOp::Y:
+    m = {0.0, -I, I, 0.0};
+    break;
+  case GateOp::Z:
+    m = {1.0, 0.0, 0.0, -1.0};
+    break;
+  case GateOp::S:
+    m = {1.0, 0.0, 0.0, I};
+    break;
+  case GateOp::Sdg:
+    m = {1.0, 0.0, 0.0, -I};
+    break;
+  case GateOp::T:
+    m = {1.0, 0.0, 0.0, std::exp(I * M_PI / 4.0)};
+    break;
+  case GateOp::Tdg:
+    m = {1.0, 0.0, 0.0, std::exp(-I * M_PI / 4.0)};
+    break;
+  case GateOp::Rx:
+    m = {std::cos(p[0] / 2), -I * std::sin(p[0] / 2), -I * std::sin(p[0] / 2),
+         std::cos(p[0] / 2)};
+    break;
+  case GateOp::Ry:
+    m = {std::cos(p[0] / 2), -std::sin(p[0] / 2), std::sin(p[0] / 2),
+         std::cos(p[0] / 2)};
+    break;
+  case GateOp::Rz:
+    m = {std::exp(-I * p[0] / 2.0), 0.0, 0.0, std::exp(I * p[0] / 2.0)};
+    break;
+  case GateOp::U:
+    m = {std::cos(p[0] / 2), -std::exp(I * p[2]) * std::sin(p[0] / 2),
+         std::exp(I * p[1]) * std::sin(p[0] / 2),
+         std::exp(I * (p[1] + p[2])) * std::cos(p[0] / 2)};
+    break;
+  default:
+    return false;
+  }
+  return true;
+}
+
+void SingleQubitFusion::zyz(const Matrix &m, std::array<double, 3> &angles) {
+  // Scale to SU(2), [[a, -b*], [b, a*]] with
+  // a = e^{-i(phi+lambda)/2} cos(theta/2), b = e^{i(phi-lambda)/2} sin(theta/2)
+  auto phase = std::sqrt(m[0] * m[3] - m[1] * m[2]);
+  auto a = m[0] / phase, b = m[2] / phase;
+
+  // atan2 keeps theta accurate near 0 and pi, where acos would not
+  auto theta = 2.0 * std::atan2(std::abs(b), std::abs(a));
+  double phi, lambda;
+  if (std::abs(b) < 1e-12) {
+    phi = 0.0;
+    lambda = -2.0 * std::arg(a);
+  } else if (std::abs(a) < 1e-12) {
+    phi = 2.0 * std::arg(b);
+    lambda = 0.0;
+  } else {
+    phi = std::arg(b) - std::arg(a);
+    lambda = -std::arg(b) - std::arg(a);
+  }
+
+  angles = {theta, wrap(phi), wrap(lambda)};
+}
+
+int SingleQubitFusion::fuse(std::shared_ptr<GateFunction> function) {
+  Fuser fuser;
+  fuser.walk(function.get());
+  fuser.flushAll();
+  return fuser.nRemoved;
+}
+
+std::shared_ptr<IR> SingleQubitFusion::transform(std::shared_ptr<IR> ir) {
+  xacc::parallelForEachKernel(ir, [](const int, std::shared_ptr<Function> k) {
+    auto gateFunction = std::dynamic_pointer_cast<GateFunction>(k);
+    if (gateFunction) {
+      fuse(gateFunction);
+    }
+  });
+  return ir;
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_COMPILER_SINGLEQUBITFUSION_HPP_
+#define QUANTUM_GATE_COMPILER_SINGLEQUBITFUSION_HPP_
+
+#include "IRTransformation.hpp"
+#include "GateFunction.hpp"
+#include <array>
+#include <complex>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The SingleQubitFusion fuses each run of two or more single-qubit
+ * gates on a qubit into one U gate, and removes runs that multiply
+ * to the identity up to a global phase. Only gates with numeric
+ * parameters are fused, a gate with a variable parameter ends the
+ * run, so run it after binding parameters to fuse those too.
+ *
+ * The first gate of a run is replaced with the U gate and the
+ * others are disabled. Conditionals end all runs.
+ */
+class SingleQubitFusion : public IRTransformation {
+
+public:
+  // Row-major 2x2 complex matrix
+  using Matrix = std::array<std::complex<double>, 4>;
+
+  SingleQubitFusion() {}
+
+  std::shared_ptr<IR> transform(std::shared_ptr<IR> ir) override;
+
+  /**
+   * Fuse the runs of the given function.
+   *
+   * @param function The function to fuse
+   * @return nRemoved The number of gates removed
+   */
+  static int fuse(std::shared_ptr<GateFunction> function);
+
+  /**
+   * Get the matrix of a numeric single-qubit gate.
+   *
+   * @param inst The gate
+   * @param m The gate matrix
+   * @return fusible False if inst is not a numeric single-qubit gate
+   */
+  static bool matrix(InstPtr inst, Matrix &m);
+
+  /**
+   * Find U(theta, phi, lambda) angles equal to the given
+   * unitary up to a global phase.
+   *
+   * @param m The unitary
+   * @param angles The theta, phi and lambda angles
+   */
+  static void zyz(const Matrix &m, std::array<double, 3> &angles);
+
+  const std::string name() const override { return "single-qubit-fusion"; }
+
+  const std::string description() const override {
+    return "Fuse runs of single-qubit gates into U gates.";
+  }
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
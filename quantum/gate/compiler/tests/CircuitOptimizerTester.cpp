@@ -18,9 +18,13 @@
 #include "GateIR.hpp"
 #include "CountGatesOfTypeVisitor.hpp"
 #include "DigitalGates.hpp"
+#include "ConditionalFunction.hpp"
+#include "PeepholeOptimizer.hpp"
+#include <chrono>
 
 #include "xacc_service.hpp"
 
+using namespace xacc;
 using namespace xacc::quantum;
 const std::string uccsdSrc = R"uccsdSrc(def foo(theta0,theta1):
    X(0)
@@ -261,6 +265,258 @@ TEST(CircuitOptimizerTester, checkSimple) {
   }
 }
 
+TEST(CircuitOptimizerTester, checkCNOTOrientation) {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<CNOT>(1, 0));
+  f->addInstruction(std::make_shared<Hadamard>(2));
+  f->addInstruction(std::make_shared<CNOT>(2, 3));
+  f->addInstruction(std::make_shared<CNOT>(2, 3));
+  f->addInstruction(std::make_shared<Hadamard>(2));
+
+  auto ir = std::make_shared<GateIR>();
+  ir->addKernel(f);
+
+  CircuitOptimizer opt;
+  opt.transform(ir);
+
+  auto optF = std::dynamic_pointer_cast<GateFunction>(f->enabledView());
+  EXPECT_EQ(2, optF->nInstructions());
+  EXPECT_EQ(std::vector<int>({0, 1}), optF->getInstruction(0)->bits());
+  EXPECT_EQ(std::vector<int>({1, 0}), optF->getInstruction(1)->bits());
+}
+
+TEST(CircuitOptimizerTester, checkPeepholeRules) {
+  // H CNOT CNOT H collapses once each cancellation
+  // exposes the next pair, across nested functions
+  auto f = std::make_shared<GateFunction>("foo");
+  auto inner = std::make_shared<GateFunction>("inner");
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<Rz>(1, 0.0));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  inner->addInstruction(std::make_shared<Rx>(1, 0.25));
+  inner->addInstruction(std::make_shared<Rx>(1, -0.25));
+  inner->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(inner);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<Rz>(2, 0.5));
+
+  PeepholeOptimizer peephole(f);
+  EXPECT_EQ(7, peephole.run());
+  int nEnabled = 0;
+  for (auto &inst : xacc::InstructionRange(f, xacc::Traversal::EnabledLeaves)) {
+    EXPECT_EQ("Rz", inst->name());
+    EXPECT_EQ(std::vector<int>{2}, inst->bits());
+    nEnabled++;
+  }
+  EXPECT_EQ(1, nEnabled);
+
+  // Conditionals are barriers
+  auto g = std::make_shared<GateFunction>("bar");
+  auto cond = std::make_shared<ConditionalFunction>(0);
+  cond->addInstruction(std::make_shared<X>(1));
+  g->addInstruction(std::make_shared<Hadamard>(1));
+  g->addInstruction(cond);
+  g->addInstruction(std::make_shared<Hadamard>(1));
+  EXPECT_EQ(0, PeepholeOptimizer(g).run());
+}
+
+TEST(CircuitOptimizerTester, checkLinearAngle) {
+  LinearAngle a, b;
+  EXPECT_TRUE(LinearAngle::parse(InstructionParameter("2 * theta - 0.5"), a));
+  EXPECT_EQ("theta", a.variable);
+  EXPECT_NEAR(2.0, a.coefficient, 1e-12);
+  EXPECT_NEAR(-0.5, a.constant, 1e-12);
+
+  EXPECT_TRUE(LinearAngle::parse(InstructionParameter("-theta/2 + pi"), b));
+  EXPECT_NEAR(-0.5, b.coefficient, 1e-12);
+  EXPECT_NEAR(3.141592653589793, b.constant, 1e-12);
+  EXPECT_TRUE(a.add(b));
+  EXPECT_NEAR(1.5, a.coefficient, 1e-12);
+
+  EXPECT_FALSE(LinearAngle::parse(InstructionParameter("sin(theta)"), b));
+  EXPECT_FALSE(LinearAngle::parse(InstructionParameter("theta * phi"), b));
+  EXPECT_TRUE(LinearAngle::parse(InstructionParameter("phi"), b));
+  EXPECT_FALSE(a.add(b));
+
+  LinearAngle c;
+  c.variable = "theta";
+  c.coefficient = 1.0;
+  c.constant = 0.5;
+  EXPECT_EQ("theta + 0.5", c.toParameter().as<std::string>());
+  c.coefficient = -1.0;
+  c.constant = -0.25;
+  EXPECT_EQ("-theta - 0.25", c.toParameter().as<std::string>());
+  c.coefficient = 0.0;
+  EXPECT_EQ(-0.25, c.toParameter().as<double>());
+}
+
+template <typename T>
+std::shared_ptr<T> symbolic(const int bit, const std::string expr) {
+  auto gate = std::make_shared<T>(bit, 0.0);
+  InstructionParameter p(expr);
+  gate->setParameter(0, p);
+  return gate;
+}
+
+TEST(CircuitOptimizerTester, checkRotationMerging) {
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<InstructionParameter>{InstructionParameter("theta")});
+  f->addInstruction(std::make_shared<Rz>(0, 0.25));
+  f->addInstruction(std::make_shared<Rz>(0, 0.5));
+  f->addInstruction(symbolic<Rx>(1, "theta"));
+  f->addInstruction(std::make_shared<Rx>(1, 0.5));
+  f->addInstruction(symbolic<Ry>(2, "theta"));
+  f->addInstruction(symbolic<Ry>(2, "-theta"));
+
+  EXPECT_EQ(4, PeepholeOptimizer(f).run());
+  auto optF = std::dynamic_pointer_cast<GateFunction>(f->enabledView());
+  EXPECT_EQ(2, optF->nInstructions());
+  EXPECT_EQ("Rz", optF->getInstruction(0)->name());
+  EXPECT_NEAR(0.75, optF->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+  EXPECT_EQ("Rx", optF->getInstruction(1)->name());
+  EXPECT_EQ("theta + 0.5",
+            optF->getInstruction(1)->getParameter(0).as<std::string>());
+
+  // The merged gate is evaluated with the new angle
+  f->removeDisabled();
+  EXPECT_EQ(1, f->nParameters());
+  auto evaled = (*f)(std::vector<double>{1.0});
+  EXPECT_NEAR(1.5, evaled->getInstruction(1)->getParameter(0).as<double>(),
+              1e-12);
+}
+
+TEST(CircuitOptimizerTester, checkCommutationWindow) {
+  // Rz commutes through the CNOT control, Rx through the target,
+  // CNOTs sharing a control commute with each other
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<Rz>(0, 0.5));
+  f->addInstruction(std::make_shared<Rx>(1, 0.5));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<CNOT>(0, 2));
+  f->addInstruction(std::make_shared<Rz>(0, -0.5));
+  f->addInstruction(std::make_shared<Rx>(1, -0.5));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+
+  EXPECT_EQ(6, PeepholeOptimizer(f).run());
+  auto optF = std::dynamic_pointer_cast<GateFunction>(f->enabledView());
+  EXPECT_EQ(1, optF->nInstructions());
+  EXPECT_EQ(std::vector<int>({0, 2}), optF->getInstruction(0)->bits());
+
+  // Rz does not commute through a target, nor CNOTs
+  // sharing a qubit in different roles
+  auto g = std::make_shared<GateFunction>("bar");
+  g->addInstruction(std::make_shared<Rz>(1, 0.5));
+  g->addInstruction(std::make_shared<CNOT>(0, 1));
+  g->addInstruction(std::make_shared<Rz>(1, -0.5));
+  g->addInstruction(std::make_shared<CNOT>(2, 3));
+  g->addInstruction(std::make_shared<CNOT>(3, 4));
+  g->addInstruction(std::make_shared<CNOT>(2, 3));
+  EXPECT_EQ(0, PeepholeOptimizer(g).run());
+
+  // Partners out of the window are left alone
+  auto h = std::make_shared<GateFunction>("baz");
+  h->addInstruction(std::make_shared<Rz>(1, 0.5));
+  for (int i = 0; i < 4; i++) {
+    h->addInstruction(std::make_shared<CNOT>(1, i + 2));
+  }
+  h->addInstruction(std::make_shared<Rz>(1, -0.5));
+  EXPECT_EQ(0, PeepholeOptimizer(h, 2).run());
+  EXPECT_EQ(2, PeepholeOptimizer(h).run());
+}
+
+TEST(CircuitOptimizerTester, checkParallelKernels) {
+  // Optimizing all kernels at once must match optimizing them
+  // one by one, with kernels sharing a function kept in order
+  auto build = [](std::shared_ptr<GateFunction> shared) {
+    std::srand(11);
+    auto ir = std::make_shared<GateIR>();
+    for (int k = 0; k < 200; k++) {
+      auto f = std::make_shared<GateFunction>("k" + std::to_string(k));
+      if (k % 10 == 0) {
+        f->addInstruction(shared);
+      }
+      for (int i = 0; i < 200; i++) {
+        int q = std::rand() % 4;
+        if (std::rand() % 2) {
+          f->addInstruction(std::make_shared<Hadamard>(q));
+        } else {
+          f->addInstruction(std::make_shared<CNOT>(q, (q + 1) % 4));
+        }
+      }
+      ir->addKernel(f);
+    }
+    return ir;
+  };
+  auto makeShared = []() {
+    auto shared = std::make_shared<GateFunction>("shared");
+    shared->addInstruction(std::make_shared<Hadamard>(0));
+    return shared;
+  };
+
+  auto parallel = build(makeShared());
+  CircuitOptimizer opt;
+  opt.transform(parallel);
+
+  auto serial = build(makeShared());
+  for (auto &k : serial->getKernels()) {
+    PeepholeOptimizer(std::dynamic_pointer_cast<GateFunction>(k)).run();
+  }
+
+  auto kernels = parallel->getKernels();
+  auto expected = serial->getKernels();
+  for (int k = 0; k < kernels.size(); k++) {
+    EXPECT_EQ(expected[k]->enabledView()->toString("q"),
+              kernels[k]->enabledView()->toString("q"));
+  }
+}
+
+TEST(CircuitOptimizerTester, DISABLED_benchmarkScaling) {
+  // Random H, CNOT and Rz circuits on 8 qubits,
+  // the time per gate should stay roughly flat.
+  std::srand(7);
+  std::vector<int> sizes{1000, 10000, 100000};
+  std::vector<double> times;
+  for (auto n : sizes) {
+    auto f = std::make_shared<GateFunction>("foo");
+    for (int i = 0; i < n; i++) {
+      int q = std::rand() % 8;
+      switch (std::rand() % 4) {
+      case 0:
+        f->addInstruction(std::make_shared<Hadamard>(q));
+        break;
+      case 1:
+        f->addInstruction(std::make_shared<CNOT>(q, (q + 1) % 8));
+        break;
+      case 2:
+        f->addInstruction(std::make_shared<Rz>(q, 0.5));
+        break;
+      default:
+        f->addInstruction(std::make_shared<Rz>(q, -0.5));
+      }
+    }
+
+    auto ir = std::make_shared<GateIR>();
+    ir->addKernel(f);
+    CircuitOptimizer opt;
+    auto start = std::chrono::high_resolution_clock::now();
+    opt.transform(ir);
+    auto end = std::chrono::high_resolution_clock::now();
+    times.push_back(std::chrono::duration<double>(end - start).count());
+
+    int nEnabled = 0;
+    for (auto &inst : f->enabledInstructions()) {
+      nEnabled++;
+    }
+    std::cout << n << " gates: " << 1e9 * times.back() / n << " ns/gate, "
+              << n - nEnabled << " removed\n";
+    EXPECT_LT(nEnabled, n);
+  }
+
+  EXPECT_LT(times[2], 30 * times[1]);
+}
+
 int main(int argc, char **argv) {
   xacc::Initialize(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,359 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "CompilationCache.hpp"
+#include "CompilerDecorator.hpp"
+#include "ConditionalFunction.hpp"
+#include "DigitalGates.hpp"
+#include "GateIR.hpp"
+#include "xacc_service.hpp"
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+// Compiles one gate per line, "H 0" or "Rz 0 0.5", and counts its calls
+class CountingCompiler : public Compiler {
+public:
+  int nCompiles = 0;
+
+  std::shared_ptr<IR> compile(const std::string &src,
+                              std::shared_ptr<Accelerator> acc) override {
+    nCompiles++;
+    auto f = std::make_shared<GateFunction>("foo");
+    std::istringstream lines(src);
+    std::string name;
+    while (lines >> name) {
+      int q;
+      lines >> q;
+      if (name == "H") {
+        f->addInstruction(std::make_shared<Hadamard>(q));
+      } else if (name == "CNOT") {
+        int t;
+        lines >> t;
+        f->addInstruction(std::make_shared<CNOT>(q, t));
+      } else {
+        double angle;
+        lines >> angle;
+        f->addInstruction(std::make_shared<Rz>(q, angle));
+      }
+    }
+    auto ir = std::make_shared<GateIR>();
+    ir->addKernel(f);
+    return ir;
+  }
+  std::shared_ptr<IR> compile(const std::string &src) override {
+    return compile(src, nullptr);
+  }
+  const std::string translate(const std::string &bufferVariable,
+                              std::shared_ptr<Function> function) override {
+    return "";
+  }
+  OptionPairs getOptions() override {
+    return OptionPairs{{"counting-level", "A test option."}};
+  }
+  const std::string name() const override { return "counting"; }
+  const std::string description() const override { return ""; }
+};
+
+// A gate the gate IRProvider cannot create, so never cached
+class OpaqueGate : public Hadamard {
+public:
+  using Hadamard::Hadamard;
+  const std::string name() const override { return "opaque"; }
+};
+
+// Compiles to one OpaqueGate and counts its calls
+class OpaqueCompiler : public CountingCompiler {
+public:
+  std::shared_ptr<IR> compile(const std::string &src,
+                              std::shared_ptr<Accelerator> acc) override {
+    nCompiles++;
+    auto f = std::make_shared<GateFunction>("foo");
+    f->addInstruction(std::make_shared<OpaqueGate>(0));
+    auto ir = std::make_shared<GateIR>();
+    ir->addKernel(f);
+    return ir;
+  }
+};
+
+class FakeAccelerator : public Accelerator {
+public:
+  std::vector<std::pair<int, int>> edges;
+
+  void initialize() override {}
+  AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
+  std::vector<std::shared_ptr<IRTransformation>>
+  getIRTransformations() override {
+    return {};
+  }
+  void execute(std::shared_ptr<AcceleratorBuffer> buffer,
+               const std::shared_ptr<Function> function) override {}
+  std::vector<std::shared_ptr<AcceleratorBuffer>>
+  execute(std::shared_ptr<AcceleratorBuffer> buffer,
+          const std::vector<std::shared_ptr<Function>> functions) override {
+    return {};
+  }
+  std::shared_ptr<AcceleratorBuffer>
+  createBuffer(const std::string &varId) override {
+    return nullptr;
+  }
+  std::shared_ptr<AcceleratorBuffer> createBuffer(const std::string &varId,
+                                                  const int size) override {
+    return nullptr;
+  }
+  bool isValidBufferSize(const int NBits) override { return true; }
+  std::vector<std::pair<int, int>> getAcceleratorConnectivity() override {
+    return edges;
+  }
+  const std::string name() const override { return "fake"; }
+  const std::string description() const override { return ""; }
+};
+
+const std::string cacheDir =
+    "/tmp/xacc-compilation-cache-" + std::to_string(getpid()) + "/kernels";
+
+TEST(CompilationCacheTester, checkLookup) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  auto acc = std::make_shared<FakeAccelerator>();
+  const std::string src = "H 0\nCNOT 0 1\nRz 1 0.5\n";
+
+  CompilationCache cache(cacheDir);
+  cache.clear();
+  auto first = cache.compile(compiler, src, acc);
+  auto second = cache.compile(compiler, src, acc);
+  EXPECT_EQ(1, compiler->nCompiles);
+  EXPECT_EQ(first->getKernels()[0]->hash(), second->getKernels()[0]->hash());
+  EXPECT_EQ("foo", second->getKernels()[0]->name());
+
+  // Entries outlive the cache object
+  CompilationCache reopened(cacheDir);
+  EXPECT_EQ(1, reopened.size());
+  reopened.compile(compiler, src, acc);
+  EXPECT_EQ(1, compiler->nCompiles);
+  reopened.clear();
+}
+
+TEST(CompilationCacheTester, checkKey) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  auto acc = std::make_shared<FakeAccelerator>();
+  auto key = CompilationCache::key(compiler, "H 0\n", acc);
+  EXPECT_EQ(32, key.size());
+  EXPECT_EQ(key, CompilationCache::key(compiler, "H 0\n", acc));
+
+  std::set<std::string> keys{key};
+  keys.insert(CompilationCache::key(compiler, "H 1\n", acc));
+  keys.insert(CompilationCache::key(compiler, "H 0\n", nullptr));
+  acc->edges = {{0, 1}};
+  keys.insert(CompilationCache::key(compiler, "H 0\n", acc));
+  xacc::setOption("counting-level", "2");
+  keys.insert(CompilationCache::key(compiler, "H 0\n", acc));
+  xacc::unsetOption("counting-level");
+  EXPECT_EQ(5, keys.size());
+}
+
+TEST(CompilationCacheTester, checkRoundTrip) {
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<InstructionParameter>{InstructionParameter("theta")});
+  auto rz = std::make_shared<Rz>(1, 0.0);
+  InstructionParameter theta("theta");
+  rz->setParameter(0, theta);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(rz);
+  auto inner = std::make_shared<GateFunction>("inner");
+  inner->addInstruction(std::make_shared<CNOT>(0, 2));
+  inner->addInstruction(std::make_shared<Measure>(2, 1));
+  f->addInstruction(inner);
+  auto conditional = std::make_shared<ConditionalFunction>(1);
+  conditional->addInstruction(std::make_shared<X>(0));
+  f->addInstruction(conditional);
+  f->getInstruction(0)->disable();
+  f->setBitMap({3, 4, 5});
+  f->setOption("note", InstructionParameter("kept"));
+
+  auto ir = std::make_shared<GateIR>();
+  ir->addKernel(f);
+  std::stringstream s;
+  EXPECT_TRUE(CompilationCache::encode(ir, s));
+  auto decoded = CompilationCache::decode(s);
+  ASSERT_TRUE(decoded != nullptr);
+
+  auto g = decoded->getKernels()[0];
+  EXPECT_EQ(f->hash(), g->hash());
+  EXPECT_EQ(std::vector<int>({3, 4, 5}), g->getBitMap());
+  EXPECT_EQ("kept", g->getOption("note").as<std::string>());
+  auto c = std::dynamic_pointer_cast<ConditionalFunction>(g->getInstruction(3));
+  ASSERT_TRUE(c != nullptr);
+  EXPECT_EQ(1, c->getConditionalQubit());
+  EXPECT_FALSE(c->getInstruction(0)->isEnabled());
+}
+
+TEST(CompilationCacheTester, checkInvalidation) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  CompilationCache cache(cacheDir);
+  cache.clear();
+  auto key = CompilationCache::key(compiler, "H 0\n", nullptr);
+  cache.compile(compiler, "H 0\n", nullptr);
+
+  // A damaged entry is a miss, and is dropped
+  {
+    std::ofstream out(cacheDir + "/" + key + ".xir",
+                      std::ios::binary | std::ios::app);
+    out << "junk";
+  }
+  EXPECT_TRUE(cache.get(key) == nullptr);
+  EXPECT_EQ(0, cache.size());
+
+  cache.compile(compiler, "H 0\n", nullptr);
+  EXPECT_EQ(2, compiler->nCompiles);
+  cache.invalidate(key);
+  EXPECT_TRUE(cache.get(key) == nullptr);
+}
+
+TEST(CompilationCacheTester, checkEviction) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  std::vector<std::string> srcs{"H 0\n", "H 1\n", "H 2\n", "H 3\n"};
+  std::vector<std::string> keys;
+  std::size_t entryBytes;
+  {
+    CompilationCache cache(cacheDir);
+    cache.clear();
+    cache.compile(compiler, srcs[0], nullptr);
+    entryBytes = cache.bytes();
+  }
+
+  // Room for three entries
+  CompilationCache cache(cacheDir, 3 * entryBytes);
+  for (auto &src : srcs) {
+    keys.push_back(CompilationCache::key(compiler, src, nullptr));
+  }
+  cache.compile(compiler, srcs[1], nullptr);
+  cache.compile(compiler, srcs[2], nullptr);
+  // Touch the oldest, so that srcs[1] is least recently used
+  cache.compile(compiler, srcs[0], nullptr);
+  cache.compile(compiler, srcs[3], nullptr);
+
+  EXPECT_EQ(3, cache.size());
+  EXPECT_LE(cache.bytes(), 3 * entryBytes);
+  EXPECT_TRUE(cache.get(keys[1]) == nullptr);
+
+  // The recency order survives reopening
+  CompilationCache reopened(cacheDir, 2 * entryBytes);
+  EXPECT_EQ(2, reopened.size());
+  EXPECT_TRUE(reopened.get(keys[2]) == nullptr);
+  EXPECT_TRUE(reopened.get(keys[0]) != nullptr);
+  EXPECT_TRUE(reopened.get(keys[3]) != nullptr);
+  reopened.clear();
+}
+
+TEST(CompilationCacheTester, checkSharedDirectory) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  CompilationCache first(cacheDir), second(cacheDir);
+  first.clear();
+
+  // Neither overwrites the entries the other added
+  first.compile(compiler, "H 0\n", nullptr);
+  second.compile(compiler, "H 1\n", nullptr);
+  first.compile(compiler, "H 2\n", nullptr);
+  second.compile(compiler, "H 0\n", nullptr);
+  EXPECT_EQ(3, compiler->nCompiles);
+
+  CompilationCache reopened(cacheDir);
+  EXPECT_EQ(3, reopened.size());
+  reopened.clear();
+}
+
+TEST(CompilationCacheTester, checkOrphans) {
+  auto compiler = std::make_shared<CountingCompiler>();
+  {
+    CompilationCache cache(cacheDir);
+    cache.clear();
+  }
+
+  // An unindexed entry older than the index is left over, a newer one
+  // may be on its way into the index
+  auto stale = cacheDir + "/" + std::string(32, 'a') + ".xir";
+  auto fresh = cacheDir + "/" + std::string(32, 'b') + ".xir";
+  std::ofstream(stale) << "stale";
+  std::ofstream(fresh) << "fresh";
+  struct stat st;
+  ASSERT_EQ(0, stat((cacheDir + "/index").c_str(), &st));
+  struct utimbuf past{st.st_mtime - 60, st.st_mtime - 60};
+  utime(stale.c_str(), &past);
+  struct utimbuf future{st.st_mtime + 60, st.st_mtime + 60};
+  utime(fresh.c_str(), &future);
+
+  CompilationCache reopened(cacheDir);
+  EXPECT_NE(0, stat(stale.c_str(), &st));
+  EXPECT_EQ(0, stat(fresh.c_str(), &st));
+  std::remove(fresh.c_str());
+}
+
+TEST(CompilationCacheTester, checkCachingCompiler) {
+  {
+    CompilationCache cache(cacheDir);
+    cache.clear();
+  }
+  auto compiler = std::make_shared<CountingCompiler>();
+  auto cached = xacc::getService<CompilerDecorator>("compilation-cache");
+  EXPECT_EQ("compilation-cache", cached->name());
+  EXPECT_EQ(1, cached->getOptions().count("compilation-cache-dir"));
+
+  // The decorator takes on the identity of the decorated Compiler
+  cached->setDecorated(compiler);
+  EXPECT_EQ("counting", cached->name());
+  EXPECT_EQ(compiler->getOptions(), cached->getOptions());
+
+  // Without a cache directory every call compiles
+  cached->compile("H 0\n", nullptr);
+  cached->compile("H 0\n", nullptr);
+  EXPECT_EQ(2, compiler->nCompiles);
+
+  xacc::setOption("compilation-cache-dir", cacheDir);
+  auto first = cached->compile("H 0\nRz 1 0.5\n", nullptr);
+  auto second = cached->compile("H 0\nRz 1 0.5\n", nullptr);
+  cached->compile("H 0\nRz 1 0.5\n");
+  EXPECT_EQ(3, compiler->nCompiles);
+  EXPECT_EQ(first->getKernels()[0]->hash(), second->getKernels()[0]->hash());
+
+  // IR that cannot be stored is looked up once
+  auto opaque = std::make_shared<OpaqueCompiler>();
+  CompilationCache cache(cacheDir);
+  cache.compile(opaque, "H 0\n", nullptr);
+  auto key = CompilationCache::key(opaque, "H 0\n", nullptr);
+  EXPECT_FALSE(cache.cacheable(key));
+  cache.compile(opaque, "H 0\n", nullptr);
+  EXPECT_EQ(2, opaque->nCompiles);
+  EXPECT_TRUE(cache.cacheable(CompilationCache::key(opaque, "H 1\n", nullptr)));
+
+  // getCompiler decorates the Compilers it returns
+  for (auto &name : xacc::getRegisteredIds<Compiler>()) {
+    auto c = xacc::getCompiler(name);
+    EXPECT_TRUE(std::dynamic_pointer_cast<CompilerDecorator>(c) != nullptr);
+    EXPECT_EQ(name, c->name());
+  }
+  xacc::unsetOption("compilation-cache-dir");
+  cache.clear();
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
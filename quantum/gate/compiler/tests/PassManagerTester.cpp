@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "PassManager.hpp"
+#include "GateIR.hpp"
+#include "GateFunction.hpp"
+#include "DigitalGates.hpp"
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+std::shared_ptr<IR> makeIR() {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<X>(1));
+  auto ir = std::make_shared<GateIR>();
+  ir->addKernel(f);
+  return ir;
+}
+
+TEST(PassManagerTester, checkSequence) {
+  PassManager passes("circuit-optimizer, circuit-optimizer");
+  auto ir = passes.run(makeIR());
+  EXPECT_EQ(1, PassManager::countGates(ir));
+
+  auto records = passes.getRecords();
+  EXPECT_EQ(2, records.size());
+  EXPECT_EQ("circuit-optimizer", records[0].name);
+  EXPECT_EQ(0, records[0].iteration);
+  EXPECT_EQ(5, records[0].gatesBefore);
+  EXPECT_EQ(1, records[0].gatesAfter);
+  EXPECT_EQ(1, records[1].gatesBefore);
+  EXPECT_EQ(1, records[1].gatesAfter);
+  EXPECT_GE(records[0].milliseconds, 0.0);
+}
+
+TEST(PassManagerTester, checkFixedPoint) {
+  // The second iteration removes nothing, so the group stops
+  PassManager passes(" ( circuit-optimizer )* ");
+  passes.run(makeIR());
+  auto records = passes.getRecords();
+  EXPECT_EQ(2, records.size());
+  EXPECT_EQ(1, records[0].iteration);
+  EXPECT_EQ(2, records[1].iteration);
+  EXPECT_EQ(records[1].gatesBefore, records[1].gatesAfter);
+
+  passes.setMaxIterations(1);
+  passes.run(makeIR());
+  EXPECT_EQ(1, passes.getRecords().size());
+
+  auto buffer = std::make_shared<AcceleratorBuffer>("q", 2);
+  passes.report(buffer);
+  EXPECT_EQ(std::vector<std::string>{"circuit-optimizer"},
+            mpark::get<std::vector<std::string>>(
+                buffer->getInformation("pass-names")));
+  EXPECT_EQ(std::vector<int>{-4}, mpark::get<std::vector<int>>(
+                                      buffer->getInformation("pass-gate-deltas")));
+}
+
+TEST(PassManagerTester, checkOptimizeFunction) {
+  auto f = makeIR()->getKernels()[0];
+  auto optF = xacc::optimizeFunction("(circuit-optimizer)*", f);
+  EXPECT_EQ(1, optF->nInstructions());
+  EXPECT_EQ("X", optF->getInstruction(0)->name());
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -0,0 +1,323 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "QubitRouter.hpp"
+#include "InstructionIterator.hpp"
+#include "GateIR.hpp"
+#include "ConditionalFunction.hpp"
+#include "DigitalGates.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+using Edges = std::vector<std::pair<int, int>>;
+
+Edges grid(const int rows, const int cols) {
+  Edges edges;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      if (c + 1 < cols) {
+        edges.push_back({r * cols + c, r * cols + c + 1});
+      }
+      if (r + 1 < rows) {
+        edges.push_back({r * cols + c, (r + 1) * cols + c});
+      }
+    }
+  }
+  return edges;
+}
+
+// Rows of chained qubits, joined by bridge qubits every fourth
+// column, alternating between even and odd offsets
+Edges heavyHex(const int rows, const int cols) {
+  Edges edges;
+  int bridge = rows * cols;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c + 1 < cols; c++) {
+      edges.push_back({r * cols + c, r * cols + c + 1});
+    }
+    if (r + 1 < rows) {
+      for (int c = r % 2 ? 2 : 0; c < cols; c += 4) {
+        edges.push_back({r * cols + c, bridge});
+        edges.push_back({bridge, (r + 1) * cols + c});
+        bridge++;
+      }
+    }
+  }
+  return edges;
+}
+
+std::shared_ptr<GateFunction> randomCircuit(const int nQubits,
+                                            const int nGates) {
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> qubit(0, nQubits - 1), kind(0, 3);
+  std::uniform_real_distribution<double> angle(-3.0, 3.0);
+  auto f = std::make_shared<GateFunction>("foo");
+  for (int i = 0; i < nGates; i++) {
+    auto a = qubit(gen), b = qubit(gen);
+    auto k = kind(gen);
+    if (k == 0) {
+      f->addInstruction(std::make_shared<Hadamard>(a));
+    } else if (k == 1) {
+      f->addInstruction(std::make_shared<Rz>(a, angle(gen)));
+    } else if (a != b) {
+      f->addInstruction(std::make_shared<CNOT>(a, b));
+    } else {
+      f->addInstruction(std::make_shared<CZ>(a, (a + 1) % nQubits));
+    }
+  }
+  for (int q = 0; q < nQubits; q++) {
+    f->addInstruction(std::make_shared<Measure>(q, q));
+  }
+  return f;
+}
+
+std::string signature(InstPtr inst, const std::vector<int> &bits) {
+  auto s = inst->name();
+  for (auto b : bits) {
+    s += " " + std::to_string(b);
+  }
+  for (auto &p : inst->getParameters()) {
+    s += " " + p.toString();
+  }
+  return s;
+}
+
+// Check that every two-qubit gate is on a coupled pair, and that each
+// logical qubit sees the same gates in the same order as before routing.
+// Returns the number of Swaps.
+int checkRouting(std::shared_ptr<Function> original,
+                 std::shared_ptr<Function> routed, const Edges &edges) {
+  std::set<std::pair<int, int>> coupled;
+  for (auto &e : edges) {
+    coupled.insert(e);
+    coupled.insert({e.second, e.first});
+  }
+
+  std::map<int, std::vector<std::string>> expected, actual;
+  for (auto &inst : InstructionRange(original, Traversal::EnabledLeaves)) {
+    for (auto b : inst->bits()) {
+      expected[b].push_back(signature(inst, inst->bits()));
+    }
+  }
+
+  // Undo the Swaps from the final layout to find the initial one.
+  // Physical qubits holding no logical qubit map to -1.
+  int nPhysical = 0;
+  for (auto &e : edges) {
+    nPhysical = std::max(nPhysical, std::max(e.first, e.second) + 1);
+  }
+  std::vector<int> physicalToLogical(nPhysical, -1);
+  auto finalLayout = routed->getBitMap();
+  for (int l = 0; l < finalLayout.size(); l++) {
+    physicalToLogical.at(finalLayout[l]) = l;
+  }
+  auto instructions = routed->getInstructions();
+  for (auto it = instructions.rbegin(); it != instructions.rend(); ++it) {
+    if ((*it)->name() == "Swap") {
+      auto bits = (*it)->bits();
+      std::swap(physicalToLogical.at(bits[0]), physicalToLogical.at(bits[1]));
+    }
+  }
+
+  int nSwaps = 0;
+  for (auto &inst : instructions) {
+    auto bits = inst->bits();
+    if (bits.size() == 2) {
+      EXPECT_TRUE(coupled.count({bits[0], bits[1]}));
+    }
+    if (inst->name() == "Swap") {
+      std::swap(physicalToLogical.at(bits[0]), physicalToLogical.at(bits[1]));
+      nSwaps++;
+      continue;
+    }
+    std::vector<int> logical;
+    for (auto b : bits) {
+      EXPECT_NE(-1, physicalToLogical.at(b));
+      logical.push_back(physicalToLogical.at(b));
+    }
+    for (auto l : logical) {
+      actual[l].push_back(signature(inst, logical));
+    }
+  }
+  EXPECT_TRUE(expected == actual);
+  return nSwaps;
+}
+
+TEST(QubitRouterTester, checkAdjacentGates) {
+  auto f = std::make_shared<GateFunction>("foo");
+  Edges line;
+  for (int q = 0; q < 5; q++) {
+    line.push_back({q, q + 1});
+    f->addInstruction(std::make_shared<CNOT>(q, q + 1));
+  }
+
+  QubitRouter router(line);
+  auto routed = router.route(f);
+  EXPECT_EQ(0, checkRouting(f, routed, line));
+  EXPECT_EQ(5, routed->nInstructions());
+}
+
+TEST(QubitRouterTester, checkGrid) {
+  auto edges = grid(5, 5);
+  auto f = randomCircuit(25, 2000);
+  QubitRouter router(edges);
+  auto nSwaps = checkRouting(f, router.route(f), edges);
+  EXPECT_GT(nSwaps, 0);
+}
+
+TEST(QubitRouterTester, checkHeavyHex) {
+  // 5 rows of 11 qubits and 12 bridge qubits
+  auto edges = heavyHex(5, 11);
+  auto f = randomCircuit(50, 1000);
+  QubitRouter router(edges);
+  auto nSwaps = checkRouting(f, router.route(f), edges);
+  EXPECT_GT(nSwaps, 0);
+}
+
+TEST(QubitRouterTester, DISABLED_benchmarkHeavyHex) {
+  auto edges = heavyHex(5, 11);
+  auto f = randomCircuit(50, 10000);
+  QubitRouter router(edges);
+
+  auto begin = std::chrono::steady_clock::now();
+  auto routed = router.route(f);
+  auto ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin)
+                .count();
+  auto nSwaps = checkRouting(f, routed, edges);
+  std::cout << "Routed 50 qubits, 10000 gates onto heavy-hex in " << ms
+            << " ms with " << nSwaps << " swaps.\n";
+  EXPECT_LT(ms, 1000.0);
+}
+
+TEST(QubitRouterTester, checkLayout) {
+  // Qubits 0 and 3 interact, and should be placed side by side
+  auto f = std::make_shared<GateFunction>("foo");
+  for (int i = 0; i < 10; i++) {
+    f->addInstruction(std::make_shared<CNOT>(0, 3));
+  }
+  Edges line{{0, 1}, {1, 2}, {2, 3}};
+  QubitRouter router(line);
+  EXPECT_EQ(0, checkRouting(f, router.route(f), line));
+}
+
+TEST(QubitRouterTester, checkDirected) {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<CNOT>(1, 0));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+
+  Edges edges{{0, 1}};
+  QubitRouter router(edges, true);
+  auto routed = router.route(f);
+  for (auto &inst : routed->getInstructions()) {
+    if (inst->name() == "CNOT") {
+      EXPECT_EQ(0, inst->bits()[0]);
+      EXPECT_EQ(1, inst->bits()[1]);
+    }
+  }
+  EXPECT_EQ(6, routed->nInstructions());
+}
+
+TEST(QubitRouterTester, checkConditional) {
+  // The conditional CNOT couples the ends of a line
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<CNOT>(1, 2));
+  f->addInstruction(std::make_shared<CNOT>(2, 3));
+  f->addInstruction(std::make_shared<Measure>(0, 0));
+  auto conditional = std::make_shared<ConditionalFunction>(0);
+  conditional->addInstruction(std::make_shared<CNOT>(3, 0));
+  f->addInstruction(conditional);
+
+  Edges line{{0, 1}, {1, 2}, {2, 3}};
+  for (auto directed : {false, true}) {
+    QubitRouter router(line, directed);
+    auto routed = router.route(f);
+    auto mapped = std::dynamic_pointer_cast<ConditionalFunction>(
+        routed->getInstruction(routed->nInstructions() - 1));
+    ASSERT_TRUE(mapped != nullptr);
+
+    // Follow the logical qubits through the Swaps in the body
+    auto layout = routed->getBitMap();
+    std::vector<int> held(4, -1);
+    for (int l = 0; l < layout.size(); l++) {
+      held[layout[l]] = l;
+    }
+    auto before = held;
+    std::vector<std::pair<int, int>> cnots;
+    for (auto &inst : mapped->getInstructions()) {
+      auto bits = inst->bits();
+      if (bits.size() == 2) {
+        EXPECT_EQ(1, std::abs(bits[0] - bits[1]));
+      }
+      if (inst->name() == "Swap") {
+        std::swap(held[bits[0]], held[bits[1]]);
+      } else if (inst->name() == "CNOT") {
+        // Directed edges run up the line
+        EXPECT_TRUE(!directed || bits[0] < bits[1]);
+        cnots.push_back({held[bits[0]], held[bits[1]]});
+      }
+    }
+    if (!directed) {
+      std::vector<std::pair<int, int>> expected{{3, 0}};
+      EXPECT_EQ(expected, cnots);
+      EXPECT_EQ(before, held);
+    }
+  }
+}
+
+TEST(QubitRouterTester, checkParametersAndMeasurements) {
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<InstructionParameter>{InstructionParameter("theta")});
+  auto rz = std::make_shared<Rz>(2, 0.0);
+  InstructionParameter p("theta");
+  rz->setParameter(0, p);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(rz);
+  f->addInstruction(std::make_shared<CNOT>(0, 2));
+  f->addInstruction(std::make_shared<CNOT>(1, 2));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<Measure>(2, 2));
+
+  // A star, no triangle of qubits is coupled
+  Edges edges{{0, 1}, {0, 2}, {0, 3}};
+  QubitRouter router(edges);
+  auto ir = std::make_shared<GateIR>();
+  ir->addKernel(f);
+  auto routed = router.transform(ir)->getKernels()[0];
+
+  checkRouting(f, routed, edges);
+  EXPECT_EQ(1, routed->nParameters());
+  EXPECT_EQ("theta", routed->getParameter(0).as<std::string>());
+  InstPtr measure;
+  for (auto &inst : routed->getInstructions()) {
+    if (inst->name() == "Measure") {
+      measure = inst;
+    }
+  }
+  EXPECT_EQ(2, measure->getParameter(0).as<int>());
+  EXPECT_EQ(routed->getBitMap()[2], measure->bits()[0]);
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "XACC.hpp"
+#include "xacc_service.hpp"
+#include "SingleQubitFusion.hpp"
+#include "InstructionIterator.hpp"
+#include "GateIR.hpp"
+#include "DigitalGates.hpp"
+#include <cmath>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+using Unitary = std::vector<std::vector<std::complex<double>>>;
+
+// Apply a gate to every column of the unitary, written
+// independently of the matrices in SingleQubitFusion
+void apply(Unitary &u, Instruction &inst) {
+  const std::complex<double> I(0.0, 1.0);
+  auto name = inst.name();
+  auto bits = inst.bits();
+  auto angle = [&](const int i) { return inst.getParameter(i).as<double>(); };
+
+  for (auto &col : u) {
+    if (name == "CNOT") {
+      for (int s = 0; s < col.size(); s++) {
+        if ((s >> bits[0] & 1) && !(s >> bits[1] & 1)) {
+          std::swap(col[s], col[s | 1 << bits[1]]);
+        }
+      }
+      continue;
+    }
+
+    std::complex<double> m00 = 1, m01 = 0, m10 = 0, m11 = 1;
+    if (name == "H") {
+      m00 = m01 = m10 = 1 / std::sqrt(2.0);
+      m11 = -m00;
+    } else if (name == "X") {
+      m00 = m11 = 0;
+      m01 = m10 = 1;
+    } else if (name == "Y") {
+      m00 = m11 = 0;
+      m01 = -I;
+      m10 = I;
+    } else if (name == "Z") {
+      m11 = -1;
+    } else if (name == "S") {
+      m11 = I;
+    } else if (name == "Sdg") {
+      m11 = -I;
+    } else if (name == "T") {
+      m11 = std::polar(1.0, M_PI / 4);
+    } else if (name == "Tdg") {
+      m11 = std::polar(1.0, -M_PI / 4);
+    } else if (name == "Rx") {
+      m00 = m11 = std::cos(angle(0) / 2);
+      m01 = m10 = -I * std::sin(angle(0) / 2);
+    } else if (name == "Ry") {
+      m00 = m11 = std::cos(angle(0) / 2);
+      m01 = -std::sin(angle(0) / 2);
+      m10 = std::sin(angle(0) / 2);
+    } else if (name == "Rz") {
+      m00 = std::polar(1.0, -angle(0) / 2);
+      m11 = std::polar(1.0, angle(0) / 2);
+    } else if (name == "U") {
+      // u3(theta, phi, lambda) = Rz(phi) Ry(theta) Rz(lambda)
+      auto t = angle(0), p = angle(1), l = angle(2);
+      m00 = std::polar(1.0, -(p + l) / 2) * std::cos(t / 2);
+      m01 = -std::polar(1.0, -(p - l) / 2) * std::sin(t / 2);
+      m10 = std::polar(1.0, (p - l) / 2) * std::sin(t / 2);
+      m11 = std::polar(1.0, (p + l) / 2) * std::cos(t / 2);
+    }
+
+    int q = bits[0];
+    for (int s = 0; s < col.size(); s++) {
+      if (!(s >> q & 1)) {
+        auto a = col[s], b = col[s | 1 << q];
+        col[s] = m00 * a + m01 * b;
+        col[s | 1 << q] = m10 * a + m11 * b;
+      }
+    }
+  }
+}
+
+Unitary unitary(std::shared_ptr<Function> f, const int nQubits) {
+  Unitary u(1 << nQubits, std::vector<std::complex<double>>(1 << nQubits));
+  for (int i = 0; i < u.size(); i++) {
+    u[i][i] = 1.0;
+  }
+  for (auto &inst : InstructionRange(f, Traversal::EnabledLeaves)) {
+    apply(u, *inst);
+  }
+  return u;
+}
+
+// Largest entry difference after removing the global phase
+double distance(const Unitary &a, const Unitary &b) {
+  std::complex<double> phase = 1.0;
+  double largest = 0.0;
+  for (int i = 0; i < a.size(); i++) {
+    for (int j = 0; j < a.size(); j++) {
+      if (std::abs(a[i][j]) > largest) {
+        largest = std::abs(a[i][j]);
+        phase = b[i][j] / a[i][j];
+      }
+    }
+  }
+  double d = 0.0;
+  for (int i = 0; i < a.size(); i++) {
+    for (int j = 0; j < a.size(); j++) {
+      d = std::max(d, std::abs(b[i][j] - phase * a[i][j]));
+    }
+  }
+  return d;
+}
+
+int nEnabled(std::shared_ptr<Function> f) {
+  int n = 0;
+  for (auto &inst : InstructionRange(f, Traversal::EnabledLeaves)) {
+    n++;
+  }
+  return n;
+}
+
+TEST(SingleQubitFusionTester, checkIdentityRuns) {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<Rz>(1, 0.3));
+  f->addInstruction(std::make_shared<Rz>(1, -0.3));
+  f->addInstruction(std::make_shared<X>(2));
+  f->addInstruction(std::make_shared<Y>(2));
+  f->addInstruction(std::make_shared<Z>(2));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<S>(0));
+  f->addInstruction(std::make_shared<T>(0));
+
+  EXPECT_EQ(8, SingleQubitFusion::fuse(f));
+  auto optF = f->enabledView();
+  EXPECT_EQ(2, optF->nInstructions());
+  EXPECT_EQ("CNOT", optF->getInstruction(0)->name());
+  EXPECT_EQ("U", optF->getInstruction(1)->name());
+  EXPECT_NEAR(0.0, optF->getInstruction(1)->getParameter(0).as<double>(),
+              1e-12);
+}
+
+TEST(SingleQubitFusionTester, checkSymbolic) {
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<InstructionParameter>{InstructionParameter("theta")});
+  auto rz = std::make_shared<Rz>(0, 0.0);
+  InstructionParameter p("theta");
+  rz->setParameter(0, p);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(rz);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  EXPECT_EQ(0, SingleQubitFusion::fuse(f));
+
+  // Fuses once bound
+  auto evaled = (*f)(std::vector<double>{0.7});
+  EXPECT_EQ(2, SingleQubitFusion::fuse(
+                   std::dynamic_pointer_cast<GateFunction>(evaled)));
+  auto optF = evaled->enabledView();
+  EXPECT_EQ(1, optF->nInstructions());
+  EXPECT_EQ("U", optF->getInstruction(0)->name());
+}
+
+TEST(SingleQubitFusionTester, checkUnitaryEquivalence) {
+  std::srand(5);
+  auto uniform = []() { return 2 * M_PI * std::rand() / RAND_MAX - M_PI; };
+  for (int trial = 0; trial < 20; trial++) {
+    auto f = std::make_shared<GateFunction>("foo");
+    for (int i = 0; i < 60; i++) {
+      int q = std::rand() % 3;
+      switch (std::rand() % 12) {
+      case 0:
+        f->addInstruction(std::make_shared<Hadamard>(q));
+        break;
+      case 1:
+        f->addInstruction(std::make_shared<X>(q));
+        break;
+      case 2:
+        f->addInstruction(std::make_shared<Y>(q));
+        break;
+      case 3:
+        f->addInstruction(std::make_shared<S>(q));
+        break;
+      case 4:
+        f->addInstruction(std::make_shared<Tdg>(q));
+        break;
+      case 5:
+        f->addInstruction(std::make_shared<Rx>(q, uniform()));
+        break;
+      case 6:
+        f->addInstruction(std::make_shared<Ry>(q, uniform()));
+        break;
+      case 7:
+        f->addInstruction(std::make_shared<Rz>(q, uniform()));
+        break;
+      case 8:
+        f->addInstruction(std::make_shared<U>(q, uniform(), uniform(), uniform()));
+        break;
+      case 9:
+        // Near the theta = 0 and theta = pi corners
+        f->addInstruction(std::make_shared<Ry>(q, trial % 2 ? 1e-9 : M_PI - 1e-9));
+        break;
+      default:
+        f->addInstruction(std::make_shared<CNOT>(q, (q + 1) % 3));
+      }
+    }
+
+    auto before = unitary(f, 3);
+    auto n = nEnabled(f);
+    auto nRemoved = SingleQubitFusion::fuse(f);
+    EXPECT_GT(nRemoved, 0);
+    EXPECT_EQ(n - nRemoved, nEnabled(f));
+    EXPECT_LT(distance(before, unitary(f, 3)), 1e-9);
+  }
+}
+
+TEST(SingleQubitFusionTester, checkTransformation) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto inner = std::make_shared<GateFunction>("inner");
+  f->addInstruction(std::make_shared<Rx>(0, 0.5));
+  inner->addInstruction(std::make_shared<Ry>(0, 0.5));
+  f->addInstruction(inner);
+  f->addInstruction(std::make_shared<Rz>(0, 0.5));
+  auto ir = std::make_shared<GateIR>();
+  ir->addKernel(f);
+
+  auto before = unitary(f, 1);
+  auto fusion = xacc::getService<IRTransformation>("single-qubit-fusion");
+  fusion->transform(ir);
+  EXPECT_EQ(1, nEnabled(f));
+  EXPECT_EQ("U", f->getInstruction(0)->name());
+  EXPECT_LT(distance(before, unitary(f, 1)), 1e-12);
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
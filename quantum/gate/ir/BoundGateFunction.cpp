@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "BoundGateFunction.hpp"
+#include "xacc_service.hpp"
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+// Create an unparameterized copy of the given Instruction,
+// GateInstructions are cloned directly, anything else goes
+// through the gate IRProvider.
+InstPtr newInstance(InstPtr inst, std::shared_ptr<IRProvider> &provider) {
+  auto gateInst = std::dynamic_pointer_cast<GateInstruction>(inst);
+  if (gateInst) {
+    auto cloned = gateInst->clone();
+    cloned->setBits(inst->bits());
+    return cloned;
+  }
+
+  if (!provider) {
+    provider = xacc::getService<IRProvider>("gate");
+  }
+  return provider->createInstruction(inst->name(), inst->bits());
+}
+} // namespace
+
+BoundGateFunction::BoundGateFunction(GateFunction &function)
+    : variables(function.nParameters(), 0.0) {
+
+  symbolTable.add_constants();
+  for (int i = 0; i < variables.size(); i++) {
+    auto var = function.getParameter(i).as<std::string>();
+    symbolTable.add_variable(var, variables[i]);
+  }
+
+  std::shared_ptr<IRProvider> provider;
+  evaluatedFunction =
+      std::make_shared<GateFunction>("evaled_" + function.name());
+
+  for (auto &inst : function.getInstructions()) {
+    if (inst->isComposite()) {
+      auto gateFunction = std::dynamic_pointer_cast<GateFunction>(inst);
+      if (gateFunction) {
+        // Compile nested GateFunctions into their own plan
+        auto child = std::make_shared<BoundGateFunction>(*gateFunction);
+        slots.push_back({SlotKind::Child, (int)children.size()});
+        children.push_back(child);
+        evaluatedFunction->addInstruction(child->evaluatedFunction);
+      } else {
+        slots.push_back({SlotKind::Composite, (int)composites.size()});
+        composites.push_back(std::dynamic_pointer_cast<Function>(inst));
+        evaluatedFunction->borrowInstruction(inst);
+      }
+    } else if (inst->isParameterized() && inst->getParameter(0).isVariable()) {
+      Binding binding;
+      binding.instruction = newInstance(inst, provider);
+      binding.expression.register_symbol_table(symbolTable);
+      parser_t parser;
+      parser.compile(inst->getParameter(0).as<std::string>(),
+                     binding.expression);
+
+      slots.push_back({SlotKind::Bound, (int)bindings.size()});
+      evaluatedFunction->addInstruction(binding.instruction);
+      bindings.push_back(binding);
+    } else {
+      slots.push_back({SlotKind::Shared, -1});
+      evaluatedFunction->borrowInstruction(inst);
+    }
+  }
+}
+
+std::shared_ptr<GateFunction> BoundGateFunction::
+operator()(const std::vector<double> &params) {
+  if (params.size() != variables.size()) {
+    xacc::error("Invalid GateFunction evaluation: number "
+                "of parameters don't match. " +
+                std::to_string(params.size()) + ", " +
+                std::to_string(variables.size()));
+  }
+
+  std::copy(params.begin(), params.end(), variables.begin());
+
+  for (auto &binding : bindings) {
+    InstructionParameter value(binding.expression.value());
+    binding.instruction->setParameter(0, value);
+  }
+
+  for (auto &child : children) {
+    (*child)(params);
+  }
+
+  if (!composites.empty()) {
+    for (int i = 0; i < slots.size(); i++) {
+      if (slots[i].kind == SlotKind::Composite) {
+        auto evaled = composites[slots[i].index]->operator()(params);
+        evaluatedFunction->replaceInstruction(i, evaled);
+      }
+    }
+  }
+
+  return evaluatedFunction;
+}
+
+std::shared_ptr<GateFunction> BoundGateFunction::copy() {
+  auto result = std::make_shared<GateFunction>(evaluatedFunction->name());
+  std::shared_ptr<IRProvider> provider;
+  for (int i = 0; i < slots.size(); i++) {
+    auto inst = evaluatedFunction->getInstruction(i);
+    switch (slots[i].kind) {
+    case SlotKind::Bound: {
+      auto updated = newInstance(inst, provider);
+      auto value = inst->getParameter(0);
+      updated->setParameter(0, value);
+      result->addInstruction(updated);
+      break;
+    }
+    case SlotKind::Child:
+      result->addInstruction(children[slots[i].index]->copy());
+      break;
+    default:
+      result->borrowInstruction(inst);
+      break;
+    }
+  }
+  return result;
+}
+
+} // namespace quantum
+} // namespace xacc
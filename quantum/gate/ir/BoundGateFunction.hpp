@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_IR_BOUNDGATEFUNCTION_HPP_
+#define QUANTUM_GATE_IR_BOUNDGATEFUNCTION_HPP_
+
+#include "GateFunction.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The BoundGateFunction is a reusable evaluation plan for a
+ * parameterized GateFunction. On construction it compiles every
+ * string parameter expression once against a single symbol table and
+ * preallocates the evaluated Instructions. Each evaluation then only
+ * writes the new variable values and re-evaluates the compiled
+ * expressions, so its cost scales with the number of parameterized gates.
+ *
+ * The plan captures the structure of the GateFunction at construction
+ * time. Later edits to that GateFunction are not reflected here.
+ * Unparameterized gates are borrowed from it, see
+ * GateFunction::borrowInstruction().
+ */
+class BoundGateFunction {
+
+public:
+  /**
+   * The constructor, takes the GateFunction to compile.
+   *
+   * @param function The parameterized GateFunction
+   */
+  BoundGateFunction(GateFunction &function);
+
+  /**
+   * Evaluate the plan at the given parameters. The returned
+   * GateFunction is owned by this plan and is updated in place on
+   * every call, use copy() to keep a given evaluation around.
+   *
+   * @param params The parameter values, one per GateFunction parameter
+   * @return evaluated The evaluated GateFunction
+   */
+  std::shared_ptr<GateFunction> operator()(const std::vector<double> &params);
+
+  /**
+   * Return a GateFunction independent of this plan holding the
+   * result of the last evaluation. Only the parameterized
+   * Instructions are copied, all others are borrowed.
+   *
+   * @return evaluated A copy of the last evaluation
+   */
+  std::shared_ptr<GateFunction> copy();
+
+  /**
+   * Return the number of parameters this plan expects.
+   *
+   * @return nParameters The number of parameters
+   */
+  const int nParameters() { return variables.size(); }
+
+protected:
+  /**
+   * A compiled parameter expression and the
+   * Instruction its value is written to.
+   */
+  struct Binding {
+    InstPtr instruction;
+    expression_t expression;
+  };
+
+  /**
+   * How to produce each Instruction of the evaluated function.
+   */
+  enum class SlotKind { Shared, Bound, Child, Composite };
+
+  struct Slot {
+    SlotKind kind;
+    int index;
+  };
+
+  /**
+   * The variable values the compiled expressions read from.
+   * Sized once at construction, the symbol table holds
+   * references into this vector.
+   */
+  std::vector<double> variables;
+
+  symbol_table_t symbolTable;
+
+  std::vector<Binding> bindings;
+
+  std::vector<std::shared_ptr<BoundGateFunction>> children;
+
+  /**
+   * Composite Instructions that are not GateFunctions,
+   * evaluated through Function::operator() on every call.
+   */
+  std::vector<std::shared_ptr<Function>> composites;
+
+  std::vector<Slot> slots;
+
+  std::shared_ptr<GateFunction> evaluatedFunction;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
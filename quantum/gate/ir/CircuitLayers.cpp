@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "CircuitLayers.hpp"
+#include <algorithm>
+
+namespace xacc {
+namespace quantum {
+
+void CircuitLayers::append(InstPtr inst) {
+  if (!inst->isEnabled()) {
+    return;
+  }
+
+  if (inst->isComposite()) {
+    for (auto &i : std::dynamic_pointer_cast<Function>(inst)->getInstructions()) {
+      append(i);
+    }
+    return;
+  }
+
+  auto bits = inst->bits();
+  if (bits.empty()) {
+    return;
+  }
+
+  // The gate goes one layer after the latest gate on any of its qubits
+  int layer = 0, predecessor = -1;
+  for (auto b : bits) {
+    if (b >= frontier.size()) {
+      frontier.resize(b + 1, -1);
+    }
+    auto last = frontier[b];
+    if (last >= 0 && gates[last].layer + 1 > layer) {
+      layer = gates[last].layer + 1;
+      predecessor = last;
+    }
+  }
+
+  int idx = gates.size();
+  gates.push_back({inst, layer, predecessor});
+  for (auto b : bits) {
+    frontier[b] = idx;
+  }
+
+  if (layer == layers.size()) {
+    layers.emplace_back();
+  }
+  layers[layer].push_back(idx);
+}
+
+void CircuitLayers::clear() {
+  gates.clear();
+  layers.clear();
+  frontier.clear();
+}
+
+std::vector<InstPtr> CircuitLayers::getLayer(const int layerIdx) const {
+  std::vector<InstPtr> layer;
+  if (layerIdx >= 0 && layerIdx < layers.size()) {
+    for (auto idx : layers[layerIdx]) {
+      layer.push_back(gates[idx].inst);
+    }
+  }
+  return layer;
+}
+
+std::vector<InstPtr> CircuitLayers::criticalPath() const {
+  std::vector<InstPtr> path;
+  if (layers.empty()) {
+    return path;
+  }
+
+  // Walk back from a gate in the last layer
+  for (int idx = layers.back().front(); idx >= 0;
+       idx = gates[idx].predecessor) {
+    path.push_back(gates[idx].inst);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+} // namespace quantum
+} // namespace xacc
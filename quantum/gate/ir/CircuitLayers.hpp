@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_IR_CIRCUITLAYERS_HPP_
+#define QUANTUM_GATE_IR_CIRCUITLAYERS_HPP_
+
+#include "Function.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * CircuitLayers schedules the enabled gates of a circuit into
+ * as-soon-as-possible layers as they are appended. It keeps the
+ * layer of the last gate on each qubit (the frontier), so appending
+ * a gate costs O(number of its qubits), and depth queries are O(1).
+ * Composite Instructions are scheduled gate by gate.
+ */
+class CircuitLayers {
+
+public:
+  /**
+   * Schedule the given Instruction after all
+   * previously appended Instructions.
+   *
+   * @param inst The Instruction to append
+   */
+  void append(InstPtr inst);
+
+  /**
+   * Forget all scheduled Instructions.
+   */
+  void clear();
+
+  /**
+   * Return the number of layers.
+   *
+   * @return depth The circuit depth
+   */
+  const int depth() const { return layers.size(); }
+
+  /**
+   * Return the gates in the given layer.
+   *
+   * @param layerIdx The layer index, from 0 to depth() - 1
+   * @return gates The gates in that layer
+   */
+  std::vector<InstPtr> getLayer(const int layerIdx) const;
+
+  /**
+   * Return a longest chain of dependent gates,
+   * one gate per layer, in circuit order.
+   *
+   * @return path The gates on the critical path
+   */
+  std::vector<InstPtr> criticalPath() const;
+
+protected:
+  struct ScheduledGate {
+    InstPtr inst;
+    int layer;
+    // The gate this one waits on, or -1
+    int predecessor;
+  };
+
+  std::vector<ScheduledGate> gates;
+
+  // The gate indices in each layer
+  std::vector<std::vector<int>> layers;
+
+  // The index of the last gate on each qubit, or -1
+  std::vector<int> frontier;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
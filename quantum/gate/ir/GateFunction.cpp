@@ -5,8 +5,9 @@
 #include <string>
 #include "Function.hpp"
 #include "InstructionIterator.hpp"
-#include "IRToGraphVisitor.hpp"
+#include "CircuitDAG.hpp"
 #include "IRGenerator.hpp"
+#include "BoundGateFunction.hpp"
 #include "xacc_service.hpp"
 
 #include "Graph.hpp"
@@ -22,10 +23,12 @@ namespace xacc {
 namespace quantum {
 
 void GateFunction::mapBits(std::vector<int> bitMap) {
+  modified();
   for (auto i : instructions) {
     i->mapBits(bitMap);
   }
   setBitMap(bitMap);
+  layersDirty = true;
 }
 
 void GateFunction::persist(std::ostream &outStream) {
@@ -59,6 +62,7 @@ void GateFunction::persist(std::ostream &outStream) {
 //     ]
 // }
 void GateFunction::load(std::istream &inStream) {
+  modified();
 
   std::vector<std::string> irGeneratorNames;
   auto irgens = xacc::getRegisteredIds<xacc::IRGenerator>();
@@ -163,9 +167,10 @@ void GateFunction::load(std::istream &inStream) {
 
 void GateFunction::expandIRGenerators(
     std::map<std::string, InstructionParameter> irGenMap) {
-  std::list<InstPtr> newinsts;
-  for (int idx = 0; idx < nInstructions(); idx++) {
-    auto inst = getInstruction(idx);
+  modified();
+  std::vector<InstPtr> newinsts;
+  newinsts.reserve(instructions.size());
+  for (auto &inst : instructions) {
     auto irg = std::dynamic_pointer_cast<IRGenerator>(inst);
     if (irg) {
       auto evaluated = irg->generate(irGenMap);
@@ -178,7 +183,15 @@ void GateFunction::expandIRGenerators(
     }
   }
 
+  // Rebuild the variable references and layering from scratch
+  for (auto &inst : instructions) {
+    inst->detach(this);
+  }
   instructions.clear();
+  symbols.clear();
+  declareParameters();
+  layering.clear();
+  layersDirty = false;
 
   for (auto i : newinsts) {
     addInstruction(i);
@@ -186,8 +199,7 @@ void GateFunction::expandIRGenerators(
 }
 
 bool GateFunction::hasIRGenerators() {
-  for (int idx = 0; idx < nInstructions(); idx++) {
-    auto inst = getInstruction(idx);
+  for (auto &inst : instructions) {
     auto irg = std::dynamic_pointer_cast<IRGenerator>(inst);
     if (irg) {
       return true;
@@ -198,15 +210,15 @@ bool GateFunction::hasIRGenerators() {
 
 const int GateFunction::nInstructions() { return instructions.size(); }
 
-std::list<InstPtr> GateFunction::getInstructions() { return instructions; }
+std::vector<InstPtr> GateFunction::getInstructions() { return instructions; }
 
 const std::string GateFunction::name() const { return functionName; }
 
 const std::vector<int> GateFunction::bits() {
   // Functions should return the unique bits that they operate on
   std::set<int> bits;
-  for (int i = 0; i < nInstructions(); i++) {
-    for (auto &b : getInstruction(i)->bits()) {
+  for (auto &inst : instructions) {
+    for (auto &b : inst->bits()) {
       bits.insert(b);
     }
   }
@@ -214,65 +226,39 @@ const std::vector<int> GateFunction::bits() {
   return output;
 }
 
-// lambda functions for determining if an InstructionParameter is a
-// number/double or a variable
-auto isInt = [](std::string s) {
-  try {
-    std::stoi(s);
-    return true;
-  } catch (...) {
-    return false;
-  }
-};
-auto isDouble = [](std::string s) {
-  try {
-    std::stod(s);
-    return true;
-  } catch (...) {
-    return false;
+std::string GateFunction::variable(InstPtr inst) {
+  if (inst->nParameters() == 1) {
+    auto param = inst->getParameter(0);
+    if (param.isVariable()) {
+      return symbols.variable(param.as<std::string>());
+    }
   }
-};
-auto isNumber = [](std::string s) {
-  if (isInt(s) || isDouble(s)) {
-    return true;
-  } else {
-    return false;
+  return "";
+}
+
+void GateFunction::retainVariable(const std::string &var) {
+  if (!var.empty() && symbols.retain(var)) {
+    parameters.push_back(var);
   }
-};
-// Lambda function for extracting the stripped (no mathematical operators or
-// numbers/doubles) parameter
-auto splitParameter = [](InstructionParameter instParam) {
-  std::vector<std::string> split;
-  InstructionParameter rawParam;
-  auto paramStr = mpark::get<std::string>(instParam);
-  std::replace(mpark::get<std::string>(instParam).begin(),
-               mpark::get<std::string>(instParam).end(), '-', ' ');
-  std::replace(mpark::get<std::string>(instParam).begin(),
-               mpark::get<std::string>(instParam).end(), '+', ' ');
-  std::replace(mpark::get<std::string>(instParam).begin(),
-               mpark::get<std::string>(instParam).end(), '*', ' ');
-  std::replace(mpark::get<std::string>(instParam).begin(),
-               mpark::get<std::string>(instParam).end(), '/', ' ');
-
-  auto instParamStr = instParam.as<std::string>();
-  split = xacc::split(instParamStr, ' ');
-  for (auto s : split) {
-    if (!isNumber(s) && !s.empty()) {
-      rawParam = s;
+}
+
+void GateFunction::releaseVariable(const std::string &var) {
+  if (!var.empty() && symbols.release(var)) {
+    // Variables are unique, search from the back where the
+    // most recently added ones live
+    auto it = std::find(parameters.rbegin(), parameters.rend(),
+                        InstructionParameter(var));
+    if (it != parameters.rend()) {
+      parameters.erase(std::next(it).base());
     }
   }
-  return rawParam;
-};
+}
 
 const int GateFunction::nLogicalBits() {
   std::set<int> local_bits;
-  xacc::InstructionIterator it(shared_from_this());
-  while (it.hasNext()) {
-    auto nextInst = it.next();
-    if (nextInst->isEnabled()) {
-      for (auto &i : nextInst->bits()) {
-        local_bits.insert(i);
-      }
+  for (auto &nextInst : InstructionRange(shared_from_this(), Traversal::Enabled)) {
+    for (auto &i : nextInst->bits()) {
+      local_bits.insert(i);
     }
   }
   return local_bits.size();
@@ -280,14 +266,10 @@ const int GateFunction::nLogicalBits() {
 
 const int GateFunction::nPhysicalBits() {
   int maxBitIdx = 0;
-  xacc::InstructionIterator it(shared_from_this());
-  while (it.hasNext()) {
-    auto nextInst = it.next();
-    if (nextInst->isEnabled()) {
-      for (auto &i : nextInst->bits()) {
-        if (maxBitIdx < i) {
-          maxBitIdx = i;
-        }
+  for (auto &nextInst : InstructionRange(shared_from_this(), Traversal::Enabled)) {
+    for (auto &i : nextInst->bits()) {
+      if (maxBitIdx < i) {
+        maxBitIdx = i;
       }
     }
   }
@@ -296,179 +278,95 @@ const int GateFunction::nPhysicalBits() {
   return maxBitIdx;
 }
 void GateFunction::removeInstruction(const int idx) {
+  modified();
   auto instruction = getInstruction(idx);
-  // Check to see if instruction being removed is parameterized
-  if (instruction->isParameterized() &&
-      instruction->getParameter(0).isVariable()) {
-    // Get InstructionParameter of instruction being removed
-    bool dupParam = false;
-    // strip the parameter of mathematical operators and numbers/doubles
-    InstructionParameter strippedParam =
-        splitParameter(instruction->getParameter(0));
-    // check if the InstructionParameter is a duplicate
-    for (auto i : instructions) {
-      if (i->isParameterized() &&
-          strippedParam == splitParameter(i->getParameter(0)) &&
-          instruction != i) {
-        dupParam = true;
+  // Drop the parameter once no other Instruction references it
+  releaseVariable(variable(instruction));
+  instruction->detach(this);
+  instructions.erase(instructions.begin() + idx);
+  layersDirty = true;
+}
+
+void GateFunction::removeDisabled() {
+  modified();
+  int kept = 0;
+  for (int i = 0; i < instructions.size(); i++) {
+    if (instructions[i]->isEnabled()) {
+      if (kept != i) {
+        instructions[kept] = std::move(instructions[i]);
       }
-    }
-    // If there are no parameters shared, then remove the parameter
-    if (!dupParam) {
-      parameters.erase(
-          std::remove(parameters.begin(), parameters.end(), strippedParam),
-          parameters.end());
+      kept++;
+    } else {
+      releaseVariable(variable(instructions[i]));
+      instructions[i]->detach(this);
     }
   }
-  // Remove instruction
-  instructions.remove(getInstruction(idx));
+  instructions.resize(kept);
+  layersDirty = true;
 }
 
 void GateFunction::addInstruction(InstPtr instruction) {
-  // Check to see if new GateInstruction is parameterized and there is only 1
-  // parameter
-  if (instruction->isParameterized() && instruction->nParameters() <= 1) {
-    xacc::InstructionParameter param = instruction->getParameter(0);
-    // Check to see if parameter is a string
-    if (param.isVariable()) {
-      // check to see if the new parameter is a duplicate parameter
-      bool dupParam = false;
-      // strip the parameter of mathematical operators and numbers/doubles
-      InstructionParameter strippedParam = splitParameter(param);
-      // check if the instruction parameter is a duplicate
-      for (auto p : parameters) {
-        if (p.as<std::string>() == strippedParam.as<std::string>()) {
-          dupParam = true;
-        }
-      }
-      // if new parameter is not a duplicate, add the stripped version
-      if (!dupParam) {
-        parameters.push_back(strippedParam);
-      }
-    }
+  auto hashCurrent = hashValid;
+  modified();
+  // Add the parameter if this is its first reference
+  retainVariable(variable(instruction));
+  instruction->attach(this);
+  instructions.push_back(instruction);
+  if (!layersDirty) {
+    layering.append(instruction);
+  }
+  if (hashCurrent) {
+    appendToHash(instruction);
   }
-  // Add the GateInstruction
+}
+
+void GateFunction::borrowInstruction(InstPtr instruction) {
+  modified();
+  retainVariable(variable(instruction));
   instructions.push_back(instruction);
+  borrowing = true;
+  layersDirty = true;
 }
 
 void GateFunction::replaceInstruction(const int idx, InstPtr replacingInst) {
-  auto currentInst = getInstruction(idx);
-  // Check if the GateInstruction being replaced is parameterized and if
-  // parameter is a string
-  if (currentInst->isParameterized() &&
-      currentInst->getParameter(0).isVariable()) {
-    // strip the current InstructionParameter of mathematical operators and
-    // numbers
-    InstructionParameter strippedCurrent =
-        splitParameter(currentInst->getParameter(0));
-    bool dupParam = false;
-    for (auto i : instructions) {
-      // see if current instruction has a duplicate parameter
-      if (strippedCurrent == splitParameter(i->getParameter(0)) &&
-          currentInst != i) {
-        dupParam = true;
-      }
-    }
-    // Check if new instruction is parameterized and if parameter is a string
-    if (replacingInst->isParameterized() &&
-        replacingInst->getParameter(0).isVariable()) {
-      InstructionParameter strippedNew =
-          splitParameter(replacingInst->getParameter(0));
-      // Check if current parameter is a duplicate parameter
-      bool newDupParam = false;
-      for (auto i : instructions) {
-        // see if new param has a duplicate parameter
-        if (strippedNew == splitParameter(i->getParameter(0))) {
-          newDupParam = true;
-        }
-      }
-      // Check if old GateInstruction parameter is different than new
-      // GateInstruction parameter
-      if (strippedCurrent != strippedNew) {
-        if (!dupParam) {
-          if (!newDupParam) {
-            // if the current GateInstruction and the new GateInstruction both
-            // do not have a parameter already in this GateFunction -> replace
-            // parameter
-            std::replace(parameters.begin(), parameters.end(), strippedCurrent,
-                         strippedNew);
-          } else {
-            // If the current GateInstruction is not a duplicate but the new one
-            // is  -> remove old parameter
-            parameters.erase(std::remove(parameters.begin(), parameters.end(),
-                                         strippedCurrent));
-          }
-        } else {
-          // if the current GateInstruction is a duplicate but the new one is
-          // not -> add new parameter
-          if (!newDupParam) {
-            parameters.push_back(strippedNew);
-          }
-        }
-      }
-      // if the current GateInstruction parameter is parameterized but the new
-      // one is not, check if the parameter is a duplicate and erase (or not)
-    } else if (!dupParam) {
-      parameters.erase(
-          std::remove(parameters.begin(), parameters.end(), strippedCurrent));
-    }
-    // if the current GateInstruction is not parameterized and the new
-    // GateInstruction is, try to add parameter
-  } else if (replacingInst->isParameterized() &&
-             replacingInst->getParameter(0).isVariable()) {
-    InstructionParameter strippedNew =
-        splitParameter(replacingInst->getParameter(0));
-    // Check if new parameter is a duplicate parameter
-    bool newDupParam = false;
-    for (auto i : instructions) {
-      if (i->isParameterized() &&
-          strippedNew == splitParameter(i->getParameter(0))) {
-        newDupParam = true;
-      }
-    }
-    // if new parameter is not a duplicate, add it to the parameters list
-    if (!newDupParam) {
-      parameters.push_back(strippedNew);
+  modified();
+  auto currentVar = variable(getInstruction(idx));
+  auto newVar = variable(replacingInst);
+  if (currentVar != newVar) {
+    if (!currentVar.empty() && !newVar.empty() &&
+        symbols.count(currentVar) == 1 && !symbols.contains(newVar)) {
+      // The new parameter takes the place of the old one
+      symbols.rename(currentVar, newVar);
+      std::replace(parameters.begin(), parameters.end(),
+                   InstructionParameter(currentVar),
+                   InstructionParameter(newVar));
+    } else {
+      retainVariable(newVar);
+      releaseVariable(currentVar);
     }
   }
-  // Replace old GateInstruction with new GateInstruction
-  std::replace(instructions.begin(), instructions.end(), getInstruction(idx),
-               replacingInst);
+  replacingInst->attach(this);
+  instructions[idx]->detach(this);
+  instructions[idx] = replacingInst;
+  layersDirty = true;
 }
 
 void GateFunction::insertInstruction(const int idx, InstPtr newInst) {
-  // Check if new GateInstruction is parameterized with 1 parameter
-  if (newInst->isParameterized() && !newInst->isComposite()) {
-    xacc::InstructionParameter param = newInst->getParameter(0);
-    // Check if new parameter is a string
-    if (param.isVariable()) {
-      // If new parameter is not already in parameter vector -> add parameter to
-      // GateFunction
-      bool dupParam = false;
-      // strip the parameter of mathematical operators and numbers/doubles
-      InstructionParameter strippedParam = splitParameter(param);
-      for (auto p : parameters) {
-        if (mpark::get<std::string>(p) ==
-            mpark::get<std::string>(strippedParam)) {
-          dupParam = true;
-        }
-      }
-      // If new parameter is not already in parameter vector -> add parameter to
-      // GateFunction
-      if (!dupParam) {
-        parameters.push_back(param);
-      }
-    }
+  modified();
+  retainVariable(variable(newInst));
+  newInst->attach(this);
+  if (idx == instructions.size() && !layersDirty) {
+    layering.append(newInst);
+  } else {
+    layersDirty = true;
   }
-  // Insert new GateInstruction to instructions vector
-  auto iter = std::next(instructions.begin(), idx);
-  instructions.insert(iter, newInst);
+  instructions.insert(instructions.begin() + idx, newInst);
 }
 
 InstPtr GateFunction::getInstruction(const int idx) {
   InstPtr i;
-  if (instructions.size() > idx) {
-    i = *std::next(instructions.begin(), idx);
+  if (idx >= 0 && instructions.size() > idx) {
+    i = instructions[idx];
   } else {
     xacc::error("GateFunction getInstruction invalid instruction index - " +
                 std::to_string(idx) + ".");
@@ -477,10 +375,14 @@ InstPtr GateFunction::getInstruction(const int idx) {
 }
 
 void GateFunction::setParameter(const int idx, InstructionParameter &p) {
+  modified();
   if (idx + 1 > parameters.size()) {
     XACCLogger::instance()->error("Invalid Parameter requested.");
   }
 
+  if (parameters[idx].isVariable() && p.isVariable()) {
+    symbols.rename(parameters[idx].as<std::string>(), p.as<std::string>());
+  }
   parameters[idx] = p;
 }
 
@@ -493,6 +395,10 @@ InstructionParameter GateFunction::getParameter(const int idx) const {
 }
 
 void GateFunction::addParameter(InstructionParameter instParam) {
+  modified();
+  if (instParam.isVariable()) {
+    symbols.declare(instParam.as<std::string>());
+  }
   parameters.push_back(instParam);
 }
 
@@ -523,56 +429,58 @@ GateFunction::operator()(const std::vector<double> &params) {
                 std::to_string(nParameters()));
   }
 
-  std::vector<double> p = params;
-  symbol_table_t symbol_table;
-  symbol_table.add_constants();
-  std::vector<std::string> variableNames;
-  std::vector<double> values;
-  for (int i = 0; i < params.size(); i++) {
-    auto var = getParameter(i).as<std::string>();
-    variableNames.push_back(var);
-    symbol_table.add_variable(var, p[i]);
+  std::lock_guard<std::mutex> lock(evaluationLock);
+  auto plan = currentPlan();
+  (*plan)(params);
+  return plan->copy();
+}
+
+std::vector<std::shared_ptr<Function>> GateFunction::evaluateBatch(
+    const std::vector<std::vector<double>> &paramSets) {
+  std::lock_guard<std::mutex> lock(evaluationLock);
+  auto plan = currentPlan();
+  std::vector<std::shared_ptr<Function>> evaluated;
+  evaluated.reserve(paramSets.size());
+  for (auto &params : paramSets) {
+    (*plan)(params);
+    evaluated.push_back(plan->copy());
   }
+  return evaluated;
+}
 
-  auto compileExpression = [&](InstructionParameter &p) -> double {
-    auto expression = mpark::get<std::string>(p);
-    expression_t expr;
-    expr.register_symbol_table(symbol_table);
-    parser_t parser;
-    parser.compile(expression, expr);
-    return expr.value();
-  };
-
-  auto gateRegistry = xacc::getService<IRProvider>("gate");
-  auto evaluatedFunction = std::make_shared<GateFunction>("evaled_" + name());
-
-  // Walk the IR Tree, handle functions and instructions differently
-  for (auto inst : getInstructions()) {
-    if (inst->isComposite()) {
-      // If a Function, call this method recursively
-      auto evaled = std::dynamic_pointer_cast<Function>(inst)->operator()(p);
-      evaluatedFunction->addInstruction(evaled);
-    } else {
-      // If a concrete GateInstruction, then check that it
-      // is parameterized and that it has a string parameter
-      if (inst->isParameterized() && inst->getParameter(0).isVariable()) {
-        InstructionParameter p = inst->getParameter(0);
-        std::stringstream s;
-        s << p.toString();
-        auto val = compileExpression(p);
-        InstructionParameter pnew(val);
-        auto updatedInst =
-            gateRegistry->createInstruction(inst->name(), inst->bits());
-        updatedInst->setParameter(0, pnew);
-        evaluatedFunction->addInstruction(updatedInst);
-      } else {
-        evaluatedFunction->addInstruction(inst);
-      }
+std::shared_ptr<BoundGateFunction> GateFunction::bind() {
+  return std::make_shared<BoundGateFunction>(*this);
+}
+
+std::shared_ptr<BoundGateFunction> GateFunction::currentPlan() {
+  // Clear the flag first, so edits made while binding
+  // are picked up by the next evaluation
+  if (planStale.exchange(false) || !evaluationPlan) {
+    evaluationPlan = bind();
+  }
+  return evaluationPlan;
+}
+
+const CircuitLayers &GateFunction::layers() {
+  if (layersDirty || borrowing) {
+    layering.clear();
+    for (auto &inst : instructions) {
+      layering.append(inst);
     }
+    layersDirty = false;
   }
-  return evaluatedFunction;
+  return layering;
+}
+
+const int GateFunction::depth() { return layers().depth(); }
+
+std::vector<InstPtr> GateFunction::getLayer(const int layerIdx) {
+  return layers().getLayer(layerIdx);
+}
+
+std::vector<InstPtr> GateFunction::criticalPath() {
+  return layers().criticalPath();
 }
-const int GateFunction::depth() { return toGraph()->depth() - 2; }
 
 const std::string GateFunction::persistGraph() {
   std::stringstream s;
@@ -581,29 +489,7 @@ const std::string GateFunction::persistGraph() {
 }
 
 std::shared_ptr<Graph> GateFunction::toGraph() {
-
-  // Compute number of qubits
-  int maxBit = 0;
-  InstructionIterator it(shared_from_this());
-  while (it.hasNext()) {
-    auto inst = it.next();
-    for (auto &b : inst->bits()) {
-      if (b > maxBit) {
-        maxBit = b;
-      }
-    }
-  }
-
-  auto visitor = std::make_shared<IRToGraphVisitor>(maxBit + 1);
-  InstructionIterator it2(shared_from_this());
-  while (it2.hasNext()) {
-    auto inst = it2.next();
-    if (inst->isEnabled()) {
-      inst->accept(visitor);
-    }
-  }
-
-  return visitor->getGraph();
+  return std::make_shared<CircuitDAG>(shared_from_this());
 }
 
 } // namespace quantum
@@ -16,9 +16,13 @@
 #include "Function.hpp"
 #include "IRProvider.hpp"
 #include "GateInstruction.hpp"
+#include "ParameterRegistry.hpp"
+#include "CircuitLayers.hpp"
+#include "InstructionIterator.hpp"
 #include "XACC.hpp"
 #include "exprtk.hpp"
-
+#include <atomic>
+#include <mutex>
 
 namespace xacc {
 
@@ -26,6 +30,8 @@ class Graph;
 
 namespace quantum {
 
+class BoundGateFunction;
+
 static constexpr double pi = 3.141592653589793238;
 
 using symbol_table_t = exprtk::symbol_table<double>;
@@ -51,17 +57,29 @@ public:
       : functionName(name), parameters(std::vector<InstructionParameter>{}) {}
   GateFunction(const std::string &name,
                std::vector<InstructionParameter> params)
-      : functionName(name), parameters(params) {}
+      : functionName(name), parameters(params) {
+    declareParameters();
+  }
 
   GateFunction(const std::string &name, const std::string &_tag)
       : functionName(name), parameters(std::vector<InstructionParameter>{}),
         tag(_tag) {}
   GateFunction(const std::string &name, const std::string &_tag,
                std::vector<InstructionParameter> params)
-      : functionName(name), parameters(params), tag(_tag) {}
+      : functionName(name), parameters(params), tag(_tag) {
+    declareParameters();
+  }
 
   GateFunction(const GateFunction &other)
-      : functionName(other.functionName), parameters(other.parameters) {}
+      : functionName(other.functionName), parameters(other.parameters) {
+    declareParameters();
+  }
+
+  virtual ~GateFunction() {
+    for (auto &inst : instructions) {
+      inst->detach(this);
+    }
+  }
 
   virtual void mapBits(std::vector<int> bitMap) override;
 
@@ -81,12 +99,31 @@ public:
 
   InstPtr getInstruction(const int idx) override;
 
-  std::list<InstPtr> getInstructions() override;
+  std::vector<InstPtr> getInstructions() override;
+
+  const InstPtr *instructionData() override { return instructions.data(); }
+
+  /**
+   * Return a view of the enabled Instructions of this GateFunction.
+   * Unlike enabledView() nothing is copied, the view reads this
+   * GateFunction directly and so sees later calls to enable() and
+   * disable(). It is invalidated by adding or removing Instructions.
+   *
+   * @return view The enabled direct children of this GateFunction
+   */
+  InstructionRange enabledInstructions() {
+    return InstructionRange(this, Traversal::EnabledChildren);
+  }
+
+  /**
+   * Remove all disabled Instructions in a single pass,
+   * keeping the enabled ones in order.
+   */
+  void removeDisabled() override;
 
   std::shared_ptr<Function> enabledView() override {
     auto newF = std::make_shared<GateFunction>(functionName, parameters);
-    for (int i = 0; i < nInstructions(); i++) {
-      auto inst = getInstruction(i);
+    for (auto &inst : instructions) {
       if (inst->isEnabled()) {
         // FIXME CLONE and add parameters and bits...
         newF->addInstruction(inst);
@@ -96,14 +133,19 @@ public:
   }
 
   void enable() override {
-    for (int i = 0; i < nInstructions(); i++) {
-      getInstruction(i)->enable();
+    for (auto &inst : instructions) {
+      inst->enable();
     }
+    layersDirty = true;
+  }
+
+  void childModified() override {
+    layersDirty = true;
+    Function::childModified();
   }
 
   const bool isAnalog() const override {
-    for (int i = 0; i < instructions.size(); i++) {
-      auto inst = *std::next(instructions.begin(), i);
+    for (auto &inst : instructions) {
       if (inst->isAnalog()) {
         return true;
       }
@@ -141,6 +183,25 @@ public:
 
   void insertInstruction(const int idx, InstPtr newInst) override;
 
+  /**
+   * Add an Instruction owned by another GateFunction, without
+   * becoming one of its parents. Edits made to it later are not
+   * reported here, so from then on this GateFunction recomputes
+   * its hash and layering on every query. Evaluation plans share
+   * unparameterized gates this way, so that gates do not collect
+   * a parent for every evaluated GateFunction.
+   *
+   * @param instruction The borrowed Instruction
+   */
+  void borrowInstruction(InstPtr instruction);
+
+  const std::uint64_t hash() override {
+    if (borrowing) {
+      hashValid = false;
+    }
+    return Function::hash();
+  }
+
   /**
    * Return the name of this function
    * @return
@@ -159,7 +220,33 @@ public:
    */
   const std::vector<int> bits() override;
 
+  /**
+   * Return the number of layers of enabled gates, with each gate
+   * scheduled as soon as its qubits are free. The layering is kept up
+   * to date as Instructions are added, so this is constant time after
+   * appends. Other edits, including edits to the Instructions held
+   * by this GateFunction, trigger a single rescan on the next query.
+   *
+   * @return depth The circuit depth
+   */
   const int depth() override;
+
+  /**
+   * Return the enabled gates in the given layer.
+   *
+   * @param layerIdx The layer index, from 0 to depth() - 1
+   * @return gates The gates in that layer
+   */
+  std::vector<InstPtr> getLayer(const int layerIdx);
+
+  /**
+   * Return a longest chain of dependent gates,
+   * one gate per layer, in circuit order.
+   *
+   * @return path The gates on the critical path
+   */
+  std::vector<InstPtr> criticalPath();
+
   const std::string persistGraph() override;
 
   /**
@@ -189,9 +276,41 @@ public:
 
   const int nParameters() override;
 
+  /**
+   * Evaluate this GateFunction at the given parameters, returning
+   * a new GateFunction with concrete gate parameters. The parameter
+   * expressions are compiled once and reused across calls until
+   * this GateFunction is modified.
+   *
+   * @param params The parameter values
+   * @return evaluated The evaluated GateFunction
+   */
   std::shared_ptr<Function>
   operator()(const std::vector<double> &params) override;
 
+  /**
+   * Evaluate this GateFunction at each of the given parameter sets.
+   * The parameter expressions are compiled once for the whole batch.
+   * Only parameterized gates are copied per parameter set, all
+   * other Instructions are shared by the returned GateFunctions,
+   * so memory grows with the number of parameterized gates.
+   *
+   * @param paramSets The parameter sets, one per row
+   * @return evaluated The evaluated GateFunctions
+   */
+  std::vector<std::shared_ptr<Function>> evaluateBatch(
+      const std::vector<std::vector<double>> &paramSets) override;
+
+  /**
+   * Compile this GateFunction into a reusable evaluation plan.
+   * Evaluating the plan updates a single preallocated GateFunction
+   * in place, which avoids all per-call allocations in loops that
+   * evaluate the same ansatz many times.
+   *
+   * @return plan The compiled evaluation plan
+   */
+  std::shared_ptr<BoundGateFunction> bind();
+
   std::shared_ptr<Graph> toGraph() override;
 
   /**
@@ -254,16 +373,83 @@ protected:
    */
   std::string functionName;
 
-  std::list<InstPtr> instructions;
+  /**
+   * The Instructions of this function, stored contiguously
+   * so that index-based access and traversal are constant time
+   * per Instruction. The shared_ptr elements serve as stable
+   * handles that remain valid across inserts and removals.
+   */
+  std::vector<InstPtr> instructions;
 
   std::vector<InstructionParameter> parameters;
 
+  /**
+   * The variables referenced by the Instructions, with the
+   * number of Instructions referencing each of them.
+   */
+  ParameterRegistry symbols;
+
+  /**
+   * Return the variable the given Instruction's
+   * parameter refers to, or an empty string.
+   */
+  std::string variable(InstPtr inst);
+
+  /**
+   * Add or drop a reference to a variable, adding it to or
+   * removing it from the parameters as needed.
+   */
+  void retainVariable(const std::string &var);
+  void releaseVariable(const std::string &var);
+
+  /**
+   * The layering of the enabled gates, rebuilt on the next
+   * query when layersDirty is set by an edit other than an append.
+   */
+  CircuitLayers layering;
+  bool layersDirty = false;
+
+  /**
+   * Set once this GateFunction holds a borrowed Instruction.
+   */
+  bool borrowing = false;
+
+  const CircuitLayers &layers();
+
+  void declareParameters() {
+    for (auto &p : parameters) {
+      if (p.isVariable()) {
+        symbols.declare(p.as<std::string>());
+      }
+    }
+  }
+
   std::string tag = "";
 
   std::map<std::string, InstructionParameter> options;
 
   std::vector<int> bitMap;
 
+  /**
+   * The evaluation plan used by operator(), rebuilt on the next
+   * evaluation once planStale is set. Every hash-changing edit of
+   * this GateFunction or of an Instruction nested in it sets it.
+   */
+  std::shared_ptr<BoundGateFunction> evaluationPlan;
+  std::atomic<bool> planStale{false};
+  std::mutex evaluationLock;
+
+  void modified() override {
+    planStale = true;
+    Function::modified();
+  }
+
+  /**
+   * Return the evaluation plan, binding a new one if this
+   * GateFunction changed since the last bind. Call with
+   * evaluationLock held.
+   */
+  std::shared_ptr<BoundGateFunction> currentPlan();
 };
 
 } // namespace quantum
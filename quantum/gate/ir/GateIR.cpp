@@ -26,19 +26,9 @@ std::string GateIR::toAssemblyString(const std::string &kernelName,
   auto kernel = getKernel(kernelName);
 
   std::set<int> qubitsUsed;
-  InstructionIterator it(kernel);
-  while (it.hasNext()) {
-    // Get the next node in the tree
-    auto nextInst = it.next();
-
-    // If enabled, invoke the accept
-    // method which kicks off the visitor
-    // to execute the appropriate lambda.
-    if (nextInst->isEnabled() && !nextInst->isComposite()) {
-
-      for (auto qi : nextInst->bits()) {
-        qubitsUsed.insert(qi);
-      }
+  for (auto &nextInst : InstructionRange(kernel, Traversal::EnabledLeaves)) {
+    for (auto qi : nextInst->bits()) {
+      qubitsUsed.insert(qi);
     }
   }
 
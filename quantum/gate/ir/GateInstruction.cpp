@@ -41,6 +41,7 @@ void GateInstruction::mapBits(std::vector<int> bitMap) {
   for (int i = 0; i < qbits.size(); i++) {
     qbits[i] = bitMap[qbits[i]];
   }
+  modified();
 }
 
 const std::string GateInstruction::toString() {
@@ -89,8 +90,14 @@ const std::string GateInstruction::toString(const std::string &bufferVarName) {
 }
 
 bool GateInstruction::isEnabled() { return enabled; }
-void GateInstruction::disable() { enabled = false; }
-void GateInstruction::enable() { enabled = true; }
+void GateInstruction::disable() {
+  enabled = false;
+  modified();
+}
+void GateInstruction::enable() {
+  enabled = true;
+  modified();
+}
 
 InstructionParameter GateInstruction::getParameter(const int idx) const {
   if (idx + 1 > parameters.size()) {
@@ -110,6 +117,7 @@ void GateInstruction::setParameter(const int idx, InstructionParameter &p) {
   }
 
   parameters[idx] = p;
+  modified();
 }
 
 std::vector<InstructionParameter> GateInstruction::getParameters() {
@@ -119,6 +127,14 @@ std::vector<InstructionParameter> GateInstruction::getParameters() {
 bool GateInstruction::isParameterized() { return nParameters() > 0; }
 const int GateInstruction::nParameters() { return parameters.size(); }
 
+const std::uint64_t GateInstruction::hash() {
+  if (!hashValid) {
+    hashValue = Instruction::hash();
+    hashValid = true;
+  }
+  return hashValue;
+}
+
 bool GateInstruction::hasOptions() { return !options.empty(); }
 void GateInstruction::setOption(const std::string optName,
                                 InstructionParameter option) {
@@ -51,6 +51,17 @@ protected:
    * Reference to this Instruction's set of options.
    */
   std::map<std::string, InstructionParameter> options;
+
+  /**
+   * The cached structural hash, dropped by every edit.
+   */
+  std::uint64_t hashValue = 0;
+  bool hashValid = false;
+
+  void modified() {
+    hashValid = false;
+    notifyParents();
+  }
   
   /**
    * This method is intended for subclasses. It is
@@ -91,7 +102,10 @@ public:
    * The copy constructor
    */
   GateInstruction(const GateInstruction &inst);
-  void setBits(const std::vector<int> bits) override { qbits = bits; }
+  void setBits(const std::vector<int> bits) override {
+    qbits = bits;
+    modified();
+  }
 
   /**
    * Return the instruction name.
@@ -224,6 +238,14 @@ public:
    */
   std::map<std::string, InstructionParameter> getOptions() override;
 
+  /**
+   * Return the structural hash of this gate, computed
+   * once and cached until the gate is edited.
+   *
+   * @return hash The 64 bit structural hash
+   */
+  const std::uint64_t hash() override;
+
   /**
    * This configures this Instruction with the appropriate
    * accept() method for the XACC IR InstructionVisitor pattern.
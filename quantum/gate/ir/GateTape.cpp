@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "GateTape.hpp"
+#include "ConditionalFunction.hpp"
+#include "xacc_service.hpp"
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+struct OpInfo {
+  std::string name;
+  int nBits;
+  int nParams;
+};
+
+// Indexed by GateOp, keep in the same order as the enum
+const std::vector<OpInfo> opInfos{
+    {"I", 1, 0},    {"H", 1, 0},       {"X", 1, 0},      {"Y", 1, 0},
+    {"Z", 1, 0},    {"S", 1, 0},       {"Sdg", 1, 0},    {"T", 1, 0},
+    {"Tdg", 1, 0},  {"Rx", 1, 1},      {"Ry", 1, 1},     {"Rz", 1, 1},
+    {"U", 1, 3},    {"Measure", 1, 1}, {"CNOT", 2, 0},   {"CY", 2, 0},
+    {"CZ", 2, 0},   {"CH", 2, 0},      {"Swap", 2, 0},   {"CPhase", 2, 1},
+    {"CRZ", 2, 1}};
+} // namespace
+
+bool GateTape::opcode(const std::string &name, GateOp &op) {
+  for (int i = 0; i < opInfos.size(); i++) {
+    if (opInfos[i].name == name) {
+      op = static_cast<GateOp>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const std::string &GateTape::name(const GateOp op) {
+  return opInfos[static_cast<int>(op)].name;
+}
+
+const int GateTape::nBits(const GateOp op) {
+  return opInfos[static_cast<int>(op)].nBits;
+}
+
+const int GateTape::nParams(const GateOp op) {
+  return opInfos[static_cast<int>(op)].nParams;
+}
+
+void GateTape::append(GateOp op, std::initializer_list<int> bits,
+                      std::initializer_list<double> params) {
+  if (bits.size() != nBits(op) || params.size() != nParams(op)) {
+    xacc::error("Invalid GateTape entry for " + name(op) + ".");
+  }
+
+  GateTapeEntry entry{op, static_cast<std::uint8_t>(bits.size()),
+                      static_cast<std::uint8_t>(params.size())};
+  std::copy(bits.begin(), bits.end(), entry.bits);
+  std::copy(params.begin(), params.end(), entry.params);
+  for (auto b : bits) {
+    maxBit = std::max(maxBit, b);
+  }
+  entries.push_back(entry);
+}
+
+void GateTape::append(std::shared_ptr<Function> function) {
+  for (auto &inst : function->getInstructions()) {
+    if (!inst->isEnabled()) {
+      continue;
+    }
+
+    if (inst->isComposite()) {
+      if (std::dynamic_pointer_cast<ConditionalFunction>(inst)) {
+        xacc::error("GateTape cannot lower conditional function " +
+                    inst->name() + ".");
+      }
+      append(std::dynamic_pointer_cast<Function>(inst));
+      continue;
+    }
+
+    GateOp op;
+    if (!opcode(inst->name(), op)) {
+      xacc::error("GateTape has no opcode for gate " + inst->name() + ".");
+    }
+
+    auto bits = inst->bits();
+    if (bits.size() != nBits(op) || inst->nParameters() != nParams(op)) {
+      xacc::error("Invalid " + inst->name() + " instruction for GateTape.");
+    }
+
+    GateTapeEntry entry{op, static_cast<std::uint8_t>(bits.size()),
+                        static_cast<std::uint8_t>(nParams(op))};
+    for (int i = 0; i < bits.size(); i++) {
+      entry.bits[i] = bits[i];
+      maxBit = std::max(maxBit, bits[i]);
+    }
+    for (int i = 0; i < entry.nParams; i++) {
+      auto p = inst->getParameter(i);
+      if (p.isVariable()) {
+        xacc::error("GateTape cannot lower variable parameter " +
+                    p.toString() + ", evaluate the function first.");
+      }
+      entry.params[i] = p.which() == 0 ? p.as<int>() : p.as<double>();
+    }
+    entries.push_back(entry);
+  }
+}
+
+std::shared_ptr<GateFunction> GateTape::toFunction(const std::string &name) {
+  auto provider = xacc::getService<IRProvider>("gate");
+  auto function = std::make_shared<GateFunction>(name);
+  for (auto &entry : entries) {
+    std::vector<int> bits(entry.bits, entry.bits + entry.nBits);
+    std::vector<InstructionParameter> params;
+    for (int i = 0; i < entry.nParams; i++) {
+      if (entry.op == GateOp::Measure) {
+        params.push_back(InstructionParameter((int)entry.params[i]));
+      } else {
+        params.push_back(InstructionParameter(entry.params[i]));
+      }
+    }
+    function->addInstruction(
+        provider->createInstruction(GateTape::name(entry.op), bits, params));
+  }
+  return function;
+}
+
+} // namespace quantum
+} // namespace xacc
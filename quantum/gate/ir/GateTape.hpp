@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_IR_GATETAPE_HPP_
+#define QUANTUM_GATE_IR_GATETAPE_HPP_
+
+#include <cstdint>
+#include <initializer_list>
+#include "GateFunction.hpp"
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The opcodes of the gates a GateTape can hold,
+ * one per concrete digital gate.
+ */
+enum class GateOp : std::uint8_t {
+  I,
+  H,
+  X,
+  Y,
+  Z,
+  S,
+  Sdg,
+  T,
+  Tdg,
+  Rx,
+  Ry,
+  Rz,
+  U,
+  Measure,
+  CNOT,
+  CY,
+  CZ,
+  CH,
+  Swap,
+  CPhase,
+  CRZ
+};
+
+/**
+ * A single gate on a GateTape, with its qubits and
+ * numeric parameters stored inline. Measure stores its
+ * classical bit index as its one parameter.
+ */
+struct GateTapeEntry {
+  GateOp op;
+  std::uint8_t nBits;
+  std::uint8_t nParams;
+  std::int32_t bits[2];
+  double params[3];
+};
+
+/**
+ * The GateTape is a flat, contiguous lowering of a GateFunction
+ * for hot execution paths. Each gate becomes a small fixed-size
+ * GateTapeEntry, so backends can walk a circuit as a plain array
+ * without visitor dispatch, string compares or pointer chasing.
+ *
+ * Lowering inlines nested GateFunctions and skips disabled
+ * Instructions. All gate parameters must be concrete, evaluate
+ * parameterized GateFunctions before lowering them.
+ */
+class GateTape {
+
+public:
+  GateTape() {}
+
+  /**
+   * Lower the given Function into a new GateTape.
+   *
+   * @param function The Function to lower
+   */
+  GateTape(std::shared_ptr<Function> function) { append(function); }
+
+  /**
+   * Append the enabled gates of the given Function to this tape.
+   *
+   * @param function The Function to lower
+   */
+  void append(std::shared_ptr<Function> function);
+
+  /**
+   * Append a single gate to this tape.
+   *
+   * @param op The gate opcode
+   * @param bits The gate qubits
+   * @param params The gate parameters
+   */
+  void append(GateOp op, std::initializer_list<int> bits,
+              std::initializer_list<double> params = {});
+
+  /**
+   * Raise this tape back into a GateFunction.
+   *
+   * @param name The name of the new GateFunction
+   * @return function The GateFunction for this tape
+   */
+  std::shared_ptr<GateFunction> toFunction(const std::string &name);
+
+  const std::size_t size() const { return entries.size(); }
+  const bool empty() const { return entries.empty(); }
+  const GateTapeEntry &operator[](const std::size_t idx) const {
+    return entries[idx];
+  }
+  std::vector<GateTapeEntry>::const_iterator begin() const {
+    return entries.begin();
+  }
+  std::vector<GateTapeEntry>::const_iterator end() const {
+    return entries.end();
+  }
+  const GateTapeEntry *data() const { return entries.data(); }
+
+  /**
+   * Return the number of qubits this tape acts on,
+   * one more than the largest qubit index.
+   *
+   * @return nQubits The number of qubits
+   */
+  const int nQubits() const { return maxBit + 1; }
+
+  /**
+   * Map a gate name to its opcode.
+   *
+   * @param name The gate name, as returned by Instruction::name()
+   * @param op The opcode for this gate name
+   * @return found False if the name has no opcode
+   */
+  static bool opcode(const std::string &name, GateOp &op);
+
+  /**
+   * Return the gate name for the given opcode.
+   */
+  static const std::string &name(const GateOp op);
+
+  /**
+   * Return the number of qubits the given opcode acts on.
+   */
+  static const int nBits(const GateOp op);
+
+  /**
+   * Return the number of parameters the given opcode takes.
+   */
+  static const int nParams(const GateOp op);
+
+protected:
+  std::vector<GateTapeEntry> entries;
+
+  int maxBit = -1;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "ParameterRegistry.hpp"
+#include <cstdlib>
+#include <cctype>
+
+namespace xacc {
+namespace quantum {
+
+namespace {
+bool isSeparator(const char c) {
+  return std::isspace(c) || c == '-' || c == '+' || c == '*' || c == '/';
+}
+
+// A token is a number if it starts with one, like std::stod
+bool isNumber(const std::string &token) {
+  char *end = nullptr;
+  std::strtod(token.c_str(), &end);
+  return end != token.c_str();
+}
+} // namespace
+
+const std::string &ParameterRegistry::variable(const std::string &expression) {
+  auto it = expressions.find(expression);
+  if (it != expressions.end()) {
+    return it->second;
+  }
+
+  std::string var, token;
+  for (int i = 0; i <= expression.size(); i++) {
+    if (i == expression.size() || isSeparator(expression[i])) {
+      if (!token.empty() && !isNumber(token)) {
+        var = token;
+      }
+      token.clear();
+    } else {
+      token += expression[i];
+    }
+  }
+
+  if (!var.empty()) {
+    interned[var].push_back(expression);
+  }
+  return expressions.emplace(expression, var).first->second;
+}
+
+bool ParameterRegistry::declare(const std::string &var) {
+  return references.emplace(var, 0).second;
+}
+
+bool ParameterRegistry::retain(const std::string &var) {
+  auto added = declare(var);
+  references[var]++;
+  return added;
+}
+
+bool ParameterRegistry::release(const std::string &var) {
+  auto it = references.find(var);
+  if (it == references.end()) {
+    return false;
+  }
+
+  if (--it->second <= 0) {
+    references.erase(it);
+    forget(var);
+    return true;
+  }
+  return false;
+}
+
+void ParameterRegistry::rename(const std::string &oldVar,
+                               const std::string &newVar) {
+  auto n = count(oldVar);
+  references.erase(oldVar);
+  forget(oldVar);
+  references[newVar] += n;
+}
+
+void ParameterRegistry::clear() {
+  references.clear();
+  expressions.clear();
+  interned.clear();
+}
+
+void ParameterRegistry::forget(const std::string &var) {
+  auto it = interned.find(var);
+  if (it == interned.end()) {
+    return;
+  }
+  for (auto &expression : it->second) {
+    expressions.erase(expression);
+  }
+  interned.erase(it);
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_IR_PARAMETERREGISTRY_HPP_
+#define QUANTUM_GATE_IR_PARAMETERREGISTRY_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * The ParameterRegistry keeps track of the variables referenced by
+ * the Instructions of a GateFunction. Parameter expressions like
+ * "0.5 * theta" are parsed once and interned, and each variable
+ * carries a count of the Instructions that reference it, so that
+ * adding and removing Instructions never has to rescan the function.
+ */
+class ParameterRegistry {
+
+public:
+  /**
+   * Return the variable referenced by the given parameter expression,
+   * the last token that is not a number once the arithmetic operators
+   * are stripped. Returns an empty string if there is none.
+   * The result is valid until the variable is released or renamed.
+   *
+   * @param expression The parameter expression
+   * @return variable The variable name
+   */
+  const std::string &variable(const std::string &expression);
+
+  /**
+   * Declare a variable without adding a reference to it.
+   *
+   * @param var The variable name
+   * @return added False if the variable was already known
+   */
+  bool declare(const std::string &var);
+
+  /**
+   * Add a reference to the given variable.
+   *
+   * @param var The variable name
+   * @return added True if the variable was not known before
+   */
+  bool retain(const std::string &var);
+
+  /**
+   * Remove a reference to the given variable, forgetting
+   * it once no references remain.
+   *
+   * @param var The variable name
+   * @return removed True if the variable is no longer known
+   */
+  bool release(const std::string &var);
+
+  /**
+   * Rename a known variable, keeping its references.
+   *
+   * @param oldVar The current variable name
+   * @param newVar The new variable name
+   */
+  void rename(const std::string &oldVar, const std::string &newVar);
+
+  /**
+   * Return true if the given variable is known.
+   */
+  bool contains(const std::string &var) const {
+    return references.count(var);
+  }
+
+  /**
+   * Return the number of references to the given variable.
+   */
+  int count(const std::string &var) const {
+    auto it = references.find(var);
+    return it == references.end() ? 0 : it->second;
+  }
+
+  void clear();
+
+protected:
+  /**
+   * The interned expressions, each mapped to its variable.
+   */
+  std::unordered_map<std::string, std::string> expressions;
+
+  /**
+   * The interned expressions of each variable, dropped along with
+   * its last reference so that the intern table does not outgrow
+   * the variables in use.
+   */
+  std::unordered_map<std::string, std::vector<std::string>> interned;
+
+  void forget(const std::string &var);
+
+  std::unordered_map<std::string, int> references;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -23,13 +23,20 @@ class ConditionalFunction : public GateFunction {
 protected:
   int qbitIdx;
 
+  void hashHeader(StructuralHash &h) override {
+    h.add(std::string("conditional")).add(qbitIdx);
+  }
+
 public:
   ConditionalFunction(int qbit)
       : GateFunction("conditional_" + std::to_string(qbit)), qbitIdx(qbit) {}
 
   void addInstruction(InstPtr instruction) override {
+    modified();
     instruction->disable();
+    instruction->attach(this);
     instructions.push_back(instruction);
+    layersDirty = true;
   }
 
   const int getConditionalQubit() { return qbitIdx; }
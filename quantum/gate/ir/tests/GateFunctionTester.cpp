@@ -12,8 +12,12 @@
  *******************************************************************************/
 #include "DigitalGates.hpp"
 #include "GateFunction.hpp"
+#include "BoundGateFunction.hpp"
 #include "InstructionIterator.hpp"
+#include "ParameterRegistry.hpp"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
 #include "Graph.hpp"
 
 using namespace xacc::quantum;
@@ -117,6 +121,190 @@ TEST(GateFunctionTester, checkEvaluateVariables) {
   std::cout << "ParamSet:\n" << evaled->toString("qreg") << "\n";
 }
 
+TEST(GateFunctionTester, checkBoundEvaluation) {
+
+  xacc::InstructionParameter theta("theta"), twoTheta("2 * theta"),
+      phi("phi");
+
+  auto rz = std::make_shared<Rz>(std::vector<int>{0});
+  rz->setParameter(0, theta);
+  auto ry = std::make_shared<Ry>(std::vector<int>{1});
+  ry->setParameter(0, twoTheta);
+  auto cn = std::make_shared<CNOT>(0, 1);
+
+  auto inner = std::make_shared<GateFunction>(
+      "inner", std::vector<xacc::InstructionParameter>{theta, phi});
+  auto rx = std::make_shared<Rx>(std::vector<int>{1});
+  rx->setParameter(0, phi);
+  inner->addInstruction(rx);
+
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<xacc::InstructionParameter>{theta, phi});
+  f->addInstruction(rz);
+  f->addInstruction(cn);
+  f->addInstruction(ry);
+  f->addInstruction(inner);
+  EXPECT_EQ(2, f->nParameters());
+
+  auto plan = f->bind();
+  EXPECT_EQ(2, plan->nParameters());
+
+  auto evaled = (*plan)({.5, 1.5});
+  EXPECT_EQ(4, evaled->nInstructions());
+  EXPECT_NEAR(.5, evaled->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+  EXPECT_TRUE(evaled->getInstruction(1) == cn);
+  EXPECT_NEAR(1., evaled->getInstruction(2)->getParameter(0).as<double>(),
+              1e-12);
+  auto evaledInner =
+      std::dynamic_pointer_cast<GateFunction>(evaled->getInstruction(3));
+  EXPECT_NEAR(1.5,
+              evaledInner->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+
+  // The plan updates the same function in place, copies are independent
+  auto snapshot = plan->copy();
+  auto again = (*plan)({.25, 3.});
+  EXPECT_TRUE(again == evaled);
+  EXPECT_NEAR(.5, again->getInstruction(2)->getParameter(0).as<double>(),
+              1e-12);
+  EXPECT_NEAR(1., snapshot->getInstruction(2)->getParameter(0).as<double>(),
+              1e-12);
+
+  // operator() agrees with the plan and returns a new function each call
+  auto f1 = (*f)({.25, 3.});
+  auto f2 = (*f)({.25, 3.});
+  EXPECT_FALSE(f1 == f2);
+  EXPECT_EQ(again->toString("q"), f1->toString("q"));
+
+  // Editing the function invalidates the cached plan
+  auto rz2 = std::make_shared<Rz>(std::vector<int>{1});
+  rz2->setParameter(0, phi);
+  f->addInstruction(rz2);
+  auto f3 = (*f)({.25, 3.});
+  EXPECT_EQ(5, f3->nInstructions());
+  EXPECT_NEAR(3., f3->getInstruction(4)->getParameter(0).as<double>(), 1e-12);
+}
+
+TEST(GateFunctionTester, checkEvaluationAfterEdits) {
+
+  xacc::InstructionParameter theta("theta"), twoTheta("2 * theta"),
+      phi("phi");
+
+  auto rz = std::make_shared<Rz>(std::vector<int>{0});
+  rz->setParameter(0, theta);
+  auto inner = std::make_shared<GateFunction>(
+      "inner", std::vector<xacc::InstructionParameter>{theta, phi});
+  auto rx = std::make_shared<Rx>(std::vector<int>{1});
+  rx->setParameter(0, phi);
+  inner->addInstruction(rx);
+
+  auto f = std::make_shared<GateFunction>(
+      "foo", std::vector<xacc::InstructionParameter>{theta, phi});
+  f->addInstruction(rz);
+  f->addInstruction(inner);
+
+  auto first = (*f)({.5, 1.5});
+  EXPECT_NEAR(.5, first->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+
+  // In-place edits to a held gate reach the cached plan
+  rz->setParameter(0, twoTheta);
+  rz->setBits({2});
+  auto edited = (*f)({.5, 1.5});
+  EXPECT_NEAR(1., edited->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+  EXPECT_EQ(std::vector<int>{2}, edited->getInstruction(0)->bits());
+
+  // So do edits to a nested GateFunction
+  auto ry = std::make_shared<Ry>(std::vector<int>{0});
+  ry->setParameter(0, theta);
+  inner->addInstruction(ry);
+  auto evaledInner = std::dynamic_pointer_cast<GateFunction>(
+      (*f)({.25, 3.})->getInstruction(1));
+  EXPECT_EQ(2, evaledInner->nInstructions());
+  EXPECT_NEAR(.25, evaledInner->getInstruction(1)->getParameter(0).as<double>(),
+              1e-12);
+
+  auto rxNew = std::make_shared<Rx>(std::vector<int>{3});
+  rxNew->setParameter(0, phi);
+  inner->replaceInstruction(0, rxNew);
+  rxNew->setParameter(0, twoTheta);
+  evaledInner = std::dynamic_pointer_cast<GateFunction>(
+      f->evaluateBatch({{.25, 3.}})[0]->getInstruction(1));
+  EXPECT_EQ(std::vector<int>{3}, evaledInner->getInstruction(0)->bits());
+  EXPECT_NEAR(.5, evaledInner->getInstruction(0)->getParameter(0).as<double>(),
+              1e-12);
+
+  // Gates removed from the nested GateFunction no longer reach it
+  inner->removeInstruction(0);
+  auto h = f->hash();
+  rxNew->setBits({4});
+  EXPECT_EQ(h, f->hash());
+}
+
+// A Hadamard that reports the composite holding it
+class HeldHadamard : public Hadamard {
+public:
+  using Hadamard::Hadamard;
+  xacc::Instruction *holder() { return parent; }
+};
+
+TEST(GateFunctionTester, checkBatchEvaluation) {
+
+  xacc::InstructionParameter theta("theta"), halfPhi("0.5 * phi");
+
+  auto h = std::make_shared<HeldHadamard>(0);
+  auto rz = std::make_shared<Rz>(std::vector<int>{0});
+  rz->setParameter(0, theta);
+  auto cn = std::make_shared<CNOT>(0, 1);
+  auto ry = std::make_shared<Ry>(std::vector<int>{1});
+  ry->setParameter(0, halfPhi);
+
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(h);
+  f->addInstruction(rz);
+  f->addInstruction(cn);
+  f->addInstruction(ry);
+  EXPECT_EQ(2, f->nParameters());
+
+  std::vector<std::vector<double>> sweep{{0., 1.}, {.5, 2.}, {1., 3.}};
+  auto evaled = f->evaluateBatch(sweep);
+  EXPECT_EQ(3, evaled.size());
+
+  for (int i = 0; i < sweep.size(); i++) {
+    EXPECT_EQ(4, evaled[i]->nInstructions());
+    EXPECT_NEAR(sweep[i][0],
+                evaled[i]->getInstruction(1)->getParameter(0).as<double>(),
+                1e-12);
+    EXPECT_NEAR(.5 * sweep[i][1],
+                evaled[i]->getInstruction(3)->getParameter(0).as<double>(),
+                1e-12);
+    EXPECT_EQ(f->operator()(sweep[i])->toString("q"),
+              evaled[i]->toString("q"));
+
+    // Non-parameterized gates are shared, parameterized gates are not
+    EXPECT_TRUE(evaled[i]->getInstruction(0) == h);
+    EXPECT_TRUE(evaled[i]->getInstruction(2) == cn);
+    if (i > 0) {
+      EXPECT_FALSE(evaled[i]->getInstruction(1) ==
+                   evaled[i - 1]->getInstruction(1));
+    }
+  }
+
+  // Shared gates stay held by the source alone
+  EXPECT_TRUE(h->holder() == f.get());
+
+  // Edits to them still show in the evaluated copies
+  auto copy = std::dynamic_pointer_cast<GateFunction>(evaled[0]);
+  auto before = copy->hash();
+  EXPECT_EQ(4, copy->depth());
+  cn->disable();
+  EXPECT_NE(before, copy->hash());
+  EXPECT_EQ(2, copy->depth());
+  EXPECT_EQ(f->operator()(sweep[0])->toString("q"), copy->toString("q"));
+}
+
 TEST(GateFunctionTester, checkParameterInsertion) {
 
   xacc::InstructionParameter p1("theta");
@@ -217,6 +405,77 @@ TEST(GateFunctionTester, checkParameterInsertion) {
 }
 
 
+TEST(GateFunctionTester, checkManyVariables) {
+  // Two gates per variable, with and without a coefficient
+  const int nVars = 10000;
+  GateFunction f("foo");
+  for (int i = 0; i < nVars; i++) {
+    auto rz = std::make_shared<Rz>(std::vector<int>{i % 8});
+    auto ry = std::make_shared<Ry>(std::vector<int>{i % 8});
+    xacc::InstructionParameter p("t" + std::to_string(i));
+    xacc::InstructionParameter q("-0.5 * t" + std::to_string(i));
+    rz->setParameter(0, p);
+    ry->setParameter(0, q);
+    f.addInstruction(rz);
+    f.addInstruction(ry);
+  }
+
+  EXPECT_EQ(2 * nVars, f.nInstructions());
+  EXPECT_EQ(nVars, f.nParameters());
+  EXPECT_EQ("t0", f.getParameter(0).as<std::string>());
+  EXPECT_EQ("t9999", f.getParameter(nVars - 1).as<std::string>());
+
+  // Replacing a shared variable keeps it, replacing
+  // its last reference with a new variable renames it
+  auto rx = std::make_shared<Rx>(std::vector<int>{0});
+  xacc::InstructionParameter r("2 * phi");
+  rx->setParameter(0, r);
+  f.replaceInstruction(1, rx);
+  EXPECT_EQ(nVars + 1, f.nParameters());
+  f.replaceInstruction(0, std::make_shared<X>(0));
+  EXPECT_EQ(nVars, f.nParameters());
+  EXPECT_EQ("t1", f.getParameter(0).as<std::string>());
+  EXPECT_EQ("phi", f.getParameter(nVars - 1).as<std::string>());
+
+  // Removing from the back drops each variable with its last reference
+  while (f.nInstructions() > 2) {
+    f.removeInstruction(f.nInstructions() - 1);
+  }
+  EXPECT_EQ(1, f.nParameters());
+  EXPECT_EQ("phi", f.getParameter(0).as<std::string>());
+}
+
+class InternCount : public ParameterRegistry {
+public:
+  const int nInterned() { return expressions.size(); }
+};
+
+TEST(GateFunctionTester, checkRegistryForgetsReleased) {
+  InternCount registry;
+  for (int i = 0; i < 100; i++) {
+    auto t = "t" + std::to_string(i);
+    EXPECT_EQ(t, registry.variable(t));
+    EXPECT_EQ(t, registry.variable("2 * " + t));
+    registry.retain(t);
+    registry.retain(t);
+  }
+  EXPECT_EQ(200, registry.nInterned());
+
+  // Expressions go with the last reference to their variable
+  for (int i = 0; i < 100; i++) {
+    auto t = "t" + std::to_string(i);
+    registry.release(t);
+    EXPECT_EQ(200 - 2 * i, registry.nInterned());
+    registry.release(t);
+    EXPECT_EQ(198 - 2 * i, registry.nInterned());
+  }
+
+  registry.variable("2 * phi");
+  registry.retain("phi");
+  registry.rename("phi", "psi");
+  EXPECT_EQ(0, registry.nInterned());
+}
+
 TEST(GateFunctionTester, checkPersistLoad) {
 
   auto f = std::make_shared<GateFunction>("foo");
@@ -307,6 +566,357 @@ TEST(GateFunctionTester, checkDepth) {
   auto g = f->toGraph();
 
   EXPECT_EQ(3, g->depth());
+  EXPECT_EQ(3, f->depth());
+}
+
+TEST(GateFunctionTester, checkLayers) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto h = std::make_shared<Hadamard>(1);
+  auto cn1 = std::make_shared<CNOT>(1, 2);
+  auto rz = std::make_shared<Rz>(1, 3.1415);
+  auto z = std::make_shared<Z>(2);
+  auto x = std::make_shared<X>(0);
+
+  f->addInstruction(h);
+  f->addInstruction(cn1);
+  f->addInstruction(rz);
+  f->addInstruction(z);
+  f->addInstruction(x);
+
+  EXPECT_EQ(3, f->depth());
+  EXPECT_EQ(2, f->getLayer(0).size());
+  EXPECT_TRUE(f->getLayer(0)[0] == h);
+  EXPECT_TRUE(f->getLayer(0)[1] == x);
+  EXPECT_EQ(std::vector<xacc::InstPtr>({rz, z}), f->getLayer(2));
+  EXPECT_TRUE(f->getLayer(3).empty());
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, cn1, rz}), f->criticalPath());
+
+  // Nested functions are scheduled gate by gate
+  auto inner = std::make_shared<GateFunction>("inner");
+  auto cn2 = std::make_shared<CNOT>(0, 1);
+  inner->addInstruction(cn2);
+  f->addInstruction(inner);
+  EXPECT_EQ(4, f->depth());
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, cn1, rz, cn2}), f->criticalPath());
+
+  // Edits in the middle are picked up
+  f->removeInstruction(1);
+  EXPECT_EQ(3, f->depth());
+  f->insertInstruction(0, std::make_shared<CNOT>(0, 2));
+  EXPECT_EQ(3, f->depth());
+  EXPECT_EQ(3, f->getLayer(1).size());
+
+  // Disabled gates do not count
+  f->getInstruction(4)->disable();
+  f->removeInstruction(5);
+  EXPECT_EQ(2, f->depth());
+}
+
+TEST(GateFunctionTester, checkDepthMatchesGraph) {
+  std::srand(12345);
+  for (int trial = 0; trial < 20; trial++) {
+    auto f = std::make_shared<GateFunction>("foo");
+    for (int i = 0; i < 40; i++) {
+      int q1 = std::rand() % 5, q2 = (q1 + 1 + std::rand() % 4) % 5;
+      if (std::rand() % 2) {
+        f->addInstruction(std::make_shared<CNOT>(q1, q2));
+      } else {
+        f->addInstruction(std::make_shared<Hadamard>(q1));
+      }
+      if (i % 10 == 0) {
+        f->removeInstruction(std::rand() % f->nInstructions());
+      }
+    }
+    EXPECT_EQ(f->toGraph()->depth(), f->depth());
+  }
+}
+
+double timeIt(std::function<void()> f) {
+  auto start = std::chrono::high_resolution_clock::now();
+  f();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Build, traverse and edit a circuit of n gates, checking the results
+// along the way. Returns the time taken by each of the three steps.
+std::vector<double> buildTraverseEdit(const int n) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto build = timeIt([&]() {
+    for (int i = 0; i < n; i++) {
+      if (i % 2) {
+        f->addInstruction(std::make_shared<CNOT>(i % 4, (i + 1) % 4));
+      } else {
+        f->addInstruction(std::make_shared<Hadamard>(i % 4));
+      }
+    }
+  });
+
+  int count = 0;
+  auto traverse = timeIt([&]() {
+    for (int i = 0; i < f->nInstructions(); i++) {
+      count += f->getInstruction(i)->bits().size();
+    }
+    xacc::InstructionIterator it(f);
+    while (it.hasNext()) {
+      it.next();
+    }
+  });
+  EXPECT_EQ(3 * n / 2, count);
+
+  auto edit = timeIt([&]() {
+    for (int i = 0; i < f->nInstructions(); i++) {
+      f->replaceInstruction(i, std::make_shared<X>(i % 4));
+    }
+    EXPECT_EQ("X", f->getInstruction(n - 1)->name());
+    while (f->nInstructions() > 0) {
+      f->removeInstruction(f->nInstructions() - 1);
+    }
+  });
+  EXPECT_EQ(0, f->nInstructions());
+  return {build, traverse, edit};
+}
+
+TEST(GateFunctionTester, checkBuildTraverseEdit) { buildTraverseEdit(1000); }
+
+TEST(GateFunctionTester, DISABLED_benchmarkLinearScaling) {
+  // The cost per gate should stay flat with contiguous storage
+  std::vector<int> sizes{1000, 10000, 100000};
+  std::vector<double> totals;
+  for (auto n : sizes) {
+    auto times = buildTraverseEdit(n);
+    std::cout << n << " gates: build " << times[0] << " s, traverse "
+              << times[1] << " s, edit " << times[2] << " s\n";
+    totals.push_back(times[0] + times[1] + times[2]);
+  }
+
+  // 10x more gates should cost roughly 10x more time, far
+  // from the 100x of index-based access on a linked list.
+  EXPECT_LT(totals[2], 40 * totals[1]);
+}
+
+// Build n Rz gates with 1000 distinct angles and count those matching
+// one of them. Returns the build and compare times.
+std::vector<double> buildAndCompare(const int n) {
+  std::shared_ptr<GateFunction> f;
+  auto build = timeIt([&]() {
+    f = std::make_shared<GateFunction>("foo");
+    for (int i = 0; i < n; i++) {
+      f->addInstruction(std::make_shared<Rz>(i % 16, .001 * (i % 1000)));
+    }
+  });
+
+  int nMatches = 0;
+  xacc::InstructionParameter target(.001 * 500);
+  auto compare = timeIt([&]() {
+    for (auto &inst : f->getInstructions()) {
+      if (inst->getParameter(0) == target) {
+        nMatches++;
+      }
+    }
+  });
+  EXPECT_EQ(n / 1000, nMatches);
+  return {build, compare};
+}
+
+TEST(GateFunctionTester, checkParameterCompare) { buildAndCompare(10000); }
+
+TEST(GateFunctionTester, DISABLED_benchmarkMillionGateCircuit) {
+  // Resident memory in bytes, where available
+  auto residentBytes = []() -> double {
+    std::ifstream statm("/proc/self/statm");
+    double pages = 0, resident = 0;
+    if (statm >> pages >> resident) {
+      return resident * 4096;
+    }
+    return 0;
+  };
+
+  const int n = 1000000;
+  auto startMem = residentBytes();
+  auto times = buildAndCompare(n);
+
+  std::cout << "sizeof(InstructionParameter) = "
+            << sizeof(xacc::InstructionParameter) << " bytes\n";
+  std::cout << n << " gate build: " << times[0] << " s, "
+            << (residentBytes() - startMem) / n << " bytes/gate\n";
+  std::cout << n << " parameter compares: " << times[1] << " s\n";
+}
+
+TEST(GateFunctionTester, checkInstructionRange) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto h = std::make_shared<Hadamard>(0);
+  auto x = std::make_shared<X>(1);
+  auto inner = std::make_shared<GateFunction>("inner");
+  auto cn = std::make_shared<CNOT>(0, 1);
+  auto z = std::make_shared<Z>(1);
+  auto off = std::make_shared<GateFunction>("off");
+  auto y = std::make_shared<Y>(0);
+  inner->addInstruction(cn);
+  inner->addInstruction(z);
+  off->addInstruction(y);
+  f->addInstruction(h);
+  f->addInstruction(inner);
+  f->addInstruction(x);
+  f->addInstruction(off);
+  z->disable();
+  y->disable();
+
+  auto collect = [&](xacc::Traversal filter) {
+    std::vector<xacc::InstPtr> visited;
+    for (auto &inst : xacc::InstructionRange(f, filter)) {
+      visited.push_back(inst);
+    }
+    return visited;
+  };
+
+  // Same order as InstructionIterator, without the root
+  std::vector<xacc::InstPtr> expected;
+  xacc::InstructionIterator it(f);
+  it.next();
+  while (it.hasNext()) {
+    expected.push_back(it.next());
+  }
+  EXPECT_EQ(expected, collect(xacc::Traversal::All));
+
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, cn, z, x, y}),
+            collect(xacc::Traversal::Leaves));
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, inner, cn, x, off}),
+            collect(xacc::Traversal::Enabled));
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, cn, x}),
+            collect(xacc::Traversal::EnabledLeaves));
+
+  // Deeply nested Functions spill past the inline frames
+  auto deep = std::make_shared<GateFunction>("deep");
+  auto last = deep;
+  for (int i = 0; i < 40; i++) {
+    auto next = std::make_shared<GateFunction>("deep" + std::to_string(i));
+    last->addInstruction(std::make_shared<Hadamard>(i));
+    last->addInstruction(next);
+    last = next;
+  }
+  int count = 0;
+  for (auto &inst : xacc::InstructionRange(deep, xacc::Traversal::EnabledLeaves)) {
+    EXPECT_EQ(std::vector<int>{count}, inst->bits());
+    count++;
+  }
+  EXPECT_EQ(40, count);
+
+  auto empty = std::make_shared<GateFunction>("empty");
+  xacc::InstructionRange range(empty);
+  EXPECT_TRUE(range.begin() == range.end());
+}
+
+// Walk a flat and a nested circuit of n gates, a third of them
+// disabled, with InstructionIterator and InstructionRange, checking
+// they agree. Returns the time of each walk, iterator first.
+std::vector<double> compareTraversals(const int n) {
+  auto flat = std::make_shared<GateFunction>("flat");
+  auto nested = std::make_shared<GateFunction>("nested");
+  std::shared_ptr<GateFunction> block;
+  for (int i = 0; i < n; i++) {
+    auto gate = std::make_shared<Hadamard>(i % 8);
+    if (i % 3 == 0) {
+      gate->disable();
+    }
+    flat->addInstruction(gate);
+    if (i % 100 == 0) {
+      block = std::make_shared<GateFunction>("block" + std::to_string(i));
+      nested->addInstruction(block);
+    }
+    block->addInstruction(gate);
+  }
+
+  std::vector<double> times;
+  for (auto &f : {flat, nested}) {
+    int oldCount = 0, newCount = 0;
+    times.push_back(timeIt([&]() {
+      xacc::InstructionIterator it(f);
+      while (it.hasNext()) {
+        auto inst = it.next();
+        if (!inst->isComposite() && inst->isEnabled()) {
+          oldCount++;
+        }
+      }
+    }));
+    times.push_back(timeIt([&]() {
+      for (auto &inst :
+           xacc::InstructionRange(f, xacc::Traversal::EnabledLeaves)) {
+        newCount++;
+      }
+    }));
+    EXPECT_EQ(oldCount, newCount);
+    EXPECT_EQ(2 * n / 3, newCount);
+  }
+  return times;
+}
+
+TEST(GateFunctionTester, checkTraversalAgreement) { compareTraversals(3000); }
+
+TEST(GateFunctionTester, DISABLED_benchmarkTraversalThroughput) {
+  // Compare the per-gate cost of InstructionIterator
+  // and InstructionRange on a flat and a nested circuit.
+  const int n = 1000000;
+  auto times = compareTraversals(n);
+  std::vector<std::string> names{"flat", "nested"};
+  for (int i = 0; i < 2; i++) {
+    auto oldTime = times[2 * i], newTime = times[2 * i + 1];
+    std::cout << names[i] << ": InstructionIterator " << 1e9 * oldTime / n
+              << " ns/gate, InstructionRange " << 1e9 * newTime / n
+              << " ns/gate\n";
+    EXPECT_LT(newTime, oldTime);
+  }
+}
+
+TEST(GateFunctionTester, checkRemoveDisabled) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto h = std::make_shared<Hadamard>(0);
+  auto rz = std::make_shared<Rz>(0, 0.0);
+  xacc::InstructionParameter theta("theta");
+  rz->setParameter(0, theta);
+  auto cn = std::make_shared<CNOT>(0, 1);
+  auto x = std::make_shared<X>(1);
+  f->addInstruction(h);
+  f->addInstruction(rz);
+  f->addInstruction(cn);
+  f->addInstruction(x);
+  EXPECT_EQ(1, f->nParameters());
+
+  // The view sees later changes without being recreated
+  auto view = f->enabledInstructions();
+  rz->disable();
+  cn->disable();
+  std::vector<xacc::InstPtr> enabled;
+  for (auto &inst : view) {
+    enabled.push_back(inst);
+  }
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, x}), enabled);
+  EXPECT_EQ(4, f->nInstructions());
+
+  f->removeDisabled();
+  EXPECT_EQ(std::vector<xacc::InstPtr>({h, x}), f->getInstructions());
+  EXPECT_EQ(0, f->nParameters());
+  EXPECT_EQ(1, f->depth());
+}
+
+TEST(GateFunctionTester, DISABLED_benchmarkRemoveDisabled) {
+  // One sweep, compared to building a copy with enabledView()
+  const int n = 100000;
+  auto big = std::make_shared<GateFunction>("big");
+  for (int i = 0; i < n; i++) {
+    auto gate = std::make_shared<Hadamard>(i % 4);
+    if (i % 2) {
+      gate->disable();
+    }
+    big->addInstruction(gate);
+  }
+  std::shared_ptr<xacc::Function> copy;
+  auto viewTime = timeIt([&]() { copy = big->enabledView(); });
+  auto compactTime = timeIt([&]() { big->removeDisabled(); });
+  EXPECT_EQ(n / 2, big->nInstructions());
+  EXPECT_EQ(copy->getInstructions(), big->getInstructions());
+  std::cout << n << " gates: enabledView " << viewTime << " s, removeDisabled "
+            << compactTime << " s\n";
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ *License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "DigitalGates.hpp"
+#include "GateTape.hpp"
+
+using namespace xacc::quantum;
+
+TEST(GateTapeTester, checkLowering) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto init = std::make_shared<GateFunction>("init");
+  init->addInstruction(std::make_shared<Hadamard>(0));
+  init->addInstruction(std::make_shared<Rz>(1, 3.1415));
+
+  auto disabled = std::make_shared<X>(2);
+  disabled->disable();
+
+  f->addInstruction(init);
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(disabled);
+  f->addInstruction(std::make_shared<U>(2, .1, .2, .3));
+  f->addInstruction(std::make_shared<CPhase>(1, 2, .5));
+  f->addInstruction(std::make_shared<Measure>(2, 1));
+
+  GateTape tape(f);
+  EXPECT_EQ(6, tape.size());
+  EXPECT_EQ(3, tape.nQubits());
+
+  EXPECT_TRUE(tape[0].op == GateOp::H);
+  EXPECT_EQ(0, tape[0].bits[0]);
+  EXPECT_TRUE(tape[1].op == GateOp::Rz);
+  EXPECT_EQ(1, tape[1].nParams);
+  EXPECT_DOUBLE_EQ(3.1415, tape[1].params[0]);
+  EXPECT_TRUE(tape[2].op == GateOp::CNOT);
+  EXPECT_EQ(2, tape[2].nBits);
+  EXPECT_EQ(1, tape[2].bits[1]);
+  EXPECT_TRUE(tape[3].op == GateOp::U);
+  EXPECT_DOUBLE_EQ(.3, tape[3].params[2]);
+  EXPECT_TRUE(tape[4].op == GateOp::CPhase);
+  EXPECT_TRUE(tape[5].op == GateOp::Measure);
+  EXPECT_DOUBLE_EQ(1, tape[5].params[0]);
+
+  EXPECT_LE(sizeof(GateTapeEntry), 40);
+}
+
+TEST(GateTapeTester, checkRoundTrip) {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<Hadamard>(1));
+  f->addInstruction(std::make_shared<CNOT>(1, 2));
+  f->addInstruction(std::make_shared<Rx>(0, 1.5));
+  f->addInstruction(std::make_shared<CZ>(0, 2));
+  f->addInstruction(std::make_shared<Swap>(0, 1));
+  f->addInstruction(std::make_shared<Measure>(0, 0));
+
+  GateTape tape(f);
+  tape.append(GateOp::Ry, {2}, {.25});
+  EXPECT_EQ(7, tape.size());
+
+  auto raised = tape.toFunction("raised");
+  EXPECT_EQ(7, raised->nInstructions());
+  EXPECT_EQ(f->toString("q") + "Ry(0.25) q2\n", raised->toString("q"));
+
+  GateOp op;
+  for (auto &entry : tape) {
+    EXPECT_TRUE(GateTape::opcode(GateTape::name(entry.op), op));
+    EXPECT_TRUE(op == entry.op);
+  }
+  EXPECT_FALSE(GateTape::opcode("NotAGate", op));
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize();
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "GateFunction.hpp"
+#include "ConditionalFunction.hpp"
+#include "DigitalGates.hpp"
+#include <random>
+#include <set>
+
+using namespace xacc;
+using namespace xacc::quantum;
+
+std::shared_ptr<GateFunction> bell(const std::string &name) {
+  auto f = std::make_shared<GateFunction>(name);
+  f->addInstruction(std::make_shared<Hadamard>(0));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<Rz>(1, 0.5));
+  f->addInstruction(std::make_shared<Measure>(1, 0));
+  return f;
+}
+
+TEST(StructuralHashTester, checkStability) {
+  // Hashes are persisted, this value must never change
+  EXPECT_EQ(14323409776842675480ULL, bell("foo")->hash());
+
+  // Function names do not matter
+  EXPECT_EQ(bell("foo")->hash(), bell("bar")->hash());
+
+  // Ints and doubles hash by value, as they compare
+  auto a = std::make_shared<Rz>(0, 0.0), b = std::make_shared<Rz>(0, 0.0);
+  InstructionParameter one(1), oneDouble(1.0), zero(0.0), negZero(-0.0);
+  a->setParameter(0, one);
+  b->setParameter(0, oneDouble);
+  EXPECT_EQ(a->hash(), b->hash());
+  a->setParameter(0, zero);
+  b->setParameter(0, negZero);
+  EXPECT_EQ(a->hash(), b->hash());
+}
+
+TEST(StructuralHashTester, checkSensitivity) {
+  std::vector<std::shared_ptr<GateFunction>> variants;
+  for (int i = 0; i < 9; i++) {
+    variants.push_back(bell("foo"));
+  }
+  InstructionParameter theta("theta"), angle(0.25);
+  variants[1]->getInstruction(0)->setBits({2});
+  variants[2]->getInstruction(2)->setParameter(0, angle);
+  variants[3]->getInstruction(2)->setParameter(0, theta);
+  variants[4]->getInstruction(1)->disable();
+  variants[5]->removeInstruction(3);
+  variants[6]->replaceInstruction(1, std::make_shared<CNOT>(1, 0));
+  variants[7]->addParameter(theta);
+
+  // The same gates, nested one level down
+  auto inner = bell("inner");
+  variants[8] = std::make_shared<GateFunction>("foo");
+  variants[8]->addInstruction(inner);
+
+  std::set<std::uint64_t> hashes;
+  for (auto &f : variants) {
+    hashes.insert(f->hash());
+  }
+  EXPECT_EQ(variants.size(), hashes.size());
+}
+
+TEST(StructuralHashTester, checkIncremental) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto inner = bell("inner");
+  f->addInstruction(std::make_shared<X>(0));
+  auto before = f->hash();
+  f->addInstruction(inner);
+  EXPECT_NE(before, f->hash());
+
+  // Edits to nested Instructions reach the parent
+  auto h = f->hash();
+  inner->getInstruction(0)->disable();
+  EXPECT_NE(h, f->hash());
+  inner->getInstruction(0)->enable();
+  EXPECT_EQ(h, f->hash());
+  InstructionParameter angle(0.75);
+  inner->getInstruction(2)->setParameter(0, angle);
+  EXPECT_NE(h, f->hash());
+
+  // Appending with a hash query after each gate
+  // matches hashing the finished Function
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> qubit(0, 9);
+  auto g = std::make_shared<GateFunction>("g");
+  auto gCopy = std::make_shared<GateFunction>("g");
+  std::vector<int> targets;
+  for (int i = 0; i < 10000; i++) {
+    auto a = qubit(gen);
+    targets.push_back(a);
+    g->addInstruction(std::make_shared<CNOT>(a, (a + 1) % 10));
+    g->hash();
+  }
+  for (auto a : targets) {
+    gCopy->addInstruction(std::make_shared<CNOT>(a, (a + 1) % 10));
+  }
+  EXPECT_EQ(gCopy->hash(), g->hash());
+
+  g->getInstruction(5000)->disable();
+  EXPECT_NE(gCopy->hash(), g->hash());
+  gCopy->getInstruction(5000)->disable();
+  EXPECT_EQ(gCopy->hash(), g->hash());
+}
+
+// Exposes whether the cached hash of the Instructions is valid
+class CachingFunction : public GateFunction {
+public:
+  CachingFunction(const std::string &name) : GateFunction(name) {}
+  bool cached() { return hashValid; }
+};
+
+TEST(StructuralHashTester, checkLocality) {
+  auto f = std::make_shared<CachingFunction>("f");
+  auto g = std::make_shared<CachingFunction>("g");
+  auto inner = bell("inner");
+  f->addInstruction(std::make_shared<X>(0));
+  f->addInstruction(inner);
+  g->addInstruction(std::make_shared<X>(0));
+  auto fHash = f->hash(), gHash = g->hash();
+  EXPECT_TRUE(f->cached());
+  EXPECT_TRUE(g->cached());
+
+  // Edits elsewhere leave the cache alone
+  InstructionParameter angle(0.75);
+  g->getInstruction(0)->setBits({1});
+  bell("other")->getInstruction(2)->setParameter(0, angle);
+  EXPECT_TRUE(f->cached());
+  EXPECT_NE(gHash, g->hash());
+
+  // Nested edits drop it
+  inner->getInstruction(2)->setParameter(0, angle);
+  EXPECT_FALSE(f->cached());
+  EXPECT_NE(fHash, f->hash());
+
+  // Removed Instructions no longer reach their former parent
+  auto x = f->getInstruction(0);
+  f->removeInstruction(0);
+  fHash = f->hash();
+  x->setBits({3});
+  EXPECT_TRUE(f->cached());
+  EXPECT_EQ(fHash, f->hash());
+
+  // Nor do they reach one that has been destroyed
+  auto y = std::make_shared<Y>(0);
+  {
+    auto temp = std::make_shared<GateFunction>("temp");
+    temp->addInstruction(y);
+  }
+  y->setBits({1});
+  EXPECT_EQ(std::vector<int>{1}, y->bits());
+}
+
+TEST(StructuralHashTester, checkConditional) {
+  auto c0 = std::make_shared<ConditionalFunction>(0);
+  auto c1 = std::make_shared<ConditionalFunction>(1);
+  auto plain = std::make_shared<GateFunction>("conditional_0");
+  for (auto f : std::vector<std::shared_ptr<GateFunction>>{c0, c1, plain}) {
+    auto x = std::make_shared<X>(2);
+    f->addInstruction(x);
+    x->disable();
+  }
+  EXPECT_NE(c0->hash(), c1->hash());
+  EXPECT_NE(c0->hash(), plain->hash());
+
+  auto h = c0->hash();
+  c0->evaluate(1);
+  EXPECT_NE(h, c0->hash());
+}
+
+TEST(StructuralHashTester, checkCollisions) {
+  // Every distinct circuit of up to four gates from a small
+  // gate set on three qubits must hash differently
+  std::vector<std::function<InstPtr()>> gates;
+  for (int q = 0; q < 3; q++) {
+    gates.push_back([=]() { return std::make_shared<Hadamard>(q); });
+    gates.push_back([=]() { return std::make_shared<X>(q); });
+    gates.push_back([=]() { return std::make_shared<Rz>(q, 0.5); });
+    gates.push_back([=]() { return std::make_shared<Rz>(q, -0.5); });
+    gates.push_back([=]() { return std::make_shared<CNOT>(q, (q + 1) % 3); });
+  }
+  const int nGates = gates.size();
+
+  std::set<std::uint64_t> hashes;
+  int nCircuits = 0;
+  for (int length = 0; length <= 4; length++) {
+    int count = 1;
+    for (int i = 0; i < length; i++) {
+      count *= nGates;
+    }
+    for (int c = 0; c < count; c++) {
+      auto f = std::make_shared<GateFunction>("foo");
+      for (int i = 0, code = c; i < length; i++, code /= nGates) {
+        f->addInstruction(gates[code % nGates]());
+      }
+      hashes.insert(f->hash());
+      nCircuits++;
+    }
+  }
+  EXPECT_EQ(nCircuits, hashes.size());
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
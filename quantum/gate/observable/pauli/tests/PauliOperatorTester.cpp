@@ -477,6 +477,41 @@ TEST(PauliOperatorTester,checkCommutes) {
     EXPECT_TRUE(op.commutes(zz));
     EXPECT_FALSE(PauliOperator({{0,"X"}}).commutes(y));
 }
+TEST(PauliOperatorTester,checkObservedKernelGroups) {
+    using namespace xacc;
+
+    // Observed kernels share the ansatz gates, but can
+    // still be optimized in parallel, one group each
+    auto gateRegistry = xacc::getService<IRProvider>("gate");
+    auto ansatz = gateRegistry->createFunction("ansatz", {}, {});
+    InstructionParameter angle(0.5);
+    ansatz->addInstruction(gateRegistry->createInstruction("X", std::vector<int>{0}));
+    ansatz->addInstruction(gateRegistry->createInstruction("Ry", std::vector<int>{1}, {angle}));
+    ansatz->addInstruction(gateRegistry->createInstruction("CNOT", std::vector<int>{1, 0}));
+
+    PauliOperator op("Z0 + X0 X1 + Y0 Y1 + Z1");
+    auto ir = gateRegistry->createIR();
+    std::vector<std::string> before;
+    for (auto& kernel : op.observe(ansatz)) {
+        ir->addKernel(kernel);
+        before.push_back(kernel->toString("q"));
+    }
+
+    // Grouping alone leaves the sharing in place
+    EXPECT_EQ(1, xacc::groupKernels(ir).size());
+    EXPECT_TRUE(ir->getKernels()[1]->getInstruction(1) == ansatz->getInstruction(1));
+
+    xacc::unshareKernelGates(ir);
+    auto groups = xacc::groupKernels(ir);
+    EXPECT_EQ(4, groups.size());
+    auto kernels = ir->getKernels();
+    for (int k = 0; k < kernels.size(); k++) {
+        EXPECT_EQ(before[k], kernels[k]->toString("q"));
+    }
+    EXPECT_TRUE(kernels[0]->getInstruction(1) == ansatz->getInstruction(1));
+    EXPECT_FALSE(kernels[1]->getInstruction(1) == ansatz->getInstruction(1));
+}
+
 int main(int argc, char** argv) {
     xacc::Initialize(argc,argv);
    ::testing::InitGoogleTest(&argc, argv);
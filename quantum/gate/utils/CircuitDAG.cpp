@@ -0,0 +1,403 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "CircuitDAG.hpp"
+#include "XACC.hpp"
+#include "InstructionIterator.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+namespace xacc {
+namespace quantum {
+
+CircuitDAG::CircuitDAG(std::shared_ptr<Function> function) {
+
+  // Qubits of disabled gates still get a wire
+  int maxBit = -1;
+  for (auto &inst : InstructionRange(function, Traversal::Leaves)) {
+    for (auto b : inst->bits()) {
+      maxBit = std::max(maxBit, b);
+    }
+  }
+
+  std::vector<InstPtr> gates;
+  for (auto &inst : InstructionRange(function, Traversal::EnabledLeaves)) {
+    if (!inst->bits().empty()) {
+      gates.push_back(inst);
+    }
+  }
+
+  std::vector<int> allBits(maxBit + 1);
+  std::iota(allBits.begin(), allBits.end(), 0);
+
+  names.reserve(gates.size() + 2);
+  opcodes.reserve(gates.size() + 2);
+  instructions.reserve(gates.size() + 2);
+  bitOffsets.reserve(gates.size() + 3);
+  edgeSources.reserve(2 * gates.size() + allBits.size());
+  edgeTargets.reserve(2 * gates.size() + allBits.size());
+  edgeWeights.reserve(2 * gates.size() + allBits.size());
+
+  appendVertex("InitialState", allBits, nullptr);
+
+  // The last vertex on each qubit
+  std::vector<int> lastNode(allBits.size(), 0);
+  for (auto &g : gates) {
+    auto id = order();
+    appendVertex(g->name(), g->bits(), g);
+    for (auto b : getBits(id)) {
+      addEdge(lastNode[b], id, 1.0);
+      lastNode[b] = id;
+    }
+  }
+
+  auto finalId = order();
+  appendVertex("FinalState", allBits, nullptr);
+  for (auto last : lastNode) {
+    addEdge(last, finalId, 1.0);
+  }
+
+  compress();
+}
+
+void CircuitDAG::appendVertex(const std::string &name,
+                              const std::vector<int> &bits, InstPtr inst) {
+  GateOp op;
+  names.push_back(name);
+  opcodes.push_back(GateTape::opcode(name, op) ? static_cast<int>(op) : -1);
+  instructions.push_back(inst);
+  bitData.insert(bitData.end(), bits.begin(), bits.end());
+  bitOffsets.push_back(bitData.size());
+  dirty = true;
+}
+
+bool CircuitDAG::getOpcode(const int index, GateOp &op) const {
+  if (opcodes[index] < 0) {
+    return false;
+  }
+  op = static_cast<GateOp>(opcodes[index]);
+  return true;
+}
+
+void CircuitDAG::compress() {
+  auto n = order();
+  auto m = size();
+
+  outOffsets.assign(n + 1, 0);
+  inOffsets.assign(n + 1, 0);
+  for (int e = 0; e < m; e++) {
+    outOffsets[edgeSources[e] + 1]++;
+    inOffsets[edgeTargets[e] + 1]++;
+  }
+  std::partial_sum(outOffsets.begin(), outOffsets.end(), outOffsets.begin());
+  std::partial_sum(inOffsets.begin(), inOffsets.end(), inOffsets.begin());
+
+  // Counting sort keeps edges from each vertex in insertion order
+  outTargets.resize(m);
+  outEdges.resize(m);
+  inSources.resize(m);
+  std::vector<int> outNext(outOffsets.begin(), outOffsets.end() - 1);
+  std::vector<int> inNext(inOffsets.begin(), inOffsets.end() - 1);
+  for (int e = 0; e < m; e++) {
+    auto o = outNext[edgeSources[e]]++;
+    outTargets[o] = edgeTargets[e];
+    outEdges[o] = e;
+    inSources[inNext[edgeTargets[e]]++] = edgeSources[e];
+  }
+
+  dirty = false;
+}
+
+IndexRange CircuitDAG::getSuccessors(const int index) {
+  if (dirty) {
+    compress();
+  }
+  return IndexRange(outTargets.data() + outOffsets[index],
+                    outTargets.data() + outOffsets[index + 1]);
+}
+
+IndexRange CircuitDAG::getPredecessors(const int index) {
+  if (dirty) {
+    compress();
+  }
+  return IndexRange(inSources.data() + inOffsets[index],
+                    inSources.data() + inOffsets[index + 1]);
+}
+
+void CircuitDAG::addEdge(const int srcIndex, const int tgtIndex,
+                         const double edgeWeight) {
+  if (srcIndex < 0 || tgtIndex < 0 || srcIndex >= order() ||
+      tgtIndex >= order()) {
+    XACCLogger::instance()->error("Failed to add an edge between " +
+                                  std::to_string(srcIndex) + " and " +
+                                  std::to_string(tgtIndex));
+  }
+  edgeSources.push_back(srcIndex);
+  edgeTargets.push_back(tgtIndex);
+  edgeWeights.push_back(edgeWeight);
+  dirty = true;
+}
+
+void CircuitDAG::removeEdge(const int srcIndex, const int tgtIndex) {
+  int kept = 0;
+  for (int e = 0; e < size(); e++) {
+    if (edgeSources[e] != srcIndex || edgeTargets[e] != tgtIndex) {
+      edgeSources[kept] = edgeSources[e];
+      edgeTargets[kept] = edgeTargets[e];
+      edgeWeights[kept] = edgeWeights[e];
+      kept++;
+    }
+  }
+  edgeSources.resize(kept);
+  edgeTargets.resize(kept);
+  edgeWeights.resize(kept);
+  dirty = true;
+}
+
+void CircuitDAG::addVertex() { appendVertex("", {}, nullptr); }
+
+void CircuitDAG::addVertex(
+    std::map<std::string, InstructionParameter> &properties) {
+  addVertex();
+  setVertexProperties(order() - 1, properties);
+}
+
+void CircuitDAG::setVertexProperties(
+    const int index, std::map<std::string, InstructionParameter> &properties) {
+  extras.erase(index);
+  names[index].clear();
+  opcodes[index] = -1;
+  InstructionParameter noBits(std::vector<int>{});
+  setVertexProperty(index, "bits", noBits);
+  for (auto &kv : properties) {
+    setVertexProperty(index, kv.first, kv.second);
+  }
+}
+
+void CircuitDAG::setVertexProperty(const int index, const std::string prop,
+                                   InstructionParameter &p) {
+  materialized.erase(index);
+  if (prop == "id") {
+    // The id is always the vertex index
+    return;
+  } else if (prop == "name") {
+    GateOp op;
+    names[index] = p.toString();
+    opcodes[index] =
+        GateTape::opcode(names[index], op) ? static_cast<int>(op) : -1;
+  } else if (prop == "bits") {
+    auto bits = p.as<std::vector<int>>();
+    auto delta = (int)bits.size() - getBits(index).size();
+    auto pos = bitData.erase(bitData.begin() + bitOffsets[index],
+                             bitData.begin() + bitOffsets[index + 1]);
+    bitData.insert(pos, bits.begin(), bits.end());
+    for (int i = index + 1; i < bitOffsets.size(); i++) {
+      bitOffsets[i] += delta;
+    }
+  } else {
+    extras[index][prop] = p;
+  }
+}
+
+std::map<std::string, InstructionParameter>
+CircuitDAG::getVertexProperties(const int index) {
+  std::map<std::string, InstructionParameter> properties;
+  auto it = extras.find(index);
+  if (it != extras.end()) {
+    properties = it->second;
+  }
+  auto bits = getBits(index);
+  properties.insert({"name", InstructionParameter(names[index])});
+  properties.insert({"id", InstructionParameter(index)});
+  properties.insert(
+      {"bits", InstructionParameter(std::vector<int>(bits.begin(), bits.end()))});
+  return properties;
+}
+
+InstructionParameter &
+CircuitDAG::getVertexProperty(const int index, const std::string property) {
+  auto it = materialized.find(index);
+  if (it == materialized.end()) {
+    it = materialized.emplace(index, getVertexProperties(index)).first;
+  }
+  auto prop = it->second.find(property);
+  if (prop == it->second.end()) {
+    XACCLogger::instance()->error("Invalid Graph vertex property name: " +
+                                  property);
+  }
+  return prop->second;
+}
+
+void CircuitDAG::setEdgeWeight(const int srcIndex, const int tgtIndex,
+                               const double weight) {
+  for (int e = 0; e < size(); e++) {
+    if (edgeSources[e] == srcIndex && edgeTargets[e] == tgtIndex) {
+      edgeWeights[e] = weight;
+      return;
+    }
+  }
+}
+
+double CircuitDAG::getEdgeWeight(const int srcIndex, const int tgtIndex) {
+  if (dirty) {
+    compress();
+  }
+  for (int o = outOffsets[srcIndex]; o < outOffsets[srcIndex + 1]; o++) {
+    if (outTargets[o] == tgtIndex) {
+      return edgeWeights[outEdges[o]];
+    }
+  }
+  return 0.0;
+}
+
+bool CircuitDAG::edgeExists(const int srcIndex, const int tgtIndex) {
+  auto successors = getSuccessors(srcIndex);
+  return std::find(successors.begin(), successors.end(), tgtIndex) !=
+         successors.end();
+}
+
+int CircuitDAG::diameter() {
+  // Longest of the unweighted shortest paths between reachable pairs
+  int diam = 0;
+  std::vector<int> dist(order());
+  std::queue<int> queue;
+  for (int s = 0; s < order(); s++) {
+    std::fill(dist.begin(), dist.end(), -1);
+    dist[s] = 0;
+    queue.push(s);
+    while (!queue.empty()) {
+      auto v = queue.front();
+      queue.pop();
+      diam = std::max(diam, dist[v]);
+      for (auto w : getSuccessors(v)) {
+        if (dist[w] < 0) {
+          dist[w] = dist[v] + 1;
+          queue.push(w);
+        }
+      }
+    }
+  }
+  return diam;
+}
+
+const int CircuitDAG::depth() {
+  if (order() == 0) {
+    return 0;
+  }
+
+  // Longest weighted path from the initial state, in topological order
+  std::vector<int> inDegree(order());
+  for (int v = 0; v < order(); v++) {
+    inDegree[v] = getPredecessors(v).size();
+  }
+
+  auto lowest = std::numeric_limits<double>::lowest();
+  std::vector<double> dist(order(), lowest);
+  std::vector<int> ready;
+  for (int v = 0; v < order(); v++) {
+    if (inDegree[v] == 0) {
+      ready.push_back(v);
+    }
+  }
+  dist[0] = 0.0;
+
+  double longest = 0.0;
+  while (!ready.empty()) {
+    auto v = ready.back();
+    ready.pop_back();
+    longest = std::max(longest, dist[v]);
+    for (int o = outOffsets[v]; o < outOffsets[v + 1]; o++) {
+      auto w = outTargets[o];
+      if (dist[v] != lowest) {
+        dist[w] = std::max(dist[w], dist[v] + edgeWeights[outEdges[o]]);
+      }
+      if (--inDegree[w] == 0) {
+        ready.push_back(w);
+      }
+    }
+  }
+
+  return (int)longest - 1;
+}
+
+void CircuitDAG::computeShortestPath(int startIndex,
+                                     std::vector<double> &distances,
+                                     std::vector<int> &paths) {
+  if (dirty) {
+    compress();
+  }
+
+  auto inf = (double)std::numeric_limits<int>::max();
+  std::vector<double> d(order(), inf);
+  std::vector<int> p(order());
+  std::iota(p.begin(), p.end(), 0);
+
+  using Entry = std::pair<double, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  d[startIndex] = 0.0;
+  queue.push({0.0, startIndex});
+  while (!queue.empty()) {
+    auto top = queue.top();
+    queue.pop();
+    auto v = top.second;
+    if (top.first > d[v]) {
+      continue;
+    }
+    for (int o = outOffsets[v]; o < outOffsets[v + 1]; o++) {
+      auto w = outTargets[o];
+      auto dw = d[v] + edgeWeights[outEdges[o]];
+      if (dw < d[w]) {
+        d[w] = dw;
+        p[w] = v;
+        queue.push({dw, w});
+      }
+    }
+  }
+
+  distances.insert(distances.end(), d.begin(), d.end());
+  paths.insert(paths.end(), p.begin(), p.end());
+}
+
+void CircuitDAG::write(std::ostream &stream) {
+  if (dirty) {
+    compress();
+  }
+
+  stream << "digraph G {\nnode [shape=box style=filled]\n";
+  for (int v = 0; v < order(); v++) {
+    stream << v << " [label=\"";
+    int counter = 0;
+    auto properties = getVertexProperties(v);
+    for (auto &kv : properties) {
+      stream << kv.first << "=" << kv.second.toString();
+      if (++counter < properties.size()) {
+        stream << ";";
+      }
+    }
+    stream << "\"];\n";
+  }
+  for (int v = 0; v < order(); v++) {
+    for (int o = outOffsets[v]; o < outOffsets[v + 1]; o++) {
+      stream << v << "->" << outTargets[o] << " ;\n";
+    }
+  }
+  stream << "}\n";
+}
+
+void CircuitDAG::read(std::istream &stream) {
+  XACCLogger::instance()->error("CircuitDAG does not support reading graphs.");
+}
+
+} // namespace quantum
+} // namespace xacc
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef QUANTUM_GATE_UTILS_CIRCUITDAG_HPP_
+#define QUANTUM_GATE_UTILS_CIRCUITDAG_HPP_
+
+#include "Graph.hpp"
+#include "GateTape.hpp"
+#include <unordered_map>
+
+namespace xacc {
+namespace quantum {
+
+/**
+ * A read-only view of a contiguous range of vertex indices.
+ */
+class IndexRange {
+public:
+  IndexRange(const int *b, const int *e) : first(b), last(e) {}
+  const int *begin() const { return first; }
+  const int *end() const { return last; }
+  const int size() const { return last - first; }
+  const bool empty() const { return first == last; }
+  const int operator[](const int idx) const { return first[idx]; }
+
+protected:
+  const int *first;
+  const int *last;
+};
+
+/**
+ * The CircuitDAG is a Graph purpose-built for gate-model circuits.
+ * Vertex 0 is the initial state, followed by one vertex per enabled
+ * gate in circuit order, and a final state vertex last. Each gate has
+ * an edge from the previous gate on each of its qubits, so a two-qubit
+ * gate following another on the same qubits gets two parallel edges.
+ *
+ * Adjacency is stored in compressed sparse row form, and the vertex
+ * name, opcode, qubits and Instruction live in typed columns. The
+ * typed accessors return references into that storage, use them
+ * instead of getVertexProperties() in hot loops. The string-keyed
+ * Graph property methods are still supported for generic clients.
+ */
+class CircuitDAG : public Graph {
+
+public:
+  CircuitDAG() {}
+
+  /**
+   * Build the DAG of the enabled gates of the given Function.
+   *
+   * @param function The circuit
+   */
+  CircuitDAG(std::shared_ptr<Function> function);
+
+  /**
+   * Return the vertex name, the gate name for gate vertices.
+   */
+  const std::string &getName(const int index) const { return names[index]; }
+
+  /**
+   * Get the opcode of a gate vertex.
+   *
+   * @param index The vertex index
+   * @param op The gate opcode
+   * @return found False if the vertex has no opcode
+   */
+  bool getOpcode(const int index, GateOp &op) const;
+
+  /**
+   * Return the gate Instruction for a gate vertex, null otherwise.
+   */
+  const InstPtr &getInstruction(const int index) const {
+    return instructions[index];
+  }
+
+  /**
+   * Return the qubits of the given vertex.
+   */
+  IndexRange getBits(const int index) const {
+    return IndexRange(bitData.data() + bitOffsets[index],
+                      bitData.data() + bitOffsets[index + 1]);
+  }
+
+  /**
+   * Return the targets of the out edges of the given vertex,
+   * in the order the edges were added.
+   */
+  IndexRange getSuccessors(const int index);
+
+  /**
+   * Return the sources of the in edges of the given vertex.
+   */
+  IndexRange getPredecessors(const int index);
+
+  std::shared_ptr<Graph> clone() override {
+    return std::make_shared<CircuitDAG>();
+  }
+
+  void addEdge(const int srcIndex, const int tgtIndex,
+               const double edgeWeight) override;
+  void addEdge(const int srcIndex, const int tgtIndex) override {
+    addEdge(srcIndex, tgtIndex, 1.0);
+  }
+  void removeEdge(const int srcIndex, const int tgtIndex) override;
+
+  void addVertex() override;
+  void addVertex(std::map<std::string, InstructionParameter> &properties) override;
+  void addVertex(std::map<std::string, InstructionParameter> &&properties) override {
+    addVertex(properties);
+  }
+
+  void setVertexProperties(
+      const int index,
+      std::map<std::string, InstructionParameter> &properties) override;
+  void setVertexProperties(
+      const int index,
+      std::map<std::string, InstructionParameter> &&properties) override {
+    setVertexProperties(index, properties);
+  }
+  void setVertexProperty(const int index, const std::string prop,
+                         InstructionParameter &p) override;
+  void setVertexProperty(const int index, const std::string prop,
+                         InstructionParameter &&p) override {
+    setVertexProperty(index, prop, p);
+  }
+
+  std::map<std::string, InstructionParameter>
+  getVertexProperties(const int index) override;
+
+  /**
+   * Return the given vertex property. The name, id and bits
+   * properties are copies of the typed columns, so writing
+   * through the returned reference does not change them.
+   */
+  InstructionParameter &getVertexProperty(const int index,
+                                          const std::string property) override;
+
+  void setEdgeWeight(const int srcIndex, const int tgtIndex,
+                     const double weight) override;
+  double getEdgeWeight(const int srcIndex, const int tgtIndex) override;
+  bool edgeExists(const int srcIndex, const int tgtIndex) override;
+
+  int degree(const int index) override { return getSuccessors(index).size(); }
+  int diameter() override;
+  int size() override { return edgeSources.size(); }
+  int order() override { return names.size(); }
+
+  const int depth() override;
+
+  std::vector<int> getNeighborList(const int index) override {
+    auto successors = getSuccessors(index);
+    return std::vector<int>(successors.begin(), successors.end());
+  }
+
+  void write(std::ostream &stream) override;
+  void read(std::istream &stream) override;
+
+  void computeShortestPath(int startIndex, std::vector<double> &distances,
+                           std::vector<int> &paths) override;
+
+  const std::string name() const override { return "circuit-dag"; }
+  const std::string description() const override {
+    return "Compressed sparse row circuit DAG with typed vertex columns.";
+  }
+
+protected:
+  void appendVertex(const std::string &name, const std::vector<int> &bits,
+                    InstPtr inst);
+
+  // Rebuild the CSR arrays after edge edits
+  void compress();
+
+  // Vertex columns
+  std::vector<std::string> names;
+  std::vector<int> opcodes;
+  std::vector<InstPtr> instructions;
+  std::vector<int> bitOffsets{0};
+  std::vector<int> bitData;
+
+  // Properties other than name, id and bits
+  std::unordered_map<int, std::map<std::string, InstructionParameter>> extras;
+  std::unordered_map<int, std::map<std::string, InstructionParameter>>
+      materialized;
+
+  // The edges in insertion order
+  std::vector<int> edgeSources;
+  std::vector<int> edgeTargets;
+  std::vector<double> edgeWeights;
+
+  // CSR adjacency, rebuilt when dirty
+  bool dirty = false;
+  std::vector<int> outOffsets{0};
+  std::vector<int> outTargets;
+  std::vector<int> outEdges;
+  std::vector<int> inOffsets{0};
+  std::vector<int> inSources;
+};
+
+} // namespace quantum
+} // namespace xacc
+
+#endif
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "GateFunction.hpp"
+#include "CircuitDAG.hpp"
+#include "DigitalGates.hpp"
+#include "XACC.hpp"
+
+using namespace xacc::quantum;
+
+TEST(CircuitDAGTester, checkTypedAccessors) {
+  auto f = std::make_shared<GateFunction>("foo");
+  auto h = std::make_shared<Hadamard>(1);
+  auto cn1 = std::make_shared<CNOT>(1, 2);
+  auto x = std::make_shared<X>(0);
+  auto rz = std::make_shared<Rz>(2, 3.1415);
+  f->addInstruction(h);
+  f->addInstruction(cn1);
+  f->addInstruction(x);
+  f->addInstruction(rz);
+  x->disable();
+
+  CircuitDAG dag(f);
+  EXPECT_EQ(5, dag.order());
+  EXPECT_EQ("InitialState", dag.getName(0));
+  EXPECT_EQ("FinalState", dag.getName(4));
+  EXPECT_TRUE(dag.getInstruction(0) == nullptr);
+  EXPECT_TRUE(dag.getInstruction(3) == rz);
+
+  GateOp op;
+  EXPECT_FALSE(dag.getOpcode(0, op));
+  EXPECT_TRUE(dag.getOpcode(2, op));
+  EXPECT_TRUE(op == GateOp::CNOT);
+
+  auto bits = dag.getBits(2);
+  EXPECT_EQ(std::vector<int>({1, 2}), std::vector<int>(bits.begin(), bits.end()));
+  EXPECT_EQ(3, dag.getBits(0).size());
+
+  // Qubit 0 only has a disabled gate, so it goes straight to the final state
+  EXPECT_EQ(std::vector<int>({1, 2, 4}), dag.getNeighborList(0));
+  EXPECT_EQ(std::vector<int>({3, 4}), dag.getNeighborList(2));
+  auto preds = dag.getPredecessors(4);
+  EXPECT_EQ(std::vector<int>({0, 2, 3}),
+            std::vector<int>(preds.begin(), preds.end()));
+  EXPECT_EQ(3, dag.depth());
+
+  std::vector<double> distances;
+  std::vector<int> paths;
+  dag.computeShortestPath(0, distances, paths);
+  EXPECT_EQ(std::vector<double>({0, 1, 1, 2, 1}), distances);
+  EXPECT_EQ(std::vector<int>({0, 0, 0, 2, 0}), paths);
+}
+
+TEST(CircuitDAGTester, checkParallelEdges) {
+  auto f = std::make_shared<GateFunction>("foo");
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+  f->addInstruction(std::make_shared<CNOT>(0, 1));
+
+  CircuitDAG dag(f);
+  EXPECT_EQ(6, dag.size());
+  EXPECT_EQ(std::vector<int>({2, 2}), dag.getNeighborList(1));
+  EXPECT_EQ(2, dag.depth());
+
+  dag.removeEdge(1, 2);
+  EXPECT_FALSE(dag.edgeExists(1, 2));
+  EXPECT_EQ(4, dag.size());
+}
+
+TEST(CircuitDAGTester, checkVertexProperties) {
+  CircuitDAG dag;
+  dag.addVertex({{"name", "H"}, {"bits", std::vector<int>{0}}, {"weight", 2.0}});
+  dag.addVertex();
+  dag.addEdge(0, 1, 3.0);
+
+  EXPECT_EQ("H", dag.getName(0));
+  EXPECT_EQ(2.0, dag.getVertexProperty(0, "weight").as<double>());
+  EXPECT_EQ(1, dag.getVertexProperty(1, "id").as<int>());
+  EXPECT_EQ(3.0, dag.getEdgeWeight(0, 1));
+
+  dag.setVertexProperty(1, "bits", std::vector<int>{3, 4});
+  EXPECT_EQ(std::vector<int>({3, 4}),
+            dag.getVertexProperties(1)["bits"].as<std::vector<int>>());
+  EXPECT_EQ(std::vector<int>({0}),
+            dag.getVertexProperties(0)["bits"].as<std::vector<int>>());
+
+  std::stringstream ss;
+  dag.write(ss);
+  EXPECT_EQ("digraph G {\nnode [shape=box style=filled]\n"
+            "0 [label=\"bits=[0];id=0;name=H;weight=2\"];\n"
+            "1 [label=\"bits=[3,4];id=1;name=\"];\n0->1 ;\n}\n",
+            ss.str());
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
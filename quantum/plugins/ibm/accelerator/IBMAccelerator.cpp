@@ -43,6 +43,7 @@
 using namespace rapidjson;
 
 #include "XACC.hpp"
+#include "QubitRouter.hpp"
 
 #include "QObject.hpp"
 
@@ -113,6 +114,18 @@ std::vector<std::shared_ptr<IRTransformation>>
 IBMAccelerator::getIRTransformations() {
 
   std::vector<std::shared_ptr<IRTransformation>> transformations;
+
+  // Route onto the backend coupling map, where cx only
+  // runs from control to target along each coupler
+  std::string backendName = "ibmq_qasm_simulator";
+  if (xacc::optionExists("ibm-backend")) {
+    backendName = xacc::getOption("ibm-backend");
+  }
+  if (availableBackends.count(backendName) &&
+      !availableBackends[backendName].couplers.empty()) {
+    transformations.push_back(std::make_shared<QubitRouter>(
+        getAcceleratorConnectivity(), true));
+  }
   return transformations;
 }
 
@@ -319,13 +332,9 @@ IBMAccelerator::processInput(std::shared_ptr<AcceleratorBuffer> buffer,
     auto visitor =
         std::make_shared<QObjectExperimentVisitor>(kernel->name(), chosenBackend.nQubits);
 
-    InstructionIterator it(kernel);
     int memSlots = 0;
-    while (it.hasNext()) {
-      auto nextInst = it.next();
-      if (nextInst->isEnabled()) {
-        nextInst->accept(visitor);
-      }
+    for (auto &nextInst : InstructionRange(kernel, Traversal::Enabled)) {
+      nextInst->accept(visitor);
     }
 
     // After calling getExperiment, maxMemorySlots should be
@@ -351,7 +360,8 @@ IBMAccelerator::processInput(std::shared_ptr<AcceleratorBuffer> buffer,
         if (it == std::end(connectivity)) {
           std::stringstream ss;
           ss << "Invalid logical program connectivity, no connection between "
-             << inst.get_qubits();
+             << inst.get_qubits()
+             << ". Run the qubit-router IRTransformation first.";
           xacc::error(ss.str());
         }
       }
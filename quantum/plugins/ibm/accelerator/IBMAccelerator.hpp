@@ -141,8 +141,8 @@ public:
   AcceleratorType getType() override { return AcceleratorType::qpu_gate; }
 
   /**
-   * We have no need to transform the IR for this Accelerator,
-   * so return an empty list, for now.
+   * Return a QubitRouter for the chosen backend's coupling
+   * map, or an empty list for backends without one.
    * @return
    */
   std::vector<std::shared_ptr<IRTransformation>>
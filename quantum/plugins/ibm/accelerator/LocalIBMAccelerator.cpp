@@ -81,10 +81,7 @@ void LocalIBMAccelerator::execute(
     const std::shared_ptr<xacc::Function> kernel) {
   auto buffers =
       execute(buffer, std::vector<std::shared_ptr<xacc::Function>>{kernel});
-  for (auto &kv : buffers[0]->getMeasurementCounts()) {
-    for (int i = 0; i < kv.second; i++)
-      buffer->appendMeasurement(kv.first);
-  }
+  buffer->appendMeasurements(buffers[0]->getMeasurementCounts());
 }
 
 std::vector<std::shared_ptr<AcceleratorBuffer>> LocalIBMAccelerator::execute(
@@ -103,17 +100,13 @@ std::vector<std::shared_ptr<AcceleratorBuffer>> LocalIBMAccelerator::execute(
       h["qubit_labels"].push_back({"q", i});
     }
 
-    InstructionIterator it(kernel);
     measurementSupports.insert(
         std::make_pair(kernelCounter, std::vector<int>{}));
-    while (it.hasNext()) {
-      auto nextInst = it.next();
-      if (nextInst->isEnabled()) {
-        nextInst->accept(visitor);
-        if (nextInst->name() == "Measure") {
-          auto qbitIdx = nextInst->bits()[0];
-          measurementSupports[kernelCounter].push_back(qbitIdx);
-        }
+    for (auto &nextInst : InstructionRange(kernel, Traversal::Enabled)) {
+      nextInst->accept(visitor);
+      if (nextInst->name() == "Measure") {
+        auto qbitIdx = nextInst->bits()[0];
+        measurementSupports[kernelCounter].push_back(qbitIdx);
       }
     }
 
@@ -242,8 +235,7 @@ std::vector<std::shared_ptr<AcceleratorBuffer>> LocalIBMAccelerator::execute(
           bitString = s;
       }
 
-      for (int i = 0; i < countInt; i++)
-        tmpBuffer->appendMeasurement(bitString);
+      tmpBuffer->appendMeasurements({{bitString, countInt}});
     }
 
     kernelCounter++;
@@ -77,26 +77,18 @@ OQASMCompiler::translate(const std::string &bufferVariable,
                          std::shared_ptr<xacc::Function> function) {
   // Get the number of qubits
   int maxBit = 0;
-  InstructionIterator temp(function);
-  while (temp.hasNext()) {
-    auto nextInst = temp.next();
-    if (nextInst->isEnabled()) {
-      for (auto &b : nextInst->bits()) {
-        if (b > maxBit) {
-          maxBit = b;
-        }
+  for (auto &nextInst : InstructionRange(function, Traversal::Enabled)) {
+    for (auto &b : nextInst->bits()) {
+      if (b > maxBit) {
+        maxBit = b;
       }
     }
   }
   auto nQubits = maxBit + 1;
 
   auto visitor = std::make_shared<OpenQasmVisitor>(nQubits);
-  InstructionIterator it(function);
-  while (it.hasNext()) {
-    auto nextInst = it.next();
-    if (nextInst->isEnabled()) {
-      nextInst->accept(visitor);
-    }
+  for (auto &nextInst : InstructionRange(function, Traversal::Enabled)) {
+    nextInst->accept(visitor);
   }
   return visitor->getOpenQasmString();
 }
@@ -96,15 +96,10 @@ const std::string QVMAccelerator::processInput(
   if (functions.size() > 1)
     xacc::error("Rigetti QVMAccelerator can only launch one job at a time.");
 
-  InstructionIterator it(functions[0]);
-  while (it.hasNext()) {
-    // Get the next node in the tree
-    auto nextInst = it.next();
-    if (nextInst->isEnabled()) {
-      nextInst->accept(visitor);
-      if (nextInst->name() == "Measure") {
-        currentMeasurementSupports.push_back(nextInst->bits()[0]);
-      }
+  for (auto &nextInst : InstructionRange(functions[0], Traversal::Enabled)) {
+    nextInst->accept(visitor);
+    if (nextInst->name() == "Measure") {
+      currentMeasurementSupports.push_back(nextInst->bits()[0]);
     }
   }
 
@@ -190,13 +190,12 @@ public:
     auto t = u.getParameter(0).toString();
     auto p = u.getParameter(1).toString();
     auto l = u.getParameter(2).toString();
+    std::string qubit = std::to_string(u.bits()[0]);
 
-    std::stringstream s;
-    s << "   Rz(" << t << ", " << u.bits()[0] << ")\n";
-    s << "   Ry(" << p << ", " << u.bits()[0] << ")\n";
-    s << "   Rz(" << l << ", " << u.bits()[0] << ")\n";
-
-    quilStr += s.str();
+    // U(theta, phi, lambda) = Rz(phi) Ry(theta) Rz(lambda)
+    quilStr += "RZ(" + l + ") " + qubit + "\n";
+    quilStr += "RX(pi/2) " + qubit + "\nRZ(" + t + ") " + qubit + "\nRX(-pi/2) " + qubit + "\n";
+    quilStr += "RZ(" + p + ") " + qubit + "\n";
   }
 
   void visit(GateFunction &f) { return; }
@@ -186,24 +186,15 @@ void QCSAccelerator::execute(std::shared_ptr<AcceleratorBuffer> buffer,
   //  py::print("QUIL\n");
   // py::print(quilStr);
   //py::print(buffer->size());
-  std::string zeroString = "";
-  for (int i = 0; i < shape[1]; i++)
-    zeroString += "0";
-
+  // Pack each shot's bits, bit j of the word being classical bit j,
+  // and count equal shots before any bit strings are built
+  std::vector<std::uint64_t> packed(shots);
   for (int i = 0; i < shots; i++) {
-    std::string bitString = zeroString;
-    std::stringstream s;
-
     for (int j = 0; j < shape[1]; j++) {
-      //   auto qbit = bitToQubit[j];
-      s << *results.data(i, j);
-      //   bitString[buffer->size()-1-qbit] = s.str()[0];
+      packed[i] |= std::uint64_t(*results.data(i, j) & 1) << j;
     }
-    bitString = s.str();
-    std::reverse(bitString.begin(), bitString.end());
-    //    if (i<4) py::print("adding " + bitString);
-    buffer->appendMeasurement(bitString);
   }
+  buffer->appendShots(packed, shape[1]);
 
   return;
 }
@@ -15,9 +15,15 @@
 #include "IRProvider.hpp"
 #include "IRGenerator.hpp"
 #include "CLIParser.hpp"
+#include "CompilerDecorator.hpp"
+#include "PassManager.hpp"
+#include "ThreadPool.hpp"
 #include <signal.h>
 #include <cstdlib>
 #include <fstream>
+#include <numeric>
+#include <set>
+#include <unordered_map>
 #include "xacc_config.hpp"
 #include "cxxopts.hpp"
 
@@ -250,6 +256,17 @@ bool hasAccelerator(const std::string &name) {
   return xacc::hasService<Accelerator>(name);
 }
 
+// Decorate the Compiler with the compilation cache, when one is configured
+static std::shared_ptr<Compiler> withCache(std::shared_ptr<Compiler> compiler) {
+  if (!compiler || !optionExists("compilation-cache-dir") ||
+      !xacc::hasService<CompilerDecorator>("compilation-cache")) {
+    return compiler;
+  }
+  auto cached = xacc::getService<CompilerDecorator>("compilation-cache");
+  cached->setDecorated(compiler);
+  return cached;
+}
+
 std::shared_ptr<Compiler> getCompiler(const std::string &name) {
   if (!xacc::xaccFrameworkInitialized) {
     error("XACC not initialized before use. Please execute "
@@ -259,7 +276,7 @@ std::shared_ptr<Compiler> getCompiler(const std::string &name) {
   if (!c) {
     error("Invalid Compiler. Could not find " + name + " in Service Registry.");
   }
-  return c;
+  return withCache(c);
 }
 
 std::shared_ptr<Compiler> getCompiler() {
@@ -277,7 +294,7 @@ std::shared_ptr<Compiler> getCompiler() {
     error("Invalid Compiler. Could not find " + (*options)["compiler"] +
           " in Compiler Registry.");
   }
-  return compiler;
+  return withCache(compiler);
 }
 
 bool hasCompiler(const std::string &name) {
@@ -290,7 +307,7 @@ bool hasCompiler(const std::string &name) {
 }
 
 std::shared_ptr<IRTransformation>
-getIRTransformations(const std::string &name) {
+getIRTransformation(const std::string &name) {
   if (!xacc::xaccFrameworkInitialized) {
     error("XACC not initialized before use. Please execute "
           "xacc::Initialize() before using API.");
@@ -323,13 +340,9 @@ const std::string translateWithVisitor(const std::string &originalSource,
 
   std::vector<std::string> previouslySeenKernels;
 
-  InstructionIterator it(ir->getKernels()[kernel]);
-  while (it.hasNext()) {
-    // Get the next node in the tree
-    auto nextInst = it.next();
-    if (nextInst->isEnabled()) {
-      nextInst->accept(visitor);
-    }
+  for (auto &nextInst :
+       InstructionRange(ir->getKernels()[kernel], Traversal::Enabled)) {
+    nextInst->accept(visitor);
   }
 
   return visitor->toString();
@@ -352,11 +365,109 @@ std::shared_ptr<Function> optimizeFunction(const std::string optimizer,
                                            std::shared_ptr<Function> function) {
   auto ir = getService<IRProvider>("gate")->createIR();
   ir->addKernel(function);
-  auto opt = getService<IRTransformation>(optimizer);
-  auto newir = opt->transform(ir);
+  PassManager passes(optimizer);
+  auto newir = passes.run(ir);
+  if (!optionExists("circuit-opt-silent")) {
+    passes.report();
+  }
   auto optF = newir->getKernels()[0];
-  return optF->enabledView();
+  optF->removeDisabled();
+  return optF;
+}
+
+void unshareKernelGates(std::shared_ptr<IR> ir) {
+  auto kernels = ir->getKernels();
+
+  // Kernels often hold the same leaf gates, as observe() adds the
+  // ansatz gates to the kernel of every term. Give every kernel after
+  // the first one holding such a gate its own copy of it.
+  std::shared_ptr<IRProvider> provider;
+  std::set<std::string> copyable;
+  std::unordered_map<Instruction *, int> holder;
+  for (int k = 0; k < kernels.size(); k++) {
+    for (int i = 0; i < kernels[k]->nInstructions(); i++) {
+      auto inst = kernels[k]->getInstruction(i);
+      if (inst->isComposite()) {
+        continue;
+      }
+      auto it = holder.emplace(inst.get(), k);
+      if (it.second || it.first->second == k) {
+        continue;
+      }
+      if (!provider) {
+        provider = getService<IRProvider>("gate");
+        auto names = provider->getInstructions();
+        copyable.insert(names.begin(), names.end());
+      }
+      if (copyable.count(inst->name())) {
+        auto copy = provider->createInstruction(inst->name(), inst->bits(),
+                                                inst->getParameters());
+        for (auto &option : inst->getOptions()) {
+          copy->setOption(option.first, option.second);
+        }
+        if (!inst->isEnabled()) {
+          copy->disable();
+        }
+        kernels[k]->replaceInstruction(i, copy);
+      }
+    }
+  }
+}
+
+std::vector<std::vector<int>> groupKernels(std::shared_ptr<IR> ir) {
+  auto kernels = ir->getKernels();
+
+  // Union kernels that still reach a common Instruction
+  std::vector<int> parent(kernels.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int(int)> find = [&](int k) {
+    while (parent[k] != k) {
+      k = parent[k] = parent[parent[k]];
+    }
+    return k;
+  };
+  std::unordered_map<Instruction *, int> owner;
+  for (int k = 0; k < kernels.size(); k++) {
+    auto visit = [&](Instruction *inst) {
+      auto it = owner.emplace(inst, k);
+      if (!it.second) {
+        auto a = find(k), b = find(it.first->second);
+        parent[std::max(a, b)] = std::min(a, b);
+      }
+    };
+    visit(kernels[k].get());
+    for (auto &inst : InstructionRange(kernels[k])) {
+      visit(inst.get());
+    }
+  }
+
+  std::vector<std::vector<int>> groups;
+  std::vector<int> groupOf(kernels.size(), -1);
+  for (int k = 0; k < kernels.size(); k++) {
+    auto root = find(k);
+    if (groupOf[root] < 0) {
+      groupOf[root] = groups.size();
+      groups.emplace_back();
+    }
+    groups[groupOf[root]].push_back(k);
+  }
+  return groups;
+}
+
+void parallelForEachKernel(
+    std::shared_ptr<IR> ir,
+    const std::function<void(const int, std::shared_ptr<Function>)> &body) {
+  // Each group runs its kernels in order on one thread
+  unshareKernelGates(ir);
+  auto groups = groupKernels(ir);
+  auto kernels = ir->getKernels();
+  ThreadPool::shared()->parallelFor(groups.size(), [&](const int g) {
+    for (auto k : groups[g]) {
+      body(k, kernels[k]);
+    }
+  });
 }
+
 bool hasCache(const std::string fileName, const std::string subdirectory) {
   auto rootPathStr = xacc::getRootPathString();
   if (!subdirectory.empty()) {
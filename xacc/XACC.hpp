@@ -225,13 +225,15 @@ std::shared_ptr<Accelerator> getAccelerator();
 bool hasAccelerator(const std::string &name);
 
 /**
- * Return the Compiler with given name
+ * Return the Compiler with given name. While the
+ * compilation-cache-dir option is set, the Compiler
+ * caches the IR it compiles in that directory.
  */
 std::shared_ptr<Compiler> getCompiler(const std::string &name);
 
 /**
  * Get the Compiler that is currently specified by the
- * 'compiler' option key.
+ * 'compiler' option key, caching as getCompiler(name) does.
  *
  * @return compiler The Compiler
  */
@@ -289,9 +291,55 @@ const std::string getRootDirectory();
 //   return serviceRegistry->getServices<ServiceInterface>();
 // }
 
+/**
+ * Optimize the given Function with an IRTransformation, or a
+ * PassManager pipeline of them like (circuit-optimizer)*. The time
+ * and gate count change of each pass run is logged, unless the
+ * circuit-opt-silent option is set.
+ *
+ * @param optimizer The IRTransformation name or pipeline
+ * @param function The Function to optimize
+ * @return optF The optimized Function
+ */
 std::shared_ptr<Function> optimizeFunction(const std::string optimizer,
                                            std::shared_ptr<Function> function);
 
+/**
+ * Replace each leaf gate held directly by more than one kernel of
+ * the IR with a copy, in every kernel but the first holding it, so
+ * that those kernels no longer share it. Gates the gate IRProvider
+ * cannot create are left shared.
+ *
+ * @param ir The IR whose kernels to edit
+ */
+void unshareKernelGates(std::shared_ptr<IR> ir);
+
+/**
+ * Split the kernels of the IR into the groups parallelForEachKernel
+ * hands to one thread each. Kernels that share a nested Function or
+ * Instruction end up in one group. The IR is left unchanged.
+ *
+ * @param ir The IR whose kernels to group
+ * @return groups The kernel indices of each group, in kernel order
+ */
+std::vector<std::vector<int>> groupKernels(std::shared_ptr<IR> ir);
+
+/**
+ * Call body on each kernel of the IR, with the kernel index, in
+ * parallel on the shared ThreadPool. Shared leaf gates are first
+ * copied by unshareKernelGates(), then kernels are split as by
+ * groupKernels(), and the kernels of a group are handed to one thread
+ * in kernel order, so no Instruction is touched by two threads at
+ * once. Write results by kernel index to keep the output order
+ * deterministic.
+ *
+ * @param ir The IR whose kernels to visit
+ * @param body The function to call on each kernel
+ */
+void parallelForEachKernel(
+    std::shared_ptr<IR> ir,
+    const std::function<void(const int, std::shared_ptr<Function>)> &body);
+
 void analyzeBuffer(std::shared_ptr<AcceleratorBuffer> buffer);
 
 std::shared_ptr<IRTransformation> getIRTransformation(const std::string &name);
@@ -13,6 +13,8 @@
 #include "AcceleratorBuffer.hpp"
 #include "XACC.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <numeric>
 
 #define RAPIDJSON_HAS_STDSTRING 1
@@ -149,7 +151,8 @@ AcceleratorBuffer::AcceleratorBuffer(const std::string &str, const int N)
     : bufferId(str), nBits(N) {}
 
 AcceleratorBuffer::AcceleratorBuffer(const AcceleratorBuffer &other)
-    : nBits(other.nBits), bufferId(other.bufferId) {}
+    : nBits(other.nBits), bufferId(other.bufferId),
+      exactExpValZ(other.exactExpValZ), expValZ(other.expValZ) {}
 
 bool AcceleratorBuffer::addExtraInfo(const std::string infoName, ExtraInfo i,
                                      AddPredicate predicate) {
@@ -302,6 +305,7 @@ void AcceleratorBuffer::resetBuffer() {
   bitStringToCounts.clear();
   children.clear();
   info.clear();
+  exactExpValZ = false;
 }
 
 void AcceleratorBuffer::appendMeasurement(const std::string &measurement) {
@@ -316,6 +320,59 @@ void AcceleratorBuffer::appendMeasurement(const std::string measurement,
   return;
 }
 
+namespace {
+// The bit string of the given bits, bit 0 rightmost
+std::string toBitString(const std::uint64_t bits, const int nBits) {
+  std::string s(nBits, '0');
+  for (int i = 0; i < nBits && i < 64; i++) {
+    if ((bits >> i) & 1) {
+      s[nBits - 1 - i] = '1';
+    }
+  }
+  return s;
+}
+} // namespace
+
+void AcceleratorBuffer::appendMeasurements(
+    const std::map<std::string, int> &counts) {
+  // Both maps are sorted, so each insertion goes right after the last
+  auto hint = bitStringToCounts.begin();
+  for (auto &kv : counts) {
+    auto it = bitStringToCounts.insert(hint, {kv.first, 0});
+    it->second += kv.second;
+    hint = std::next(it);
+  }
+}
+
+void AcceleratorBuffer::appendHistogram(const std::vector<int> &counts,
+                                        const int nBits) {
+  // Increasing indices are increasing bit strings, so each
+  // insertion goes right after the last
+  auto hint = bitStringToCounts.begin();
+  for (std::uint64_t i = 0; i < counts.size(); i++) {
+    if (counts[i] > 0) {
+      auto it = bitStringToCounts.insert(hint, {toBitString(i, nBits), 0});
+      it->second += counts[i];
+      hint = std::next(it);
+    }
+  }
+}
+
+void AcceleratorBuffer::appendShots(const std::vector<std::uint64_t> &shots,
+                                    const int nBits) {
+  if (nBits > 64) {
+    xacc::error("Packed shots hold at most 64 bits, not " +
+                std::to_string(nBits) + ".");
+  }
+  auto sorted = shots;
+  std::sort(sorted.begin(), sorted.end());
+  for (auto first = sorted.begin(); first != sorted.end();) {
+    auto last = std::upper_bound(first, sorted.end(), *first);
+    bitStringToCounts[toBitString(*first, nBits)] += last - first;
+    first = last;
+  }
+}
+
 double
 AcceleratorBuffer::computeMeasurementProbability(const std::string &bitStr) {
   return (double)bitStringToCounts[bitStr] /
@@ -345,6 +402,10 @@ std::shared_ptr<AcceleratorBuffer> AcceleratorBuffer::clone() {
  * @return expVal The expectation value
  */
 const double AcceleratorBuffer::getExpectationValueZ() {
+  if (exactExpValZ) {
+    return expValZ;
+  }
+
   double aver = 0.0;
   auto has_even_parity = [](unsigned int x) -> int {
     unsigned int count = 0, i, b = 1;
@@ -376,9 +437,8 @@ const double AcceleratorBuffer::getExpectationValueZ() {
 }
 
 void AcceleratorBuffer::setExpectationValueZ(const double exp) {
-  XACCLogger::instance()->error(
-      "AcceleratorBuffer.setExpectationValueZ not "
-      "implemented. This method is intended for subclasses.");
+  exactExpValZ = true;
+  expValZ = exp;
 }
 
 /**
@@ -449,6 +509,10 @@ void AcceleratorBuffer::print(std::ostream &stream) {
       writer.Int(kv.second);
     }
     writer.EndObject();
+    if (exactExpValZ) {
+      writer.Key("ExpectationValueZ");
+      writer.Double(expValZ);
+    }
   }
 
   if (!children.empty()) {
@@ -483,6 +547,10 @@ void AcceleratorBuffer::print(std::ostream &stream) {
         writer.Int(kv.second);
       }
       writer.EndObject();
+      if (pair.second->exactExpValZ) {
+        writer.Key("ExpectationValueZ");
+        writer.Double(pair.second->expValZ);
+      }
       // End child object
       writer.EndObject();
     }
@@ -609,6 +677,11 @@ void AcceleratorBuffer::load(std::istream &stream) {
       tmpMap.insert({std::stoi(itr->name.GetString()), itr->value.GetInt()});
     }
     setBitIndexMap(tmpMap);
+
+    if (doc["AcceleratorBuffer"].HasMember("ExpectationValueZ")) {
+      setExpectationValueZ(
+          doc["AcceleratorBuffer"]["ExpectationValueZ"].GetDouble());
+    }
   }
 
   auto children = doc["AcceleratorBuffer"]["Children"].GetArray();
@@ -671,6 +744,10 @@ void AcceleratorBuffer::load(std::istream &stream) {
     }
     childBuffer->setBitIndexMap(tmpMap);
 
+    if (c.HasMember("ExpectationValueZ")) {
+      childBuffer->setExpectationValueZ(c["ExpectationValueZ"].GetDouble());
+    }
+
     appendChild(c["name"].GetString(), childBuffer);
   }
 }
@@ -13,6 +13,7 @@
 #ifndef XACC_ACCELERATOR_ACCELERATORBUFFER_HPP_
 #define XACC_ACCELERATOR_ACCELERATORBUFFER_HPP_
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -181,6 +182,12 @@ protected:
 
   std::map<int, int> bit2IndexMap;
 
+  /**
+   * The exact expectation value of Z, if an Accelerator set one.
+   */
+  bool exactExpValZ = false;
+  double expValZ = 0.0;
+
 public:
   AcceleratorBuffer() {}
   AcceleratorBuffer(const int N);
@@ -252,6 +259,36 @@ public:
   virtual void appendMeasurement(const std::string measurement,
                                  const int count);
 
+  /**
+   * Add the given counts to those of the measured bit strings,
+   * in one pass instead of one appendMeasurement call per shot.
+   *
+   * @param counts The number of shots of each bit string
+   */
+  virtual void appendMeasurements(const std::map<std::string, int> &counts);
+
+  /**
+   * Add a dense histogram of shots, where counts[i] shots measured the
+   * bit string of i, classical bit 0 rightmost. Each bit string is
+   * built once, however many shots measured it.
+   *
+   * @param counts The number of shots of each basis state index
+   * @param nBits The width of the bit strings
+   */
+  virtual void appendHistogram(const std::vector<int> &counts,
+                               const int nBits);
+
+  /**
+   * Add packed shots, each the measured bits of one shot, classical
+   * bit i being bit i of the word. Equal shots are counted before
+   * their bit string is built.
+   *
+   * @param shots The measured bits of each shot
+   * @param nBits The width of the bit strings, at most 64
+   */
+  virtual void appendShots(const std::vector<std::uint64_t> &shots,
+                           const int nBits);
+
   virtual double computeMeasurementProbability(const std::string &bitStr);
 
   /**
@@ -261,12 +298,28 @@ public:
    * are free to implement this as they see fit, ie, for simulators
    * use the wavefunction.
    *
+   * If an exact expectation value has been set, it is returned
+   * and the measurement counts are not read.
+   *
    * @return expVal The expectation value
    */
   virtual const double getExpectationValueZ();
 
+  /**
+   * Set the exact expectation value with respect to the
+   * Pauli-Z operator, as computed by a simulator without sampling.
+   *
+   * @param exp The expectation value
+   */
   virtual void setExpectationValueZ(const double exp);
 
+  /**
+   * Return true if an exact expectation value of Z has been set.
+   *
+   * @return exact True if the expectation value is exact
+   */
+  bool hasExactExpectationValueZ() const { return exactExpValZ; }
+
   /**
    * Return all measurements as bit strings.
    *
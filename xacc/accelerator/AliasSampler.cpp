@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "AliasSampler.hpp"
+#include "XACC.hpp"
+#include <numeric>
+
+namespace xacc {
+
+AliasSampler::AliasSampler(const std::vector<double> &weights)
+    : probability(weights.size()), alias(weights.size()) {
+  const std::uint64_t n = weights.size();
+  const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+  if (n == 0 || !(total > 0.0)) {
+    xacc::error("Cannot sample from a distribution of zero total weight.");
+  }
+
+  // Vose's construction: columns scaled to an average of 1 are split
+  // into those under and over full, and each under full column is
+  // topped up from an over full one
+  std::vector<std::uint64_t> small, large;
+  for (std::uint64_t i = 0; i < n; i++) {
+    probability[i] = weights[i] * n / total;
+    (probability[i] < 1.0 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    auto s = small.back(), l = large.back();
+    small.pop_back();
+    alias[s] = l;
+    probability[l] -= 1.0 - probability[s];
+    if (probability[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // What is left is full up to rounding
+  for (auto i : small) {
+    probability[i] = 1.0;
+  }
+  for (auto i : large) {
+    probability[i] = 1.0;
+  }
+}
+
+std::uint64_t AliasSampler::sample(std::mt19937_64 &generator) const {
+  // A uniform double in [0, N) from the top 53 random bits, whose integer
+  // part picks the column and fraction picks its outcome or its alias
+  const double r =
+      (generator() >> 11) * (probability.size() / 9007199254740992.0);
+  const std::uint64_t column =
+      std::min<std::uint64_t>(r, probability.size() - 1);
+  return r - column < probability[column] ? column : alias[column];
+}
+
+std::vector<int> AliasSampler::histogram(const int shots,
+                                         std::mt19937_64 &generator) const {
+  std::vector<int> counts(probability.size());
+  for (int shot = 0; shot < shots; shot++) {
+    counts[sample(generator)]++;
+  }
+  return counts;
+}
+
+} // namespace xacc
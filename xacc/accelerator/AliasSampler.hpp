@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef XACC_ACCELERATOR_ALIASSAMPLER_HPP_
+#define XACC_ACCELERATOR_ALIASSAMPLER_HPP_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace xacc {
+
+/**
+ * The AliasSampler draws indices from a discrete probability
+ * distribution with Walker's alias method. Building the table costs
+ * O(N) for N outcomes, after which every draw costs O(1), one random
+ * number and one comparison, so a histogram of S shots costs O(N + S).
+ *
+ * Simulators use it to turn the probabilities of the basis states into
+ * shot counts for AcceleratorBuffer::appendHistogram.
+ */
+class AliasSampler {
+
+public:
+  /**
+   * The constructor, builds the alias table.
+   *
+   * @param weights The non-negative weight of each outcome,
+   * normalized by their sum
+   */
+  AliasSampler(const std::vector<double> &weights);
+
+  /**
+   * Return the number of outcomes.
+   */
+  std::uint64_t size() const { return probability.size(); }
+
+  /**
+   * Draw one outcome.
+   *
+   * @param generator The source of random numbers
+   * @return outcome The index of the outcome
+   */
+  std::uint64_t sample(std::mt19937_64 &generator) const;
+
+  /**
+   * Draw the given number of outcomes and count them.
+   *
+   * @param shots The number of draws
+   * @param generator The source of random numbers
+   * @return counts The number of draws of each outcome
+   */
+  std::vector<int> histogram(const int shots,
+                             std::mt19937_64 &generator) const;
+
+protected:
+  /**
+   * The probability of keeping each column's own outcome.
+   */
+  std::vector<double> probability;
+
+  /**
+   * The outcome each column yields otherwise.
+   */
+  std::vector<std::uint64_t> alias;
+};
+
+} // namespace xacc
+
+#endif
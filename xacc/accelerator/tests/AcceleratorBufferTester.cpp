@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include "AcceleratorBuffer.hpp"
+#include <sstream>
 
 using namespace xacc;
 
@@ -55,6 +56,62 @@ TEST(AcceleratorBufferTester, checkGetExpectationValueZ) {
   EXPECT_TRUE(std::fabs(b.getExpectationValueZ() - 0.178955078125) < 1e-6);
 }
 
+TEST(AcceleratorBufferTester, checkExactExpectationValueZ) {
+  AcceleratorBuffer buffer("qreg", 2);
+  buffer.appendMeasurement("00", 10);
+  EXPECT_FALSE(buffer.hasExactExpectationValueZ());
+  EXPECT_DOUBLE_EQ(1.0, buffer.getExpectationValueZ());
+
+  // The exact value wins over counts, and survives cloning
+  buffer.setExpectationValueZ(-0.25);
+  EXPECT_TRUE(buffer.hasExactExpectationValueZ());
+  EXPECT_DOUBLE_EQ(-0.25, buffer.getExpectationValueZ());
+  auto cloned = buffer.clone();
+  EXPECT_TRUE(cloned->hasExactExpectationValueZ());
+  EXPECT_DOUBLE_EQ(-0.25, cloned->getExpectationValueZ());
+
+  // And persisting, on the buffer and its children
+  auto child = std::make_shared<AcceleratorBuffer>("child", 2);
+  child->appendMeasurement("11", 3);
+  child->setExpectationValueZ(0.5);
+  buffer.appendChild("child", child);
+  buffer.appendChild("counted", std::make_shared<AcceleratorBuffer>("counted", 2));
+  std::stringstream ss;
+  buffer.print(ss);
+  AcceleratorBuffer loaded;
+  loaded.load(ss);
+  EXPECT_DOUBLE_EQ(-0.25, loaded.getExpectationValueZ());
+  auto loadedChild = loaded.getChildren("child")[0];
+  EXPECT_TRUE(loadedChild->hasExactExpectationValueZ());
+  EXPECT_DOUBLE_EQ(0.5, loadedChild->getExpectationValueZ());
+  EXPECT_EQ(3, loadedChild->getMeasurementCounts()["11"]);
+  EXPECT_FALSE(loaded.getChildren("counted")[0]->hasExactExpectationValueZ());
+
+  buffer.resetBuffer();
+  EXPECT_FALSE(buffer.hasExactExpectationValueZ());
+}
+
+TEST(AcceleratorBufferTester, checkBulkAppend) {
+  AcceleratorBuffer buffer("qreg", 3);
+  buffer.appendMeasurement("001");
+  buffer.appendMeasurements({{"001", 2}, {"110", 4}});
+  EXPECT_EQ(3, buffer.getMeasurementCounts()["001"]);
+  EXPECT_EQ(4, buffer.getMeasurementCounts()["110"]);
+
+  // Index 6 is classical bits 1 and 2
+  buffer.appendHistogram({0, 1, 0, 0, 0, 0, 5, 0}, 3);
+  EXPECT_EQ(4, buffer.getMeasurementCounts()["001"]);
+  EXPECT_EQ(9, buffer.getMeasurementCounts()["110"]);
+
+  buffer.clearMeasurements();
+  buffer.appendShots({5, 0, 5, 5, 2}, 4);
+  auto counts = buffer.getMeasurementCounts();
+  EXPECT_EQ(3, counts.size());
+  EXPECT_EQ(3, counts["0101"]);
+  EXPECT_EQ(1, counts["0000"]);
+  EXPECT_EQ(1, counts["0010"]);
+}
+
 TEST(AcceleratorBufferTester, checkLoad) {
   const std::string bufferStr = R"bufferStr({
     "AcceleratorBuffer": {
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ *License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "AliasSampler.hpp"
+#include "AcceleratorBuffer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+using namespace xacc;
+
+TEST(AliasSamplerTester, checkDistribution) {
+  std::mt19937_64 generator(5);
+  AliasSampler sampler({1.0, 0.0, 3.0, 6.0});
+  EXPECT_EQ(4, sampler.size());
+  const int shots = 1000000;
+  auto counts = sampler.histogram(shots, generator);
+  EXPECT_EQ(shots, std::accumulate(counts.begin(), counts.end(), 0));
+  EXPECT_EQ(0, counts[1]);
+  EXPECT_NEAR(0.1, (double)counts[0] / shots, 0.002);
+  EXPECT_NEAR(0.3, (double)counts[2] / shots, 0.002);
+  EXPECT_NEAR(0.6, (double)counts[3] / shots, 0.002);
+
+  // A single certain outcome among many
+  std::vector<double> weights(1024, 0.0);
+  weights[700] = 0.25;
+  AliasSampler certain(weights);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(700, certain.sample(generator));
+  }
+}
+
+TEST(AliasSamplerTester, DISABLED_benchmarkMillionShots) {
+  auto seconds = [](std::function<void()> run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+    return s.count();
+  };
+
+  // Sample 1M shots one at a time into the buffer, as simulators
+  // did, and as a histogram appended in bulk
+  const int shots = 1000000;
+  for (auto nBits : {10, 20}) {
+    std::mt19937_64 generator(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> probabilities(1 << nBits);
+    for (auto &p : probabilities) {
+      p = uniform(generator);
+    }
+
+    AcceleratorBuffer perShot("q", nBits), bulk("q", nBits);
+    auto perShotTime = seconds([&]() {
+      std::vector<double> cumulative(probabilities.size());
+      std::partial_sum(probabilities.begin(), probabilities.end(),
+                       cumulative.begin());
+      for (int shot = 0; shot < shots; shot++) {
+        auto r = uniform(generator) * cumulative.back();
+        std::uint64_t idx =
+            std::upper_bound(cumulative.begin(), cumulative.end(), r) -
+            cumulative.begin();
+        std::string bits(nBits, '0');
+        for (int i = 0; i < nBits; i++) {
+          if ((idx >> i) & 1) {
+            bits[nBits - 1 - i] = '1';
+          }
+        }
+        perShot.appendMeasurement(bits);
+      }
+    });
+    std::vector<int> histogram;
+    auto samplerTime = seconds([&]() {
+      AliasSampler sampler(probabilities);
+      histogram = sampler.histogram(shots, generator);
+    });
+    auto bulkTime =
+        seconds([&]() { bulk.appendHistogram(histogram, nBits); });
+    std::cout << shots << " shots of " << nBits << " bits: per shot "
+              << perShotTime << " s, alias " << samplerTime << " s, bulk "
+              << bulkTime << " s for " << bulk.getMeasurementCounts().size()
+              << " distinct bit strings\n";
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (c) 2018 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ *License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef XACC_COMPILER_COMPILERDECORATOR_HPP_
+#define XACC_COMPILER_COMPILERDECORATOR_HPP_
+
+#include "Compiler.hpp"
+
+namespace xacc {
+
+/**
+ * A CompilerDecorator wraps another Compiler, forwarding to it
+ * everything it does not change itself. Once decorating a Compiler
+ * it takes on its name, description and options, so callers cannot
+ * tell the two apart. Undecorated, as registered with the framework,
+ * it reports its own.
+ */
+class CompilerDecorator : public Compiler {
+protected:
+  std::shared_ptr<Compiler> decoratedCompiler;
+
+  /**
+   * The name, description and options of this
+   * CompilerDecorator itself.
+   */
+  virtual const std::string decoratorName() const = 0;
+  virtual const std::string decoratorDescription() const = 0;
+  virtual OptionPairs decoratorOptions() { return OptionPairs{}; }
+
+public:
+  CompilerDecorator() {}
+  CompilerDecorator(std::shared_ptr<Compiler> c) : decoratedCompiler(c) {}
+  void setDecorated(std::shared_ptr<Compiler> c) { decoratedCompiler = c; }
+
+  std::shared_ptr<IR> compile(const std::string &src,
+                              std::shared_ptr<Accelerator> acc) override {
+    return decoratedCompiler->compile(src, acc);
+  }
+
+  std::shared_ptr<IR> compile(const std::string &src) override {
+    return decoratedCompiler->compile(src);
+  }
+
+  const std::string translate(const std::string &bufferVariable,
+                              std::shared_ptr<Function> function) override {
+    return decoratedCompiler->translate(bufferVariable, function);
+  }
+
+  const std::shared_ptr<Function>
+  compile(std::shared_ptr<Function> f,
+          std::shared_ptr<Accelerator> acc) override {
+    return decoratedCompiler->compile(f, acc);
+  }
+
+  const std::string name() const override {
+    return decoratedCompiler ? decoratedCompiler->name() : decoratorName();
+  }
+
+  const std::string description() const override {
+    return decoratedCompiler ? decoratedCompiler->description()
+                             : decoratorDescription();
+  }
+
+  OptionPairs getOptions() override {
+    return decoratedCompiler ? decoratedCompiler->getOptions()
+                             : decoratorOptions();
+  }
+
+  bool handleOptions(const std::map<std::string, std::string> &arg_map) override {
+    return decoratedCompiler ? decoratedCompiler->handleOptions(arg_map)
+                             : false;
+  }
+
+  /**
+   * The destructor
+   */
+  virtual ~CompilerDecorator() {}
+};
+
+} // namespace xacc
+#endif
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "PassManager.hpp"
+#include "XACC.hpp"
+#include "InstructionIterator.hpp"
+#include <cctype>
+#include <sstream>
+
+namespace xacc {
+
+PassManager::PassManager(const std::string &pipeline) {
+  if (xacc::optionExists("pass-manager-max-iterations")) {
+    maxIterations = std::stoi(xacc::getOption("pass-manager-max-iterations"));
+  }
+  if (xacc::optionExists("pass-manager-budget-ms")) {
+    budget = std::stod(xacc::getOption("pass-manager-budget-ms"));
+  }
+
+  std::size_t pos = 0;
+  stages = parse(pipeline, pos, false);
+  if (stages.empty()) {
+    xacc::error("PassManager: empty pipeline.");
+  }
+}
+
+std::vector<PassManager::Stage>
+PassManager::parse(const std::string &pipeline, std::size_t &pos,
+                   const bool nested) {
+  auto skipSpace = [&]() {
+    while (pos < pipeline.size() && std::isspace(pipeline[pos])) {
+      pos++;
+    }
+  };
+
+  std::vector<Stage> result;
+  skipSpace();
+  while (pos < pipeline.size()) {
+    if (pipeline[pos] == ')') {
+      if (nested) {
+        return result;
+      }
+      xacc::error("PassManager: unbalanced ) in pipeline " + pipeline);
+    }
+
+    Stage stage;
+    if (pipeline[pos] == '(') {
+      pos++;
+      stage.stages = parse(pipeline, pos, true);
+      pos++;
+      skipSpace();
+      if (pos < pipeline.size() && pipeline[pos] == '*') {
+        stage.fixedPoint = true;
+        pos++;
+      }
+    } else {
+      auto first = pos;
+      while (pos < pipeline.size() && pipeline[pos] != ',' &&
+             pipeline[pos] != '(' && pipeline[pos] != ')' &&
+             pipeline[pos] != '*') {
+        pos++;
+      }
+      stage.name = pipeline.substr(first, pos - first);
+      stage.name.erase(stage.name.find_last_not_of(" \t\n") + 1);
+      if (stage.name.empty()) {
+        xacc::error("PassManager: missing pass name in pipeline " + pipeline);
+      }
+      stage.pass = xacc::getIRTransformation(stage.name);
+    }
+    result.push_back(stage);
+
+    skipSpace();
+    if (pos < pipeline.size() && pipeline[pos] == ',') {
+      pos++;
+      skipSpace();
+    } else if (pos < pipeline.size() && pipeline[pos] != ')') {
+      xacc::error("PassManager: unexpected " + pipeline.substr(pos, 1) +
+                  " in pipeline " + pipeline);
+    }
+  }
+
+  if (nested) {
+    xacc::error("PassManager: missing ) in pipeline " + pipeline);
+  }
+  return result;
+}
+
+std::shared_ptr<IR> PassManager::run(std::shared_ptr<IR> ir) {
+  records.clear();
+  start = std::chrono::steady_clock::now();
+  return runStages(stages, ir, 0);
+}
+
+std::shared_ptr<IR> PassManager::runStages(const std::vector<Stage> &stages,
+                                           std::shared_ptr<IR> ir,
+                                           const int iteration) {
+  for (auto &stage : stages) {
+    if (stage.pass) {
+      PassRecord record;
+      record.name = stage.name;
+      record.iteration = iteration;
+      record.gatesBefore = countGates(ir);
+      auto begin = std::chrono::steady_clock::now();
+      ir = stage.pass->transform(ir);
+      record.milliseconds = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - begin)
+                                .count();
+      record.gatesAfter = countGates(ir);
+      records.push_back(record);
+    } else if (!stage.fixedPoint) {
+      ir = runStages(stage.stages, ir, iteration);
+    } else {
+      for (int i = 1;; i++) {
+        auto before = countGates(ir);
+        ir = runStages(stage.stages, ir, i);
+        if (countGates(ir) >= before || i >= maxIterations ||
+            (budget > 0.0 && elapsed() >= budget)) {
+          break;
+        }
+      }
+    }
+  }
+  return ir;
+}
+
+double PassManager::elapsed() const {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int PassManager::countGates(std::shared_ptr<IR> ir) {
+  int count = 0;
+  for (auto &kernel : ir->getKernels()) {
+    for (auto &inst : InstructionRange(kernel, Traversal::EnabledLeaves)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void PassManager::report(std::shared_ptr<AcceleratorBuffer> buffer) {
+  std::vector<std::string> names;
+  std::vector<int> iterations, deltas;
+  std::vector<double> times;
+  for (auto &record : records) {
+    std::stringstream ss;
+    ss << "PassManager: " << record.name;
+    if (record.iteration > 0) {
+      ss << " (iteration " << record.iteration << ")";
+    }
+    ss << " took " << record.milliseconds << " ms, gates "
+       << record.gatesBefore << " -> " << record.gatesAfter;
+    xacc::info(ss.str());
+
+    names.push_back(record.name);
+    iterations.push_back(record.iteration);
+    times.push_back(record.milliseconds);
+    deltas.push_back(record.gatesAfter - record.gatesBefore);
+  }
+
+  if (buffer) {
+    buffer->addExtraInfo("pass-names", ExtraInfo(names));
+    buffer->addExtraInfo("pass-iterations", ExtraInfo(iterations));
+    buffer->addExtraInfo("pass-times", ExtraInfo(times));
+    buffer->addExtraInfo("pass-gate-deltas", ExtraInfo(deltas));
+  }
+}
+
+} // namespace xacc
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef XACC_COMPILER_PASSMANAGER_HPP_
+#define XACC_COMPILER_PASSMANAGER_HPP_
+
+#include "IRTransformation.hpp"
+#include <chrono>
+
+namespace xacc {
+
+class AcceleratorBuffer;
+
+/**
+ * The cost and effect of one run of one pass.
+ */
+struct PassRecord {
+  std::string name;
+  // The fixed-point iteration this run belongs to, 0 outside of one
+  int iteration = 0;
+  double milliseconds = 0.0;
+  int gatesBefore = 0;
+  int gatesAfter = 0;
+};
+
+/**
+ * The PassManager runs a pipeline of IRTransformations, given
+ * as a string of service names separated by commas. A group of
+ * passes in parentheses followed by * is run repeatedly until an
+ * iteration no longer reduces the gate count, for example
+ *
+ *   (circuit-optimizer, my-pass)*, my-final-pass
+ *
+ * Fixed-point groups stop early when the iteration limit or the
+ * time budget is reached, but always run at least once. They default
+ * to the pass-manager-max-iterations and pass-manager-budget-ms
+ * runtime options when set, 10 iterations and no time limit otherwise.
+ *
+ * Every pass run is timed and its change in the number of enabled
+ * gates recorded, see getRecords() and report().
+ */
+class PassManager {
+
+public:
+  /**
+   * Parse the given pipeline and look up its passes.
+   *
+   * @param pipeline The pipeline description
+   */
+  PassManager(const std::string &pipeline);
+
+  /**
+   * Run the pipeline on the given IR.
+   *
+   * @param ir The IR to transform
+   * @return newIr The transformed IR
+   */
+  std::shared_ptr<IR> run(std::shared_ptr<IR> ir);
+
+  /**
+   * Set the maximum number of iterations of a fixed-point group.
+   */
+  void setMaxIterations(const int max) { maxIterations = max; }
+
+  /**
+   * Set the wall time after which fixed-point groups stop
+   * iterating, for the whole pipeline. Zero means no limit.
+   */
+  void setBudget(const double milliseconds) { budget = milliseconds; }
+
+  /**
+   * Return the records of the last run, in execution order.
+   */
+  const std::vector<PassRecord> &getRecords() const { return records; }
+
+  /**
+   * Log the records of the last run, and add them to the
+   * buffer as pass-names, pass-iterations, pass-times (ms) and
+   * pass-gate-deltas if one is given.
+   *
+   * @param buffer The buffer to add the records to, may be null
+   */
+  void report(std::shared_ptr<AcceleratorBuffer> buffer = nullptr);
+
+  /**
+   * Return the number of enabled gates in all kernels of the IR.
+   */
+  static int countGates(std::shared_ptr<IR> ir);
+
+protected:
+  // A pass, or a group of stages run in order
+  struct Stage {
+    std::shared_ptr<IRTransformation> pass;
+    std::string name;
+    std::vector<Stage> stages;
+    bool fixedPoint = false;
+  };
+
+  std::vector<Stage> parse(const std::string &pipeline, std::size_t &pos,
+                           const bool nested);
+
+  std::shared_ptr<IR> runStages(const std::vector<Stage> &stages,
+                                std::shared_ptr<IR> ir, const int iteration);
+
+  double elapsed() const;
+
+  std::vector<Stage> stages;
+  int maxIterations = 10;
+  double budget = 0.0;
+
+  std::vector<PassRecord> records;
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace xacc
+#endif
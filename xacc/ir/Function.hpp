@@ -13,7 +13,7 @@
 #ifndef XACC_IR_FUNCTION_HPP_
 #define XACC_IR_FUNCTION_HPP_
 
-#include <list>
+#include <vector>
 
 #include "Graph.hpp"
 #include "Instruction.hpp"
@@ -57,7 +57,9 @@ public:
   }
 
   /**
-   * Return the Instruction at the given index.
+   * Return the Instruction at the given index. Implementations
+   * store their Instructions contiguously, so this is a constant
+   * time lookup.
    *
    * @param idx The desired Instruction index
    * @return inst The instruction at the given index.
@@ -69,7 +71,16 @@ public:
    *
    * @return insts The list of this Function's Instructions
    */
-  virtual std::list<InstPtr> getInstructions() = 0;
+  virtual std::vector<InstPtr> getInstructions() = 0;
+
+  /**
+   * Return a pointer to this Function's Instructions if they are
+   * stored contiguously, or nullptr otherwise. The pointer is
+   * invalidated by any edit to this Function.
+   *
+   * @return data The first of nInstructions() Instructions
+   */
+  virtual const InstPtr *instructionData() { return nullptr; }
 
   /**
    * Remove the Instruction at the given index.
@@ -155,6 +166,18 @@ public:
    */
   virtual std::shared_ptr<Function> enabledView() = 0;
 
+  /**
+   * Remove all disabled Instructions from this Function in place.
+   * Subclasses should override this with a single linear pass.
+   */
+  virtual void removeDisabled() {
+    for (int i = nInstructions() - 1; i >= 0; i--) {
+      if (!getInstruction(i)->isEnabled()) {
+        removeInstruction(i);
+      }
+    }
+  }
+
   /**
    * Evaluate this parameterized function at the
    * given concrete parameters.
@@ -164,12 +187,100 @@ public:
   virtual std::shared_ptr<Function>
   operator()(const std::vector<double> &params) = 0;
 
+  /**
+   * Evaluate this parameterized function at each of the
+   * given parameter sets, one evaluated Function per set.
+   * Subclasses may share non-parameterized Instructions
+   * across the returned Functions.
+   *
+   * @param paramSets The parameter sets, one per row
+   * @return evaluated The evaluated Functions
+   */
+  virtual std::vector<std::shared_ptr<Function>>
+  evaluateBatch(const std::vector<std::vector<double>> &paramSets) {
+    std::vector<std::shared_ptr<Function>> evaluated;
+    evaluated.reserve(paramSets.size());
+    for (auto &params : paramSets) {
+      evaluated.push_back(operator()(params));
+    }
+    return evaluated;
+  }
+
   virtual std::shared_ptr<Graph> toGraph() = 0;
 
+  /**
+   * Return a structural hash of this Function, combining the hashes
+   * of its Instructions, in order, with its parameters. The Function
+   * name is left out, so Functions with the same body hash the same.
+   * The combined Instruction hashes are cached until this Function,
+   * or an Instruction nested in it, makes a hash-changing edit.
+   *
+   * @return hash The 64 bit structural hash
+   */
+  const std::uint64_t hash() override {
+    if (!hashValid) {
+      StructuralHash h;
+      hashHeader(h);
+      auto data = instructionData();
+      for (int i = 0; i < nInstructions(); i++) {
+        h.add(data ? data[i]->hash() : getInstruction(i)->hash());
+      }
+      hashState = h.state();
+      hashValid = true;
+    }
+
+    StructuralHash h(hashState);
+    auto params = getParameters();
+    for (auto &p : params) {
+      h.add(p);
+    }
+    h.add(static_cast<std::uint64_t>(params.size()));
+    h.add(static_cast<std::uint64_t>(nInstructions()));
+    return h.value();
+  }
+
+  void childModified() override { modified(); }
+
   /**
    * The destructor
    */
   virtual ~Function() {}
+
+protected:
+  /**
+   * The running hash of the Instructions, valid while hashValid is set.
+   */
+  std::uint64_t hashState = 0;
+  bool hashValid = false;
+
+  /**
+   * Record a hash-changing edit of this Function. Subclasses call
+   * this from their mutators, and override it to drop anything
+   * else they cache about their contents.
+   */
+  virtual void modified() {
+    hashValid = false;
+    notifyParents();
+  }
+
+  /**
+   * Fold anything besides the Instructions and parameters
+   * that sets this Function apart into its hash.
+   *
+   * @param h The hash to fold into
+   */
+  virtual void hashHeader(StructuralHash &h) {}
+
+  /**
+   * Extend the cached hash with an appended Instruction.
+   * Call only if the cache was valid before the append.
+   *
+   * @param inst The appended Instruction
+   */
+  void appendToHash(InstPtr inst) {
+    hashState = StructuralHash(hashState).add(inst->hash()).state();
+    hashValid = true;
+  }
 };
 
 } // namespace xacc
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "Instruction.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace xacc {
+
+namespace {
+
+// Guard the parent links. Instructions hash onto a fixed set of
+// locks instead of carrying one each.
+const int nStripes = 64;
+
+std::mutex &stripe(const Instruction *inst) {
+  static std::mutex stripes[nStripes];
+  return stripes[(reinterpret_cast<std::uintptr_t>(inst) >> 4) % nStripes];
+}
+
+// The parents of Instructions held by more than one composite,
+// those Instructions point their parent at manyParents. Its lock
+// is taken after an Instruction's stripe, never before.
+std::mutex tableLock;
+
+std::unordered_map<const Instruction *, std::vector<Instruction *>> &
+sharedParents() {
+  // Built on first use and never destroyed, Instructions may
+  // live through static initialization and destruction
+  static auto table =
+      new std::unordered_map<const Instruction *, std::vector<Instruction *>>;
+  return *table;
+}
+
+char manyParentsTag;
+Instruction *const manyParents =
+    reinterpret_cast<Instruction *>(&manyParentsTag);
+
+} // namespace
+
+void Instruction::attach(Instruction *p) {
+  std::lock_guard<std::mutex> lock(stripe(this));
+  if (!parent) {
+    parent = p;
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(tableLock);
+  auto &parents = sharedParents()[this];
+  if (parent != manyParents) {
+    parents.push_back(parent);
+    parent = manyParents;
+  }
+  parents.push_back(p);
+}
+
+void Instruction::detach(Instruction *p) {
+  std::lock_guard<std::mutex> lock(stripe(this));
+  if (parent == p) {
+    parent = nullptr;
+    return;
+  }
+  if (parent != manyParents) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(tableLock);
+  auto &table = sharedParents();
+  auto entry = table.find(this);
+  if (entry == table.end()) {
+    return;
+  }
+  auto &parents = entry->second;
+  auto it = std::find(parents.begin(), parents.end(), p);
+  if (it != parents.end()) {
+    parents.erase(it);
+  }
+  if (parents.size() == 1) {
+    parent = parents.front();
+    table.erase(entry);
+  }
+}
+
+void Instruction::notifyParents() {
+  Instruction *single;
+  std::vector<Instruction *> parents;
+  {
+    // Call out without holding any lock, parents notify their own
+    std::lock_guard<std::mutex> lock(stripe(this));
+    single = parent;
+    if (single == manyParents) {
+      std::lock_guard<std::mutex> guard(tableLock);
+      parents = sharedParents()[this];
+    }
+  }
+
+  if (single != manyParents) {
+    if (single) {
+      single->childModified();
+    }
+    return;
+  }
+  for (auto p : parents) {
+    p->childModified();
+  }
+}
+
+Instruction::~Instruction() {
+  if (parent == manyParents) {
+    std::lock_guard<std::mutex> guard(tableLock);
+    sharedParents().erase(this);
+  }
+}
+
+} // namespace xacc
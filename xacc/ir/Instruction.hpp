@@ -16,6 +16,7 @@
 
 #include "InstructionVisitor.hpp"
 #include "InstructionParameter.hpp"
+#include "StructuralHash.hpp"
 
 namespace xacc {
 
@@ -37,6 +38,15 @@ namespace xacc {
 class Instruction : public BaseInstructionVisitable, public Identifiable {
 
 public:
+  Instruction() {}
+
+  /**
+   * Copies start out held by no composite Instruction.
+   */
+  Instruction(const Instruction &other)
+      : BaseInstructionVisitable(other), Identifiable(other) {}
+  Instruction &operator=(const Instruction &other) { return *this; }
+
   /**
    * Persist this Instruction to an assembly-like
    * string with a given bit buffer variable name.
@@ -180,13 +190,73 @@ public:
     /* do nothing at this level */
   }
 
+  /**
+   * Return a structural hash of this Instruction, covering its
+   * name, bits, parameters and enabled state. Instructions that
+   * are structurally equal hash the same, across runs and processes.
+   *
+   * @return hash The 64 bit structural hash
+   */
+  virtual const std::uint64_t hash() {
+    StructuralHash h;
+    h.add(name()).add(bits());
+    auto params = getParameters();
+    h.add(static_cast<std::uint64_t>(params.size()));
+    for (auto &p : params) {
+      h.add(p);
+    }
+    h.add(isEnabled() ? 1 : 0);
+    return h.value();
+  }
+
   virtual const bool isAnalog() const { return false; }
   virtual const int nRequiredBits() const = 0;
 
+  /**
+   * Record that the given composite Instruction holds this one.
+   * Composites attach themselves once per add and detach once
+   * per removal, so a parent holding this Instruction twice is
+   * attached twice.
+   *
+   * @param parent The composite holding this Instruction
+   */
+  void attach(Instruction *parent);
+
+  /**
+   * Record that the given composite Instruction let go of this one.
+   *
+   * @param parent The composite no longer holding this Instruction
+   */
+  void detach(Instruction *parent);
+
+  /**
+   * Called on a composite Instruction when an Instruction it
+   * holds, directly or nested, made a hash-changing edit.
+   * Composites drop anything they cache about their contents
+   * here before passing the edit on to their own parents.
+   */
+  virtual void childModified() { notifyParents(); }
+
   /**
    * The destructor
    */
-  virtual ~Instruction() {}
+  virtual ~Instruction();
+
+protected:
+  /**
+   * The composite Instruction holding this one. Most Instructions
+   * have at most one, those with more keep them in a table shared
+   * by all Instructions, so that each pays for a single pointer.
+   * Like other edits of a composite, edits of the Instructions it
+   * holds must not race with its destruction.
+   */
+  Instruction *parent = nullptr;
+
+  /**
+   * Tell every composite holding this Instruction that it made
+   * a hash-changing edit. Mutators call this after the edit.
+   */
+  void notifyParents();
 };
 
 } // namespace xacc
@@ -13,6 +13,8 @@
 #ifndef XACC_COMPILER_INSTRUCTIONITERATOR_HPP_
 #define XACC_COMPILER_INSTRUCTIONITERATOR_HPP_
 #include <stack>
+#include <algorithm>
+#include <iterator>
 #include "Function.hpp"
 
 namespace xacc {
@@ -67,5 +69,196 @@ public:
     return next;
   }
 };
+
+/**
+ * Filters for InstructionRange. Enabled skips disabled Instructions,
+ * along with everything a disabled Function contains. Leaves skips
+ * the composite Instructions themselves but still visits their children.
+ * Children only visits the direct children of the root.
+ */
+enum class Traversal : int {
+  All = 0,
+  Enabled = 1,
+  Leaves = 2,
+  EnabledLeaves = 3,
+  Children = 4,
+  EnabledChildren = 5
+};
+
+/**
+ * InstructionRange walks the Instruction tree under a Function in the
+ * same depth-first order as InstructionIterator, but allocates nothing
+ * per Instruction. It reads the Instructions of Functions that store
+ * them contiguously in place, and only copies an InstPtr for other
+ * Functions. The root Function itself is not visited.
+ *
+ * for (auto &inst : InstructionRange(function, Traversal::EnabledLeaves)) {
+ *   inst->accept(visitor);
+ * }
+ *
+ * The tree must not be edited while it is being traversed.
+ */
+class InstructionRange {
+
+public:
+  class iterator {
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = InstPtr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const InstPtr *;
+    using reference = const InstPtr &;
+
+    /**
+     * The end iterator.
+     */
+    iterator() {}
+
+    iterator(Function *root, Traversal filter)
+        : enabledOnly(static_cast<int>(filter) & 1),
+          leavesOnly(static_cast<int>(filter) & 2),
+          childrenOnly(static_cast<int>(filter) & 4) {
+      push(root);
+      advance();
+    }
+
+    iterator(const iterator &other) { *this = other; }
+
+    iterator &operator=(const iterator &other) {
+      std::copy(other.frames, other.frames + MaxFrames, frames);
+      deepFrames = other.deepFrames;
+      depth = other.depth;
+      held = other.held;
+      current = other.current == &other.held ? &held : other.current;
+      enabledOnly = other.enabledOnly;
+      leavesOnly = other.leavesOnly;
+      childrenOnly = other.childrenOnly;
+      return *this;
+    }
+
+    reference operator*() const { return *current; }
+    Instruction *operator->() const { return current->get(); }
+
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const {
+      return current == other.current;
+    }
+    bool operator!=(const iterator &other) const {
+      return current != other.current;
+    }
+
+  protected:
+    struct Frame {
+      Function *function;
+      // Null if the Function does not store its Instructions contiguously
+      const InstPtr *data;
+      int index;
+      int size;
+    };
+
+    // Functions nested deeper than this spill onto the heap
+    static constexpr int MaxFrames = 16;
+
+    Frame &frame(const int d) {
+      return d < MaxFrames ? frames[d] : deepFrames[d - MaxFrames];
+    }
+
+    void push(Function *function) {
+      Frame f{function, function->instructionData(), 0,
+              function->nInstructions()};
+      if (++depth < MaxFrames) {
+        frames[depth] = f;
+      } else {
+        deepFrames.push_back(f);
+      }
+    }
+
+    void pop() {
+      if (depth-- >= MaxFrames) {
+        deepFrames.pop_back();
+      }
+    }
+
+    void advance() {
+      while (depth >= 0) {
+        auto &f = frame(depth);
+        if (f.index == f.size) {
+          pop();
+          continue;
+        }
+
+        const InstPtr *next = &held;
+        if (f.data) {
+          next = f.data + f.index;
+        } else {
+          held = f.function->getInstruction(f.index);
+        }
+        f.index++;
+
+        auto inst = next->get();
+        if (enabledOnly && !inst->isEnabled()) {
+          continue;
+        }
+        auto function = inst->isComposite() && !childrenOnly
+                            ? dynamic_cast<Function *>(inst)
+                            : nullptr;
+        if (function) {
+          push(function);
+          if (leavesOnly) {
+            continue;
+          }
+        }
+        current = next;
+        return;
+      }
+      current = nullptr;
+    }
+
+    Frame frames[MaxFrames];
+    std::vector<Frame> deepFrames;
+    int depth = -1;
+
+    InstPtr held;
+    const InstPtr *current = nullptr;
+
+    bool enabledOnly = false;
+    bool leavesOnly = false;
+    bool childrenOnly = false;
+  };
+
+  /**
+   * The constructor, takes the root of the tree
+   * and the Instructions to visit.
+   *
+   * @param r The root Function
+   * @param f The traversal filter
+   */
+  InstructionRange(std::shared_ptr<Function> r,
+                   Traversal f = Traversal::All)
+      : owner(r), root(r.get()), filter(f) {}
+
+  /**
+   * Construct a range that does not keep the root alive.
+   *
+   * @param r The root Function
+   * @param f The traversal filter
+   */
+  InstructionRange(Function *r, Traversal f = Traversal::All)
+      : root(r), filter(f) {}
+
+  iterator begin() const { return iterator(root, filter); }
+  iterator end() const { return iterator(); }
+
+protected:
+  std::shared_ptr<Function> owner;
+  Function *root;
+  Traversal filter;
+};
+
 } // namespace xacc
 #endif
@@ -41,13 +41,27 @@ private:
     }
   };
 
-  std::map<int, std::string> whichType{{0,"int"}, {1,"double"},
-                                        {2,"string"}, {3,"complex"},
-                                        {4,"vector<pair<int>>"},
-                                        {5,"vector<pair<double>>"},
-                                        {6,"vector<int>"},
-                                        {7,"vector<double>"},
-                                        {8,"vector<string>"}};
+  const mpark::variant<Types...> &base() const { return *this; }
+
+  // The type names by index, shared by all instances
+  static const char *typeName(const int idx) {
+    static const char *names[] = {"int",
+                                  "double",
+                                  "string",
+                                  "complex",
+                                  "vector<pair<int>>",
+                                  "vector<pair<double>>",
+                                  "vector<int>",
+                                  "vector<double>",
+                                  "vector<string>"};
+    return idx < sizeof(names) / sizeof(names[0]) ? names[idx] : "unknown";
+  }
+
+  double numericValue() const {
+    auto i = mpark::get_if<int>(&base());
+    return i ? *i : *mpark::get_if<double>(&base());
+  }
+
 public:
   Variant() : mpark::variant<Types...>() {}
   template <typename T>
@@ -57,17 +71,18 @@ public:
   Variant(const Variant &element) : mpark::variant<Types...>(element) {}
 
   template <typename T> T as() const {
-    try {
-      // First off just try to get it
-      return mpark::get<T>(*this);
-    } catch (std::exception &e) {
-        std::stringstream s;
-        s << "This InstructionParameter type id is " << this->which() << "\nAllowed Ids to Type\n";
-        for (auto& kv : whichType) {
-            s << kv.first << ": " << kv.second << "\n";
-        }
-        XACCLogger::instance()->error("Cannot cast Variant:\n" + s.str());
+    auto value = mpark::get_if<T>(&base());
+    if (value) {
+      return *value;
     }
+
+    std::stringstream s;
+    s << "This InstructionParameter type id is " << this->which()
+      << "\nAllowed Ids to Type\n";
+    for (int i = 0; i < sizeof...(Types); i++) {
+      s << i << ": " << typeName(i) << "\n";
+    }
+    XACCLogger::instance()->error("Cannot cast Variant:\n" + s.str());
     return T();
   }
   int which() const {
@@ -79,20 +94,10 @@ public:
   }
 
   bool isComplex() const {
-      try {
-          mpark::get<std::complex<double>>(*this);
-      } catch(std::exception& e) {
-          return false;
-      }
-      return true;
+    return mpark::holds_alternative<std::complex<double>>(*this);
   }
   bool isVariable() const {
-    try {
-      mpark::get<std::string>(*this);
-    } catch (std::exception &e) {
-      return false;
-    }
-    return true;
+    return mpark::holds_alternative<std::string>(*this);
   }
 
   const std::string toString() const {
@@ -101,7 +106,11 @@ public:
   }
 
   bool operator==(const Variant<Types...> &v) const {
-    return v.toString() == toString();
+    if (this->index() == v.index()) {
+      return base() == v.base();
+    }
+    // ints and doubles compare by value
+    return isNumeric() && v.isNumeric() && numericValue() == v.numericValue();
   }
 
   bool operator!=(const Variant<Types...> &v) const { return !operator==(v); }
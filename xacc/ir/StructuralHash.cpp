@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "StructuralHash.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace xacc {
+
+namespace {
+
+// Folds each InstructionParameter alternative into a StructuralHash
+class ParameterHasher {
+public:
+  StructuralHash &h;
+  ParameterHasher(StructuralHash &hash) : h(hash) {}
+
+  void operator()(const int &i) { h.add(static_cast<double>(i)); }
+  void operator()(const double &d) { h.add(d); }
+  void operator()(const std::string &s) { h.add(s); }
+  void operator()(const std::complex<double> &c) {
+    h.add(c.real()).add(c.imag());
+  }
+  template <typename T> void operator()(const std::vector<T> &v) {
+    h.add(static_cast<std::uint64_t>(v.size()));
+    for (auto &e : v) {
+      (*this)(e);
+    }
+  }
+  template <typename T> void operator()(const std::pair<T, T> &p) {
+    (*this)(p.first);
+    (*this)(p.second);
+  }
+};
+
+} // namespace
+
+StructuralHash &StructuralHash::add(const double value) {
+  std::uint64_t bits;
+  if (value == 0.0) {
+    bits = 0;
+  } else if (std::isnan(value)) {
+    bits = 0x7ff8000000000000ULL;
+  } else {
+    std::memcpy(&bits, &value, sizeof(bits));
+  }
+  return add(bits);
+}
+
+StructuralHash &StructuralHash::add(const std::string &value) {
+  add(static_cast<std::uint64_t>(value.size()));
+  // Assemble little-endian words so the hash does not
+  // depend on the byte order of the host
+  for (std::size_t i = 0; i < value.size(); i += 8) {
+    std::uint64_t word = 0;
+    for (std::size_t j = i; j < value.size() && j < i + 8; j++) {
+      word |= static_cast<std::uint64_t>(static_cast<unsigned char>(value[j]))
+              << (8 * (j - i));
+    }
+    add(word);
+  }
+  return *this;
+}
+
+StructuralHash &StructuralHash::add(const std::vector<int> &values) {
+  add(static_cast<std::uint64_t>(values.size()));
+  for (auto v : values) {
+    add(v);
+  }
+  return *this;
+}
+
+StructuralHash &StructuralHash::add(const InstructionParameter &param) {
+  // Ints and doubles share a tag, as they compare by value
+  add(param.isNumeric() ? 1 : param.which());
+  ParameterHasher hasher(*this);
+  mpark::visit(hasher, param);
+  return *this;
+}
+
+} // namespace xacc
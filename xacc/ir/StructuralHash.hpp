@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef XACC_IR_STRUCTURALHASH_HPP_
+#define XACC_IR_STRUCTURALHASH_HPP_
+
+#include <cstdint>
+#include "InstructionParameter.hpp"
+
+namespace xacc {
+
+/**
+ * StructuralHash accumulates an order-dependent 64 bit hash of
+ * IR structure. Values are folded in with a fixed mixing function,
+ * so a hash is the same across runs, processes and platforms and
+ * can be persisted. Ints and doubles that compare equal as
+ * InstructionParameters hash the same, as do 0.0 and -0.0.
+ */
+class StructuralHash {
+
+protected:
+  std::uint64_t h;
+
+public:
+  /**
+   * Start a new hash, or resume one from a previous state().
+   *
+   * @param state The state to resume from
+   */
+  StructuralHash(const std::uint64_t state = 0x6a09e667f3bcc909ULL)
+      : h(state) {}
+
+  /**
+   * Fold the given value into the hash.
+   *
+   * @param value The value to fold in
+   * @return hash This StructuralHash
+   */
+  StructuralHash &add(const std::uint64_t value) {
+    h = mix(h ^ mix(value + 0x9e3779b97f4a7c15ULL));
+    return *this;
+  }
+  StructuralHash &add(const int value) {
+    return add(static_cast<std::uint64_t>(static_cast<std::int64_t>(value)));
+  }
+  StructuralHash &add(const double value);
+  StructuralHash &add(const std::string &value);
+  StructuralHash &add(const std::vector<int> &values);
+  StructuralHash &add(const InstructionParameter &param);
+
+  /**
+   * Return the running state, which can be resumed
+   * with further values.
+   *
+   * @return state The running state
+   */
+  std::uint64_t state() const { return h; }
+
+  /**
+   * Return the finished hash value.
+   *
+   * @return hash The hash of all values folded in
+   */
+  std::uint64_t value() const { return mix(h ^ 0xbb67ae8584caa73bULL); }
+
+  /**
+   * The splitmix64 finalizer.
+   */
+  static std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+};
+
+} // namespace xacc
+#endif
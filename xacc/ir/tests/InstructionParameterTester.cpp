@@ -58,6 +58,27 @@ TEST(InstructionParameterTester, checkMap) {
 
 }
 
+TEST(InstructionParameterTester, checkEquality) {
+
+  EXPECT_TRUE(InstructionParameter("theta") == InstructionParameter("theta"));
+  EXPECT_FALSE(InstructionParameter("theta") == InstructionParameter("phi"));
+  EXPECT_TRUE(InstructionParameter(2) == InstructionParameter(2));
+  EXPECT_TRUE(InstructionParameter(2) == InstructionParameter(2.0));
+  EXPECT_TRUE(InstructionParameter(2.0) != InstructionParameter(2.5));
+
+  // Values are compared exactly, not through their printed form
+  EXPECT_TRUE(InstructionParameter(3.14159) != InstructionParameter(3.1415926));
+
+  // Different non-numeric types never compare equal
+  EXPECT_TRUE(InstructionParameter("1") != InstructionParameter(1));
+  EXPECT_TRUE(InstructionParameter(std::vector<int>{1, 2}) ==
+              InstructionParameter(std::vector<int>{1, 2}));
+  EXPECT_TRUE(InstructionParameter(std::vector<int>{1, 2}) !=
+              InstructionParameter(std::vector<double>{1, 2}));
+  EXPECT_TRUE(InstructionParameter(std::complex<double>(1, 2)) ==
+              InstructionParameter(std::complex<double>(1, 2)));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
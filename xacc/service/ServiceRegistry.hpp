@@ -29,6 +29,7 @@
 #include <cppmicroservices/BundleImport.h>
 
 #include <map>
+#include <mutex>
 #include <dirent.h>
 
 using namespace cppmicroservices;
@@ -58,6 +59,12 @@ protected:
 
   std::string rootPathStr = "";
 
+  /**
+   * Serializes service lookups, which may come from
+   * IRTransformations running on several threads.
+   */
+  std::recursive_mutex lookupMutex;
+
 public:
   ServiceRegistry() : framework(FrameworkFactory().NewFramework()) {}
   const std::string getRootPathString() { return rootPathStr; }
@@ -65,6 +72,7 @@ public:
   void initialize(const std::string rootPath);
   
   template <typename ServiceInterface> bool hasService(const std::string name) {
+    std::lock_guard<std::recursive_mutex> lock(lookupMutex);
     auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
     for (auto s : allServiceRefs) {
       auto service = context.GetService(s);
@@ -79,24 +87,33 @@ public:
 
   template <typename ServiceInterface>
   std::shared_ptr<ServiceInterface> getService(const std::string name) {
-    std::shared_ptr<ServiceInterface> ret;
-    auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
-    for (auto s : allServiceRefs) {
-      auto service = context.GetService(s);
-      auto identifiable =
-          std::dynamic_pointer_cast<xacc::Identifiable>(service);
-      if (identifiable && identifiable->name() == name) {
-        auto checkCloneable =
-            std::dynamic_pointer_cast<xacc::Cloneable<ServiceInterface>>(
-                service);
-        if (checkCloneable) {
-          ret = checkCloneable->clone();
-        } else {
-          ret = service;
+    std::shared_ptr<ServiceInterface> service;
+    {
+      std::lock_guard<std::recursive_mutex> lock(lookupMutex);
+      auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
+      for (auto s : allServiceRefs) {
+        auto candidate = context.GetService(s);
+        auto identifiable =
+            std::dynamic_pointer_cast<xacc::Identifiable>(candidate);
+        if (identifiable && identifiable->name() == name) {
+          service = candidate;
         }
       }
     }
 
+    // Clone outside of the lock, clones may look up services
+    std::shared_ptr<ServiceInterface> ret;
+    if (service) {
+      auto checkCloneable =
+          std::dynamic_pointer_cast<xacc::Cloneable<ServiceInterface>>(
+              service);
+      if (checkCloneable) {
+        ret = checkCloneable->clone();
+      } else {
+        ret = service;
+      }
+    }
+
     if (!ret) {
       XACCLogger::instance()->error("Could not find service with name " + name +
                                     ". "
@@ -109,6 +126,7 @@ public:
   template <typename ServiceInterface>
   std::vector<std::shared_ptr<ServiceInterface>> getServices() {
     std::vector<std::shared_ptr<ServiceInterface>> services;
+    std::lock_guard<std::recursive_mutex> lock(lookupMutex);
     auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
     for (auto s : allServiceRefs) {
       services.push_back(context.GetService(s));
@@ -120,6 +138,7 @@ public:
   template <typename ServiceInterface>
   std::vector<std::string> getRegisteredIds() {
     std::vector<std::string> ids;
+    std::lock_guard<std::recursive_mutex> lock(lookupMutex);
     auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
     for (auto s : allServiceRefs) {
       auto service = context.GetService(s);
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include <gtest/gtest.h>
+#include "ThreadPool.hpp"
+#include "RuntimeOptions.hpp"
+#include <stdexcept>
+
+using namespace xacc;
+
+TEST(ThreadPoolTester, checkParallelFor) {
+  ThreadPool pool(4);
+  EXPECT_EQ(4, pool.size());
+
+  std::vector<int> out(10000, 0);
+  pool.parallelFor(out.size(), [&](const int i) { out[i] = 2 * i; });
+  for (int i = 0; i < out.size(); i++) {
+    EXPECT_EQ(2 * i, out[i]);
+  }
+
+  // Nested loops complete even with every worker busy
+  std::atomic<int> count(0);
+  pool.parallelFor(8, [&](const int) {
+    pool.parallelFor(100, [&](const int) { count++; });
+  });
+  EXPECT_EQ(800, count.load());
+}
+
+TEST(ThreadPoolTester, checkSerial) {
+  ThreadPool pool(1);
+  std::vector<int> order;
+  pool.parallelFor(5, [&](const int i) { order.push_back(i); });
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), order);
+}
+
+TEST(ThreadPoolTester, checkException) {
+  ThreadPool pool(3);
+  std::atomic<int> count(0);
+  EXPECT_THROW(pool.parallelFor(50,
+                                [&](const int i) {
+                                  count++;
+                                  if (i == 7) {
+                                    throw std::runtime_error("bad kernel");
+                                  }
+                                }),
+               std::runtime_error);
+  // The other iterations still ran
+  EXPECT_EQ(50, count.load());
+}
+
+TEST(ThreadPoolTester, checkShared) {
+  auto options = RuntimeOptions::instance();
+  (*options)["transformation-threads"] = "2";
+  auto pool = ThreadPool::shared();
+  EXPECT_EQ(2, pool->size());
+  EXPECT_TRUE(pool == ThreadPool::shared());
+
+  // Later changes to the option take effect
+  (*options)["transformation-threads"] = "3";
+  EXPECT_EQ(3, ThreadPool::shared()->size());
+  options->erase("transformation-threads");
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
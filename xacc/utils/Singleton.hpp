@@ -13,6 +13,9 @@
 #ifndef XACC_UTILS_SINGLETON_HPP_
 #define XACC_UTILS_SINGLETON_HPP_
 
+#include <atomic>
+#include <mutex>
+
 namespace xacc {
 
 /**
@@ -24,29 +27,42 @@ namespace xacc {
 template <class T> class Singleton {
 public:
   /**
-   * Return the single instance of T
+   * Return the single instance of T, creating it on first
+   * use. Safe to call from multiple threads.
+   *
    * @return instance The singleton instance
    */
   static T *instance() {
-    if (!instance_) {
-      instance_ = new T();
+    auto instance = instance_.load(std::memory_order_acquire);
+    if (!instance) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      instance = instance_.load(std::memory_order_relaxed);
+      if (!instance) {
+        instance = new T();
+        instance_.store(instance, std::memory_order_release);
+      }
     }
-    return instance_;
+    return instance;
   }
 
   /**
    * Destroy the single instance of T
    */
   static void destroy() {
-    delete instance_;
-    instance_ = nullptr;
+    std::lock_guard<std::mutex> lock(mutex_);
+    delete instance_.exchange(nullptr);
   }
 
 protected:
   /**
    * Reference to the single T instance
    */
-  static T *instance_;
+  static std::atomic<T *> instance_;
+
+  /**
+   * Serializes creation and destruction of the instance
+   */
+  static std::mutex mutex_;
 
   /**
    * constructor
@@ -59,7 +75,8 @@ protected:
   virtual ~Singleton() {}
 };
 
-template <class T> T *Singleton<T>::instance_ = nullptr;
+template <class T> std::atomic<T *> Singleton<T>::instance_(nullptr);
+template <class T> std::mutex Singleton<T>::mutex_;
 
 } // namespace xacc
 
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#include "ThreadPool.hpp"
+#include "RuntimeOptions.hpp"
+#include <algorithm>
+#include <string>
+
+namespace xacc {
+
+ThreadPool::ThreadPool(const int nThreads) {
+  for (int i = 1; i < nThreads; i++) {
+    workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::shared() {
+  static std::mutex lock;
+  static std::shared_ptr<ThreadPool> pool;
+
+  auto options = RuntimeOptions::instance();
+  auto nThreads = std::max(1, (int)std::thread::hardware_concurrency());
+  if (options->exists("transformation-threads")) {
+    nThreads = std::max(1, std::stoi((*options)["transformation-threads"]));
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (!pool || pool->size() != nThreads) {
+    // Loops still running on the previous pool keep it alive
+    pool = std::make_shared<ThreadPool>(nThreads);
+  }
+  return pool;
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+      if (jobs.empty()) {
+        return;
+      }
+      job = jobs.front();
+    }
+
+    while (runNext(*job)) {
+    }
+
+    // Every iteration has been handed out, stop offering the job
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+  }
+}
+
+bool ThreadPool::runNext(Job &job) {
+  auto i = job.next++;
+  if (i >= job.n) {
+    return false;
+  }
+
+  try {
+    (*job.body)(i);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(job.errorMutex);
+    if (!job.error) {
+      job.error = std::current_exception();
+    }
+  }
+
+  if (++job.done == job.n) {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished.notify_all();
+  }
+  return true;
+}
+
+void ThreadPool::parallelFor(const int n,
+                             const std::function<void(const int)> &body) {
+  if (workers.empty() || n < 2) {
+    for (int i = 0; i < n; i++) {
+      body(i);
+    }
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->body = &body;
+  job->n = n;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(job);
+  }
+  wake.notify_all();
+
+  while (runNext(*job)) {
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return job->done == n; });
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+  }
+
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+
+} // namespace xacc
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (c) 2017 UT-Battelle, LLC.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompanies this
+ * distribution. The Eclipse Public License is available at
+ * http://www.eclipse.org/legal/epl-v10.html and the Eclipse Distribution
+ * License is available at https://eclipse.org/org/documents/edl-v10.php
+ *
+ * Contributors:
+ *   Alexander J. McCaskey - initial API and implementation
+ *******************************************************************************/
+#ifndef XACC_UTILS_THREADPOOL_HPP_
+#define XACC_UTILS_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xacc {
+
+/**
+ * The ThreadPool runs the iterations of parallel loops on a fixed
+ * set of worker threads. The thread calling parallelFor works on its
+ * own loop too, so loops may be nested without starving the pool.
+ */
+class ThreadPool {
+
+public:
+  /**
+   * Start a pool running loops on nThreads threads,
+   * the calling thread included.
+   *
+   * @param nThreads The number of threads, at least 1
+   */
+  ThreadPool(const int nThreads);
+
+  /**
+   * Join the worker threads.
+   */
+  ~ThreadPool();
+
+  /**
+   * Return the number of threads loops run on.
+   */
+  const int size() const { return workers.size() + 1; }
+
+  /**
+   * Call body(i) for i in [0, n), in any order and from any thread,
+   * and return when all calls are done. The first exception thrown
+   * by the body is rethrown here.
+   *
+   * @param n The number of iterations
+   * @param body The loop body
+   */
+  void parallelFor(const int n, const std::function<void(const int)> &body);
+
+  /**
+   * Return the pool shared by the framework, with as many threads
+   * as the transformation-threads runtime option, or the hardware
+   * concurrency if not set. The option is read on every call, and
+   * the pool is replaced when it changes.
+   */
+  static std::shared_ptr<ThreadPool> shared();
+
+protected:
+  struct Job {
+    const std::function<void(const int)> *body;
+    int n;
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+  };
+
+  void work();
+
+  // Run the next iteration of the job, false if none is left
+  bool runNext(Job &job);
+
+  std::vector<std::thread> workers;
+  std::deque<std::shared_ptr<Job>> jobs;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  bool stopping = false;
+};
+
+} // namespace xacc
+#endif
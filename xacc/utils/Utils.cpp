@@ -138,9 +138,18 @@ XACCLogger::XACCLogger()
   logger->set_level(spdlog::level::info);
 }
 
+bool XACCLogger::accept(MessagePredicate &predicate) {
+  MessagePredicate global;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    global = globalPredicate;
+  }
+  return predicate() && global();
+}
+
 void XACCLogger::info(const std::string &msg, MessagePredicate predicate) {
   if (useCout) {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         std::cout << "\033[1;34m[XACC Info] " + msg + "\033[0m \n";
       } else {
@@ -148,7 +157,7 @@ void XACCLogger::info(const std::string &msg, MessagePredicate predicate) {
       }
     }
   } else {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         logger->info("\033[1;34m" + msg + "\033[0m");
       } else {
@@ -160,7 +169,7 @@ void XACCLogger::info(const std::string &msg, MessagePredicate predicate) {
 
 void XACCLogger::warning(const std::string &msg, MessagePredicate predicate) {
   if (useCout) {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         std::cout << "\033[1;33m[XACC Warning] " + msg + "\033[0m \n";
       } else {
@@ -168,7 +177,7 @@ void XACCLogger::warning(const std::string &msg, MessagePredicate predicate) {
       }
     }
   } else {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         logger->info("\033[1;33m" + msg + "\033[0m");
       } else {
@@ -180,7 +189,7 @@ void XACCLogger::warning(const std::string &msg, MessagePredicate predicate) {
 
 void XACCLogger::debug(const std::string &msg, MessagePredicate predicate) {
   if (useCout) {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         std::cout << "\033[1;32m[XACC Debug] " + msg + "\033[0m \n";
       } else {
@@ -188,7 +197,7 @@ void XACCLogger::debug(const std::string &msg, MessagePredicate predicate) {
       }
     }
   } else {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       if (useColor) {
         logger->info("\033[1;32m" + msg + "\033[0m");
       } else {
@@ -199,10 +208,10 @@ void XACCLogger::debug(const std::string &msg, MessagePredicate predicate) {
 }
 void XACCLogger::error(const std::string &msg, MessagePredicate predicate) {
   if (useCout) {
-    if (predicate() && globalPredicate())
+    if (accept(predicate))
       std::cerr << msg << "\n";
   } else {
-    if (predicate() && globalPredicate()) {
+    if (accept(predicate)) {
       logger->error("\033[1;31m[XACC Error] " + msg + "\033[0m");
     }
   }
@@ -109,26 +109,35 @@ protected:
 
   std::queue<std::string> logQueue;
 
+  // Guards the queue and the global predicate, the spdlog
+  // logger is thread safe on its own
+  std::mutex mutex;
+
+  bool accept(MessagePredicate &predicate);
+
   XACCLogger();
 
+  friend class Singleton<XACCLogger>;
+
 public:
-  // Overriding here so we can have a custom constructor
-  static XACCLogger *instance() {
-    if (!instance_) {
-      instance_ = new XACCLogger();
-    }
-    return instance_;
+  void enqueueLog(const std::string log) {
+    std::lock_guard<std::mutex> lock(mutex);
+    logQueue.push(log);
   }
 
-  void enqueueLog(const std::string log) { logQueue.push(log); }
-
   void dumpQueue() {
-    while (!logQueue.empty()) {
-      info(logQueue.front());
-      logQueue.pop();
+    std::queue<std::string> logs;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::swap(logs, logQueue);
+    }
+    while (!logs.empty()) {
+      info(logs.front());
+      logs.pop();
     }
   }
   void setGlobalLoggerPredicate(MessagePredicate pred) {
+    std::lock_guard<std::mutex> lock(mutex);
     globalPredicate = pred;
   }
   void info(const std::string &msg,